@@ -8,6 +8,12 @@
 #define ATIVOS_H
 
 #include "departamentos.h"
+#include "snapshot.h"
+#include "indice.h"
+#include "prefixo.h"
+#include "dicionario.h"
+#include "datas.h"
+#include <stdint.h>
 
 typedef enum {
     VIATURA = 1,
@@ -26,29 +32,65 @@ typedef enum {
 
 typedef struct {
     int id;
-    char *designacao;
+    const char *designacao;  /**< Designação (string de ativos->strings) */
     CategoriaAtivo categoria;
-    char *localizacao;
-    int diaAquisicao;
-    int mesAquisicao;
-    int anoAquisicao;
-    int diaAbate;
-    int mesAbate;
-    int anoAbate;
+    const char *localizacao; /**< Localização (string de ativos->strings; locais iguais partilham o apontador) */
+    Timestamp dataAquisicao; /**< Data de registo do ativo */
+    Timestamp dataAbate;     /**< Data de abate (SEM_DATA se não foi abatido) */
     EstadoAtivo estado;
     int contagemManutencoesCorretivas;
     float custoTotalAcumulado;
     float custo;
     int idDepartamentoAssociado;
+    int totalOrdens; /**< Número de ordens associadas ao ativo (calculado, não é guardado) */
+    int ultimaOrdem; /**< Posição da ordem mais recente do ativo, -1 se não tiver (calculado, não é guardado) */
 } Ativo;
 
+/**
+ * @brief Cópia em colunas (struct-of-arrays) dos campos dos ativos usados nas agregações.
+ * @details Cada campo fica num array contíguo, pelo que uma passagem que só precisa do estado lê 1 byte
+ * por ativo em vez do registo Ativo inteiro. As colunas são opcionais (capacidade == 0 indica que estão
+ * desligadas) e são mantidas pelas funções que alteram os ativos: ativarColunasAtivos(),
+ * sincronizarColunasAtivo(), definirEstadoAtivo() e somarCorretivasAtivo().
+ */
+typedef struct {
+    int *id;                  /**< ID de cada ativo */
+    uint8_t *estado;          /**< EstadoAtivo de cada ativo */
+    uint8_t *categoria;       /**< CategoriaAtivo de cada ativo */
+    int *idDepartamento;      /**< ID do departamento associado */
+    int *corretivas;          /**< Número de manutenções corretivas */
+    float *custo;             /**< Custo de aquisição */
+    float *custoAcumulado;    /**< Custo acumulado em manutenções */
+    Timestamp *dataAquisicao; /**< Data de aquisição */
+    Timestamp *dataAbate;     /**< Data de abate (SEM_DATA se não foi abatido) */
+    int capacidade;           /**< Capacidade dos arrays (0 se as colunas estiverem desligadas) */
+}ColunasAtivos;
+
 typedef struct {
     Ativo *ativo;
     int contador;
     int  ativosDisponiveis;
     int capacidade;
+    PoolStrings strings; /**< Designações e localizações (cada texto diferente é guardado uma vez) */
+    IndiceHash indice; /**< ID -> posição no array */
+    int proximoID;     /**< Próximo ID a atribuir (guardado no snapshot e no journal) */
+    IndicePrefixos designacoes; /**< Designações dos ativos não abatidos, ordenadas (pesquisa inteligente) */
+    ColunasAtivos colunas;      /**< Cópia em colunas dos campos usados nas agregações (opcional) */
 }Ativos;
 
+/**
+ * @brief Ativos agrupados por departamento (counting sort) e os totais de cada grupo.
+ * @details Os ativos do departamento na posição d são posicoes[inicio[d]] .. posicoes[inicio[d + 1] - 1],
+ * pela ordem em que estão no array de ativos. Ativos com um departamento inexistente ficam de fora.
+ */
+typedef struct {
+    int *posicoes;          /**< Posições dos ativos no array, agrupadas por departamento */
+    int *inicio;            /**< Por posição de departamento: início do grupo em posicoes (numDepartamentos + 1 entradas) */
+    float *custo;           /**< Por posição de departamento: soma do custo de aquisição */
+    float *custoAcumulado;  /**< Por posição de departamento: soma do custo acumulado em manutenções */
+    int numDepartamentos;   /**< Número de departamentos */
+}AtivosPorDepartamento;
+
 
 /**
  * @brief Cria um novo ativo no sistema e associa-o a um departamento.
@@ -78,6 +120,21 @@ void listar_ativos(Ativos ativos);
  */
 void listar_ativos_por_departamento (Departamentos departamentos, Ativos ativos);
 
+/**
+ * @brief Agrupa os ativos por departamento com duas passagens pelos ativos (counting sort). O(A + D).
+ * @param departamentos Apontador para a estrutura com a lista de departamentos.
+ * @param ativos Apontador para a estrutura com a lista de ativos.
+ * @param grupos Apontador para o resultado (libertar com libertarAtivosPorDepartamento()).
+ * @return 1 em caso de sucesso, 0 se não houver memória.
+ */
+int agruparAtivosPorDepartamento (const Departamentos *departamentos, const Ativos *ativos, AtivosPorDepartamento *grupos);
+
+/**
+ * @brief Liberta a memória de um agrupamento de ativos por departamento.
+ * @param grupos Apontador para o agrupamento.
+ */
+void libertarAtivosPorDepartamento (AtivosPorDepartamento *grupos);
+
 /**
  * @brief Abate um ativo (marca como ABATIDO) e regista a data.
  * @param ativos Apontador para a estrutura com a lista de ativos.
@@ -87,8 +144,9 @@ void abater_ativo (Ativos *ativos);
 /**
  * @brief Guarda os ativos num ficheiro binário.
  * @param ativos Apontador para a estrutura com a lista de ativos.
+ * @return 1 se o ficheiro foi gravado com sucesso, caso contrário 0.
  */
-void guardarAtivos(Ativos *ativos);
+int guardarAtivos(Ativos *ativos);
 
 /**
  * @brief Carrega os ativos a partir de um ficheiro binário.
@@ -97,16 +155,92 @@ void guardarAtivos(Ativos *ativos);
 void carregarAtivos(Ativos *ativos);
 
 /**
- * @brief Obtém o maior ID existente na lista de ativos.
+ * @brief Obtém o maior ID já atribuído na lista de ativos (lido do contador proximoID).
  * @param ativos Estrutura com a lista de ativos.
- * @return Retorna o maior ID ou 0 caso não existam ativos.
+ * @return Retorna o maior ID ou 0 caso ainda não tenha sido atribuído nenhum.
  */
 int obterMaiorIDAtivos(Ativos ativos);
 
+/**
+ * @brief Lista, por ordem alfabética, os ativos não abatidos cuja designação começa por um termo.
+ * @param ativos Estrutura com a lista de ativos.
+ * @param termo Termo a pesquisar (não distingue maiúsculas de minúsculas).
+ * @param limite Número máximo de resultados a mostrar (0 para mostrar todos).
+ * @return Número total de ativos encontrados (pode ser maior do que limite).
+ */
+int pesquisaInteligenteAtivos(Ativos ativos, const char *termo, int limite);
+
 /**
  * @brief Pede ao utilizador um termo e lista os ativos que começam por esse termo.
  * @param ativos Estrutura com a lista de ativos.
  */
 void listarComPesquisaInteligente (Ativos ativos);
 
+/**
+ * @brief Repõe um ativo registado no journal (cria-o ou substitui o existente com o mesmo ID).
+ * @param ativos Apontador para a estrutura com a lista de ativos.
+ * @param ativo Ativo lido do journal (as strings são copiadas para o pool da lista).
+ * @param ativosDisponiveis Contador de ativos disponíveis no momento do registo.
+ * @param proximoID Próximo ID a atribuir no momento do registo.
+ */
+void reporAtivo(Ativos *ativos, const Ativo *ativo, int ativosDisponiveis, int proximoID);
+
+/**
+ * @brief Inicializa as colunas de ativos desligadas (não aloca memória).
+ * @param colunas Apontador para as colunas.
+ */
+void inicializarColunasAtivos (ColunasAtivos *colunas);
+
+/**
+ * @brief Liga as colunas de ativos, copiando para elas todos os ativos existentes. O(A).
+ * @param ativos Apontador para a estrutura com a lista de ativos.
+ * @return 1 em caso de sucesso, 0 se não houver memória (as colunas ficam desligadas).
+ */
+int ativarColunasAtivos (Ativos *ativos);
+
+/**
+ * @brief Liberta a memória das colunas de ativos e deixa-as desligadas.
+ * @param ativos Apontador para a estrutura com a lista de ativos.
+ */
+void libertarColunasAtivos (Ativos *ativos);
+
+/**
+ * @brief Devolve as colunas de ativos, se estiverem ligadas.
+ * @param ativos Apontador para a estrutura com a lista de ativos.
+ * @return Apontador para as colunas ou NULL se estiverem desligadas.
+ */
+const ColunasAtivos *colunasAtivos (const Ativos *ativos);
+
+/**
+ * @brief Copia os campos de um ativo para as colunas (não faz nada se estiverem desligadas).
+ * @param ativos Apontador para a estrutura com a lista de ativos.
+ * @param idx Posição do ativo no array.
+ */
+void sincronizarColunasAtivo (Ativos *ativos, int idx);
+
+/**
+ * @brief Altera o estado de um ativo, mantendo as colunas.
+ * @param ativos Apontador para a estrutura com a lista de ativos.
+ * @param idx Posição do ativo no array.
+ * @param estado Novo estado.
+ */
+void definirEstadoAtivo (Ativos *ativos, int idx, EstadoAtivo estado);
+
+/**
+ * @brief Soma delta ao número de manutenções corretivas de um ativo, mantendo as colunas.
+ * @param ativos Apontador para a estrutura com a lista de ativos.
+ * @param idx Posição do ativo no array.
+ * @param delta Valor a somar (1 ou -1).
+ */
+void somarCorretivasAtivo (Ativos *ativos, int idx, int delta);
+
+#ifdef VERIFICAR_CONTADORES
+/**
+ * @brief Verifica (apenas com VERIFICAR_CONTADORES definido) se as colunas coincidem com o array de ativos.
+ * @param ativos Apontador para a estrutura com a lista de ativos.
+ * @return 1 se coincidirem ou estiverem desligadas, caso contrário 0 (a diferença é registada nos logs).
+ */
+int verificarColunasAtivos (const Ativos *ativos);
+#endif
+
 #endif /* ATIVOS_H */
@@ -0,0 +1,68 @@
+/**
+ * @file datas.h
+ * @brief Header com o tipo usado para guardar datas/horas (segundos desde 1970) e as conversões para apresentação.
+ * @author Francisco Alves
+ */
+
+#ifndef DATAS_H
+#define DATAS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Instante em segundos desde 1970-01-01 00:00:00 UTC (valor de time()).
+ * @note SEM_DATA (0) indica que a data ainda não foi definida.
+ */
+typedef int64_t Timestamp;
+
+#define SEM_DATA 0
+#define TAMANHO_DATA_TEXTO 32 /**< Tamanho suficiente para o texto de formatarData()/formatarDataHora() */
+
+/**
+ * @brief Devolve o instante atual.
+ * @return Segundos desde 1970 (UTC).
+ */
+Timestamp timestampAtual(void);
+
+/**
+ * @brief Converte uma data/hora local em campos separados (formato antigo dos ficheiros) num Timestamp.
+ * @param ano Ano (0 indica que a data não estava definida).
+ * @param mes Mês (1 a 12).
+ * @param dia Dia do mês.
+ * @param hora Hora.
+ * @param min Minutos.
+ * @param seg Segundos.
+ * @return Timestamp correspondente ou SEM_DATA se a data não estiver definida/for inválida.
+ * @note Usa mktime(), pelo que só deve ser chamada na migração de dados antigos.
+ */
+Timestamp timestampDeCampos(int ano, int mes, int dia, int hora, int min, int seg);
+
+/**
+ * @brief Escreve a data (d/m/aaaa, hora local) de um Timestamp.
+ * @param t Instante a formatar.
+ * @param destino Buffer de destino (TAMANHO_DATA_TEXTO chega).
+ * @param tamanho Tamanho do buffer.
+ * @return destino, para poder ser usado diretamente num printf.
+ */
+const char *formatarData(Timestamp t, char *destino, size_t tamanho);
+
+/**
+ * @brief Escreve a data e a hora (dd/mm/aaaa hh:mm:ss, hora local) de um Timestamp.
+ * @param t Instante a formatar.
+ * @param destino Buffer de destino (TAMANHO_DATA_TEXTO chega).
+ * @param tamanho Tamanho do buffer.
+ * @return destino, para poder ser usado diretamente num printf.
+ */
+const char *formatarDataHora(Timestamp t, char *destino, size_t tamanho);
+
+/**
+ * @brief Escreve uma duração em segundos como "Nd hh:mm:ss" (ou "hh:mm:ss" se for inferior a um dia).
+ * @param segundos Duração (valores negativos são apresentados como "-").
+ * @param destino Buffer de destino (TAMANHO_DATA_TEXTO chega).
+ * @param tamanho Tamanho do buffer.
+ * @return destino, para poder ser usado diretamente num printf.
+ */
+const char *formatarDuracao(int64_t segundos, char *destino, size_t tamanho);
+
+#endif /* DATAS_H */
@@ -7,6 +7,9 @@
 #ifndef  DEPARTAMENTOS_H
 #define DEPARTAMENTOS_H
 
+#include "indice.h"
+#include "dicionario.h"
+
 typedef enum {
     ATIVO = 1,
     INATIVO
@@ -14,9 +17,9 @@ typedef enum {
 
 typedef struct {
     int idDepartamento;
-    char *nomeDepartamento;
-    char *responsavel;
-    char *contacto;
+    const char *nomeDepartamento; /**< Strings de departamentos->strings (não são libertadas individualmente) */
+    const char *responsavel;
+    const char *contacto;
     Atividade atividade;
 }Departamento;
 
@@ -25,6 +28,9 @@ typedef struct {
     int contador;
     int departamentosAtivos;
     int capacidade;
+    IndiceHash indice; /**< ID -> posição no array */
+    int proximoID;     /**< Próximo ID a atribuir (guardado no snapshot e no journal) */
+    PoolStrings strings; /**< Nomes, responsáveis e contactos (cada texto diferente é guardado uma vez) */
 }Departamentos;
 
 /**
@@ -54,8 +60,9 @@ void inativar_Departamento (Departamentos *departamentos);
 /**
  * @brief Guarda os departamentos num ficheiro binário.
  * @param departamentos Apontador para a estrutura com a lista de departamentos.
+ * @return 1 se o ficheiro foi gravado com sucesso, caso contrário 0.
  */
-void guardarDepartamentos (Departamentos *departamentos);
+int guardarDepartamentos (Departamentos *departamentos);
 
 /**
  * @brief Carrega os departamentos a partir de um ficheiro binário.
@@ -64,10 +71,27 @@ void guardarDepartamentos (Departamentos *departamentos);
 void carregarDepartamentos(Departamentos *departamentos);
 
 /**
- * @brief Obtém o maior ID existente na lista de departamentos.
+ * @brief Obtém o maior ID já atribuído na lista de departamentos (lido do contador proximoID).
  * @param departamentos Estrutura com a lista de departamentos.
- * @return Retorna o maior ID ou 0 caso não existam departamentos.
+ * @return Retorna o maior ID ou 0 caso ainda não tenha sido atribuído nenhum.
  */
 int obterMaiorIDDepartamento(Departamentos departamentos);
 
+/**
+ * @brief Procura a posição de um departamento através do seu ID.
+ * @param departamentos Estrutura com a lista de departamentos.
+ * @param idPretendido ID a procurar.
+ * @return Retorna o índice no array ou -1 caso não exista.
+ */
+int procurarIdDepartamento (Departamentos departamentos, int idPretendido);
+
+/**
+ * @brief Repõe um departamento registado no journal (cria-o ou substitui o existente com o mesmo ID).
+ * @param departamentos Apontador para a estrutura com a lista de departamentos.
+ * @param departamento Departamento lido do journal (as strings são copiadas para o pool da lista).
+ * @param departamentosAtivos Contador de departamentos ativos no momento do registo.
+ * @param proximoID Próximo ID a atribuir no momento do registo.
+ */
+void reporDepartamento(Departamentos *departamentos, const Departamento *departamento, int departamentosAtivos, int proximoID);
+
 #endif /* DEPARTAMENTOS_H */
\ No newline at end of file
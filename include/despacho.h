@@ -0,0 +1,31 @@
+/**
+ * @file despacho.h
+ * @brief Header com a distribuição automática das ordens pendentes pelos técnicos.
+ * @author Francisco Alves
+ */
+
+#ifndef DESPACHO_H
+#define DESPACHO_H
+
+#include "ordem.h"
+
+/**
+ * @brief Devolve a especialidade de técnico adequada a uma categoria de ativo.
+ * @param categoria Categoria do ativo.
+ * @return Especialidade preferida (MANUTENCAO_GERAL para categorias sem especialidade própria).
+ */
+Especialidade especialidadeParaCategoria(CategoriaAtivo categoria);
+
+/**
+ * @brief Atribui automaticamente as ordens pendentes aos técnicos disponíveis e inicia a sua execução.
+ * @details As ordens são tratadas por prioridade (ALTA primeiro) e, dentro da mesma prioridade, pela mais antiga.
+ * Cada ordem vai para o técnico menos ocupado com a especialidade adequada ao ativo ou, se não houver
+ * nenhum livre, para o técnico de manutenção geral menos ocupado.
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param tecnicos Apontador para a estrutura de técnicos.
+ * @param ativos Apontador para a estrutura de ativos.
+ * @return Número de ordens atribuídas.
+ */
+int despacharOrdensPendentes(Ordens *ordens, Tecnicos *tecnicos, Ativos *ativos);
+
+#endif /* DESPACHO_H */
@@ -0,0 +1,121 @@
+/**
+ * @file dicionario.h
+ * @brief Header com o dicionário de strings (hash) que atribui um ID sequencial a cada string diferente
+ * e com o pool de strings internadas usado pelos campos de texto das entidades.
+ * @author Francisco Alves
+ */
+
+#ifndef DICIONARIO_H
+#define DICIONARIO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define POOL_TAMANHO_BLOCO 4096 /**< Tamanho mínimo de cada bloco da arena do pool */
+
+/**
+ * @brief Dicionário string -> ID. Cada string diferente recebe o ID seguinte (0, 1, 2, ...).
+ * @note As strings não são copiadas: têm de continuar válidas enquanto o dicionário for usado.
+ */
+typedef struct {
+    const char **chaves;  /**< String de cada ID */
+    uint32_t *hashes;     /**< Hash de cada ID (evita recalcular ao expandir a tabela) */
+    int contador;         /**< Número de strings diferentes */
+    int capacidadeChaves; /**< Capacidade dos arrays chaves e hashes */
+    int *tabela;          /**< Tabela de endereçamento aberto com os IDs (-1 nas posições livres) */
+    int capacidade;       /**< Número de posições da tabela (potência de 2) */
+}DicionarioStrings;
+
+/**
+ * @brief Bloco da arena onde o pool guarda as strings (nunca muda de endereço).
+ */
+typedef struct BlocoPool {
+    struct BlocoPool *anterior; /**< Bloco alocado antes deste */
+    size_t usado;               /**< Bytes ocupados em dados */
+    size_t capacidade;          /**< Bytes disponíveis em dados */
+    char dados[];               /**< Strings terminadas em '\0', seguidas */
+}BlocoPool;
+
+/**
+ * @brief Pool de strings internadas: cada string diferente é guardada uma única vez numa arena.
+ * @details Strings iguais devolvem o mesmo apontador, pelo que podem ser comparadas com == e
+ * agrupadas pelo ID (idStringPool()). As strings não podem ser alteradas nem libertadas
+ * individualmente: a arena inteira é libertada de uma vez por libertarPoolStrings().
+ */
+typedef struct {
+    DicionarioStrings dicionario; /**< String -> ID (as chaves apontam para a arena) */
+    BlocoPool *blocos;            /**< Bloco atual da arena (lista ligada pelos anteriores) */
+}PoolStrings;
+
+/**
+ * @brief Inicializa um dicionário vazio (não aloca memória).
+ * @param dicionario Apontador para o dicionário.
+ */
+void inicializarDicionario(DicionarioStrings *dicionario);
+
+/**
+ * @brief Devolve o ID de uma string, acrescentando-a ao dicionário se ainda não existir.
+ * @param dicionario Apontador para o dicionário.
+ * @param str String a procurar.
+ * @return ID da string ou -1 se não houver memória.
+ */
+int internarString(DicionarioStrings *dicionario, const char *str);
+
+/**
+ * @brief Procura o ID de uma string sem a acrescentar.
+ * @param dicionario Apontador para o dicionário.
+ * @param str String a procurar.
+ * @return ID da string ou -1 se não existir.
+ */
+int procurarDicionario(const DicionarioStrings *dicionario, const char *str);
+
+/**
+ * @brief Liberta a memória do dicionário (as strings não são libertadas).
+ * @param dicionario Apontador para o dicionário.
+ */
+void libertarDicionario(DicionarioStrings *dicionario);
+
+/**
+ * @brief Inicializa um pool vazio (não aloca memória).
+ * @param pool Apontador para o pool.
+ */
+void inicializarPoolStrings(PoolStrings *pool);
+
+/**
+ * @brief Devolve a cópia única de uma string no pool, copiando-a para a arena se ainda não existir.
+ * @param pool Apontador para o pool.
+ * @param str String a internar (pode ser NULL).
+ * @return String do pool (válida até libertarPoolStrings()) ou NULL se str for NULL ou não houver memória.
+ */
+const char *internarStringPool(PoolStrings *pool, const char *str);
+
+/**
+ * @brief Devolve o ID que o pool atribuiu a uma string (ou a uma string igual).
+ * @param pool Apontador para o pool.
+ * @param str String a procurar (ou NULL).
+ * @return ID da string (0 a numStringsPool() - 1) ou -1 se str for NULL ou não existir no pool.
+ */
+int idStringPool(const PoolStrings *pool, const char *str);
+
+/**
+ * @brief Devolve a string do pool com um dado ID.
+ * @param pool Apontador para o pool.
+ * @param id ID da string (0 a numStringsPool() - 1).
+ * @return String do pool ou NULL se o ID for inválido.
+ */
+const char *stringPool(const PoolStrings *pool, int id);
+
+/**
+ * @brief Devolve o número de strings diferentes no pool (os IDs vão de 0 a este valor - 1).
+ * @param pool Apontador para o pool.
+ * @return Número de strings.
+ */
+int numStringsPool(const PoolStrings *pool);
+
+/**
+ * @brief Liberta a arena e o dicionário do pool (todas as strings de uma vez).
+ * @param pool Apontador para o pool.
+ */
+void libertarPoolStrings(PoolStrings *pool);
+
+#endif /* DICIONARIO_H */
@@ -0,0 +1,82 @@
+/**
+ * @file fila.h
+ * @brief Header com a fila de prioridade indexada (min-heap) usada para as ordens pendentes.
+ * @author Francisco Alves
+ */
+
+#ifndef FILA_H
+#define FILA_H
+
+#include <stdint.h>
+
+/**
+ * @brief Entrada da fila: um elemento (ex: posição de uma ordem no array) e a respetiva chave.
+ */
+typedef struct {
+    int64_t chave;  /**< Chave de ordenação (sai primeiro a menor) */
+    int elemento;   /**< Elemento guardado (inteiro >= 0, sem repetições) */
+}EntradaFila;
+
+/**
+ * @brief Fila de prioridade indexada: min-heap com a posição de cada elemento, o que permite
+ * remover um elemento qualquer em O(log n).
+ */
+typedef struct {
+    EntradaFila *heap;       /**< Entradas organizadas em heap */
+    int tamanho;             /**< Número de entradas */
+    int capacidade;          /**< Capacidade do array heap */
+    int *posicoes;           /**< Por elemento: posição no heap (-1 se não estiver na fila) */
+    int capacidadePosicoes;  /**< Capacidade do array posicoes */
+}FilaPrioridade;
+
+/**
+ * @brief Inicializa uma fila vazia (não aloca memória).
+ * @param fila Apontador para a fila.
+ */
+void inicializarFila(FilaPrioridade *fila);
+
+/**
+ * @brief Insere um elemento na fila. O(log n).
+ * @param fila Apontador para a fila.
+ * @param elemento Elemento a inserir (não pode já estar na fila).
+ * @param chave Chave do elemento.
+ * @return 1 em caso de sucesso, 0 se não houver memória ou o elemento já estiver na fila.
+ */
+int inserirFila(FilaPrioridade *fila, int elemento, int64_t chave);
+
+/**
+ * @brief Remove um elemento qualquer da fila. O(log n).
+ * @param fila Apontador para a fila.
+ * @param elemento Elemento a remover.
+ * @return 1 se o elemento foi removido, 0 se não estava na fila.
+ */
+int removerFila(FilaPrioridade *fila, int elemento);
+
+/**
+ * @brief Devolve o elemento com menor chave sem o retirar. O(1).
+ * @param fila Apontador para a fila.
+ * @return Elemento ou -1 se a fila estiver vazia.
+ */
+int topoFila(const FilaPrioridade *fila);
+
+/**
+ * @brief Copia os elementos da fila para um array, por ordem crescente de chave (a fila não é alterada).
+ * @param fila Apontador para a fila.
+ * @param destino Array com espaço para fila->tamanho elementos.
+ * @return Número de elementos copiados, ou -1 se não houver memória.
+ */
+int ordenarFila(const FilaPrioridade *fila, int *destino);
+
+/**
+ * @brief Esvazia a fila, mantendo a memória alocada.
+ * @param fila Apontador para a fila.
+ */
+void limparFila(FilaPrioridade *fila);
+
+/**
+ * @brief Liberta a memória da fila.
+ * @param fila Apontador para a fila.
+ */
+void libertarFila(FilaPrioridade *fila);
+
+#endif /* FILA_H */
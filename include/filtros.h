@@ -0,0 +1,122 @@
+/**
+ * @file filtros.h
+ * @brief Header com os mapas de seleção (bitmaps) e os filtros de igualdade sobre colunas compactas.
+ * @author Francisco Alves
+ */
+
+#ifndef FILTROS_H
+#define FILTROS_H
+
+#include <stdint.h>
+
+#define SELECAO_BITS_PALAVRA 64 /**< Elementos por palavra do mapa de seleção */
+
+/**
+ * @brief Mapa de seleção: o bit i indica se o elemento i (ex: a ordem na posição i) foi selecionado.
+ * @details Os bits para lá de tamanho estão sempre a 0, pelo que contar e percorrer não precisam de os tratar.
+ */
+typedef struct {
+    uint64_t *palavras;     /**< Bits, SELECAO_BITS_PALAVRA por palavra */
+    int numPalavras;        /**< Número de palavras */
+    int tamanho;            /**< Número de elementos */
+    int capacidadePalavras; /**< Capacidade do array palavras */
+}Selecao;
+
+/**
+ * @brief Inicializa um mapa vazio, sem elementos (não aloca memória).
+ * @param selecao Apontador para o mapa.
+ */
+void inicializarSelecao(Selecao *selecao);
+
+/**
+ * @brief Cria um mapa de seleção com todos os elementos selecionados.
+ * @param selecao Apontador para o mapa.
+ * @param tamanho Número de elementos.
+ * @return 1 em caso de sucesso, 0 se não houver memória.
+ */
+int criarSelecao(Selecao *selecao, int tamanho);
+
+/**
+ * @brief Liberta a memória de um mapa de seleção.
+ * @param selecao Apontador para o mapa.
+ */
+void libertarSelecao(Selecao *selecao);
+
+/**
+ * @brief Retira todos os elementos do mapa, mantendo a memória.
+ * @param selecao Apontador para o mapa.
+ */
+void limparSelecao(Selecao *selecao);
+
+/**
+ * @brief Seleciona ou retira um elemento, aumentando o mapa se a posição estiver para lá do fim. O(1) amortizado.
+ * @param selecao Apontador para o mapa.
+ * @param posicao Posição do elemento (>= 0).
+ * @param selecionado 1 para selecionar, 0 para retirar.
+ * @return 1 em caso de sucesso, 0 se não houver memória.
+ */
+int alterarSelecionado(Selecao *selecao, int posicao, int selecionado);
+
+/**
+ * @brief Indica se um elemento está selecionado.
+ * @param selecao Apontador para o mapa.
+ * @param posicao Posição do elemento.
+ * @return 1 se estiver selecionado, caso contrário 0.
+ */
+int estaSelecionado(const Selecao *selecao, int posicao);
+
+/**
+ * @brief Substitui o conteúdo do mapa por tamanho elementos copiados de um array de palavras (ex: lido de um ficheiro).
+ * @param selecao Apontador para o mapa.
+ * @param palavras Palavras a copiar (pelo menos ceil(tamanho / SELECAO_BITS_PALAVRA)).
+ * @param tamanho Número de elementos.
+ * @return 1 em caso de sucesso, 0 se não houver memória (o mapa fica inalterado).
+ */
+int copiarPalavrasSelecao(Selecao *selecao, const uint64_t *palavras, int tamanho);
+
+/**
+ * @brief Mantém selecionados apenas os elementos em que coluna[i] == valor (1 byte por elemento).
+ * @param selecao Apontador para o mapa (o tamanho indica quantos elementos da coluna são lidos).
+ * @param coluna Coluna com um byte por elemento.
+ * @param valor Valor pretendido.
+ */
+void filtrarIgualU8(Selecao *selecao, const uint8_t *coluna, uint8_t valor);
+
+/**
+ * @brief Mantém selecionados apenas os elementos em que coluna[i] == valor (4 bytes por elemento).
+ * @param selecao Apontador para o mapa (o tamanho indica quantos elementos da coluna são lidos).
+ * @param coluna Coluna com um inteiro por elemento.
+ * @param valor Valor pretendido.
+ */
+void filtrarIgualI32(Selecao *selecao, const int32_t *coluna, int32_t valor);
+
+/**
+ * @brief Interseção de dois mapas com o mesmo tamanho (destino = destino E outra).
+ * @param destino Apontador para o mapa alterado.
+ * @param outra Apontador para o outro mapa.
+ */
+void intersetarSelecao(Selecao *destino, const Selecao *outra);
+
+/**
+ * @brief União de dois mapas com o mesmo tamanho (destino = destino OU outra).
+ * @param destino Apontador para o mapa alterado.
+ * @param outra Apontador para o outro mapa.
+ */
+void unirSelecao(Selecao *destino, const Selecao *outra);
+
+/**
+ * @brief Conta os elementos selecionados (popcount de cada palavra).
+ * @param selecao Apontador para o mapa.
+ * @return Número de elementos selecionados.
+ */
+int contarSelecao(const Selecao *selecao);
+
+/**
+ * @brief Devolve o primeiro elemento selecionado a partir de uma posição (salta as palavras a 0).
+ * @param selecao Apontador para o mapa.
+ * @param desde Primeira posição a considerar.
+ * @return Posição do elemento ou -1 se não houver mais elementos selecionados.
+ */
+int proximoSelecionado(const Selecao *selecao, int desde);
+
+#endif /* FILTROS_H */
@@ -0,0 +1,61 @@
+/**
+ * @file indice.h
+ * @brief Header com o índice hash (endereçamento aberto) que associa um ID à posição no array.
+ * @author Francisco Alves
+ */
+
+#ifndef INDICE_H
+#define INDICE_H
+
+#define PRIMEIRO_ID 10 /**< ID atribuído ao primeiro registo de cada entidade */
+
+/**
+ * @brief Índice ID -> posição no array da entidade.
+ * @note São guardadas posições (e não apontadores), pelo que o índice continua válido
+ * depois de um realloc do array.
+ */
+typedef struct {
+    int *chaves;     /**< IDs guardados (INDICE_VAZIO nas posições livres) */
+    int *posicoes;   /**< Posição no array correspondente a cada ID */
+    int capacidade;  /**< Número de entradas da tabela (potência de 2) */
+    int ocupados;    /**< Número de IDs guardados */
+}IndiceHash;
+
+/**
+ * @brief Inicializa um índice vazio (não aloca memória).
+ * @param indice Apontador para o índice.
+ */
+void inicializarIndice(IndiceHash *indice);
+
+/**
+ * @brief Associa um ID a uma posição (substitui a posição se o ID já existir).
+ * @param indice Apontador para o índice.
+ * @param id ID a guardar.
+ * @param posicao Posição do registo no array.
+ * @return 1 em caso de sucesso, 0 se não houver memória para expandir o índice.
+ */
+int inserirIndice(IndiceHash *indice, int id, int posicao);
+
+/**
+ * @brief Procura a posição associada a um ID.
+ * @param indice Apontador para o índice.
+ * @param id ID a procurar.
+ * @return Posição no array ou -1 se o ID não existir.
+ */
+int procurarIndice(const IndiceHash *indice, int id);
+
+/**
+ * @brief Remove todas as entradas, mantendo a memória alocada.
+ * @param indice Apontador para o índice.
+ * @param minimo Número de entradas que se espera inserir (para reservar espaço de uma vez).
+ * @return 1 em caso de sucesso, 0 se não houver memória.
+ */
+int limparIndice(IndiceHash *indice, int minimo);
+
+/**
+ * @brief Liberta a memória do índice.
+ * @param indice Apontador para o índice.
+ */
+void libertarIndice(IndiceHash *indice);
+
+#endif /* INDICE_H */
@@ -8,6 +8,7 @@
 #define INPUT_H
 
 #include <stdio.h>
+#include "dicionario.h"
 
 /**
  * @brief Limpa o buffer de entrada.
@@ -37,6 +38,22 @@ void lerString(char *string, unsigned int tamanho, char *msg);
  */
 char* lerStringDinamica(const char *msg);
 
+/**
+ * @brief Lê uma string e guarda-a num pool de strings.
+ * @param pool Pool onde a string é internada.
+ * @param msg Mensagem a apresentar.
+ * @return String do pool (não deve ser libertada) ou NULL se a alocação falhar.
+ */
+const char* lerStringPool(PoolStrings *pool, const char *msg);
+
+/**
+ * @brief Guarda num pool uma string alocada (ex: devolvida por lerStringDinamica) e liberta-a.
+ * @param pool Pool onde a string é internada.
+ * @param str String alocada com malloc (pode ser NULL).
+ * @return String do pool ou NULL se str for NULL ou a alocação falhar.
+ */
+const char* internarStringLida(PoolStrings *pool, char *str);
+
 /**
  * @brief Lê e valida um nome (sem números, primeira letra maiúscula, etc.).
  * @param string Buffer onde o nome será guardado.
@@ -71,13 +88,14 @@ float obterFloatPositivo(char *msg);
  * @param str String a escrever.
  * @param fp Ficheiro já aberto.
  */
-void escreverStringBinario(char *str, FILE *fp);
+void escreverStringBinario(const char *str, FILE *fp);
 
 /**
- * @brief Lê uma string de um ficheiro binário (tamanho + conteúdo).
+ * @brief Lê uma string de um ficheiro binário (tamanho + conteúdo) e guarda-a num pool de strings.
  * @param fp Ficheiro já aberto.
- * @return String alocada dinamicamente.
+ * @param pool Pool onde a string é internada.
+ * @return String do pool ou NULL se for vazia ou a alocação falhar.
  */
-char* lerStringBinario(FILE *fp);
+const char* lerStringBinario(FILE *fp, PoolStrings *pool);
 
 #endif /* INPUT_H */
\ No newline at end of file
@@ -0,0 +1,102 @@
+/**
+ * @file journal.h
+ * @brief Header com as funções do journal (registo append-only das alterações feitas durante a sessão).
+ * @author Francisco Alves
+ */
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "ordem.h"
+
+#define JOURNAL_LIMITE_REGISTOS 500
+
+/**
+ * @brief Tipos de registo guardados no journal (cada um contém a imagem completa da entidade alterada).
+ */
+typedef enum {
+    JOURNAL_DEPARTAMENTO = 1, /**< Departamento criado/alterado */
+    JOURNAL_ATIVO_CAMPOS,     /**< Ativo com datas em dia/mês/ano (formato anterior, só leitura) */
+    JOURNAL_TECNICO,          /**< Técnico criado/alterado */
+    JOURNAL_ORDEM_CAMPOS,     /**< Ordem com datas em campos separados (formato anterior, só leitura) */
+    JOURNAL_MATERIAL,         /**< Material adicionado */
+    JOURNAL_ATIVO,            /**< Ativo criado/alterado */
+    JOURNAL_ORDEM             /**< Ordem criada/alterada */
+}TipoRegistoJournal;
+
+/**
+ * @brief Abre o ficheiro do journal para acrescentar registos.
+ * @return 1 se o journal ficou aberto, caso contrário 0.
+ */
+int abrirJournal(void);
+
+/**
+ * @brief Fecha o ficheiro do journal.
+ */
+void fecharJournal(void);
+
+/**
+ * @brief Regista no journal o estado atual de um departamento.
+ * @param departamentos Apontador para a estrutura com a lista de departamentos.
+ * @param idx Índice do departamento alterado.
+ */
+void journalDepartamento(const Departamentos *departamentos, int idx);
+
+/**
+ * @brief Regista no journal o estado atual de um ativo.
+ * @param ativos Apontador para a estrutura com a lista de ativos.
+ * @param idx Índice do ativo alterado.
+ */
+void journalAtivo(const Ativos *ativos, int idx);
+
+/**
+ * @brief Regista no journal o estado atual de um técnico.
+ * @param tecnicos Apontador para a estrutura com a lista de técnicos.
+ * @param idx Índice do técnico alterado.
+ */
+void journalTecnico(const Tecnicos *tecnicos, int idx);
+
+/**
+ * @brief Regista no journal o estado atual de uma ordem.
+ * @param ordens Apontador para a estrutura com a lista de ordens.
+ * @param idx Índice da ordem alterada.
+ */
+void journalOrdem(const Ordens *ordens, int idx);
+
+/**
+ * @brief Regista no journal um material adicionado.
+ * @param materiais Apontador para a estrutura com a lista de materiais.
+ * @param idx Índice do material adicionado.
+ */
+void journalMaterial(const Materiais *materiais, int idx);
+
+/**
+ * @brief Repõe sobre os dados carregados as alterações registadas no journal.
+ * @param departamentos Apontador para a estrutura de departamentos.
+ * @param ativos Apontador para a estrutura de ativos.
+ * @param tecnicos Apontador para a estrutura de técnicos.
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param materiais Apontador para a estrutura de materiais.
+ * @return Número de registos repostos.
+ * @note Deve ser chamada antes de abrirJournal(); um registo incompleto no fim do ficheiro é removido.
+ */
+int recuperarJournal(Departamentos *departamentos, Ativos *ativos, Tecnicos *tecnicos, Ordens *ordens, Materiais *materiais);
+
+/**
+ * @brief Indica se o journal já tem registos suficientes para justificar um checkpoint.
+ * @return 1 se deve ser feito um checkpoint, caso contrário 0.
+ */
+int journalPrecisaCheckpoint(void);
+
+/**
+ * @brief Grava todos os ficheiros binários e esvazia o journal.
+ * @param departamentos Apontador para a estrutura de departamentos.
+ * @param ativos Apontador para a estrutura de ativos.
+ * @param tecnicos Apontador para a estrutura de técnicos.
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param materiais Apontador para a estrutura de materiais.
+ * @return 1 se todos os ficheiros foram gravados e o journal esvaziado, caso contrário 0.
+ */
+int checkpointJournal(Departamentos *departamentos, Ativos *ativos, Tecnicos *tecnicos, Ordens *ordens, Materiais *materiais);
+
+#endif /* JOURNAL_H */
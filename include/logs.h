@@ -8,9 +8,48 @@
 #define LOGS_H
 
 /**
- * @brief Regista uma mensagem no ficheiro de logs do sistema.
+ * @brief Níveis de severidade dos registos (correspondem aos prefixos "Info:", "Aviso:" e "Erro:").
+ */
+typedef enum {
+    LOG_INFO,   /**< Informação sobre operações realizadas */
+    LOG_AVISO,  /**< Situações inválidas mas recuperáveis */
+    LOG_ERRO    /**< Falhas (memória, ficheiros, ...) */
+}NivelLog;
+
+/**
+ * @brief Inicia o registo assíncrono (buffer circular em memória e thread de escrita).
+ * @note Enquanto não for chamada, ou em plataformas sem threads POSIX, os registos são escritos
+ * diretamente no ficheiro. Instala também os handlers que descarregam o buffer em caso de crash.
+ */
+void iniciarLogs(void);
+
+/**
+ * @brief Escreve todos os registos pendentes e termina a thread de escrita.
+ */
+void terminarLogs(void);
+
+/**
+ * @brief Bloqueia até todos os registos feitos até ao momento estarem escritos no ficheiro.
+ */
+void descarregarLogs(void);
+
+/**
+ * @brief Define a severidade mínima dos registos que são guardados.
+ * @param nivel Nível mínimo (os registos abaixo deste nível são ignorados).
+ */
+void definirNivelMinimoLog(NivelLog nivel);
+
+/**
+ * @brief Regista uma mensagem com um nível de severidade explícito.
+ * @param nivel Severidade da mensagem.
  * @param mensagem Mensagem a registar.
  */
+void registar_log_nivel(NivelLog nivel, const char *mensagem);
+
+/**
+ * @brief Regista uma mensagem no ficheiro de logs do sistema.
+ * @param mensagem Mensagem a registar (o nível é deduzido do prefixo "Erro:", "Aviso:" ou "Info:").
+ */
 void registar_log(const char *mensagem);
 
 /**
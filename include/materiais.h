@@ -7,17 +7,25 @@
 #ifndef MATERIAIS_H
 #define MATERIAIS_H
 
+#include "snapshot.h"
+#include "indice.h"
+#include "dicionario.h"
+
 typedef struct {
-    char *nomeMaterial;
+    const char *nomeMaterial; /**< Nome (string de materiais->strings; nomes iguais partilham o apontador) */
     int quantidade;
     float custoUnitário;
     int OrdemAssociada;
+    int anteriorDaOrdem;  /**< Posição do material anterior da mesma ordem (-1 se for o primeiro) */
+    float custoAcumulado; /**< Custo deste material somado ao dos anteriores da mesma ordem */
 }Material;
 
 typedef struct {
     Material *material;
     int contador;
     int capacidade;
+    PoolStrings strings; /**< Nomes dos materiais (cada nome diferente é guardado uma vez) */
+    IndiceHash porOrdem; /**< ID da ordem -> posição do último material adicionado a essa ordem */
 }Materiais;
 
 /**
@@ -27,11 +35,20 @@ typedef struct {
  */
 void adicionar_materiais (Materiais *materiais, int idx);
 
+/**
+ * @brief Obtém o custo total dos materiais associados a uma ordem.
+ * @param materiais Apontador para a estrutura com a lista de materiais.
+ * @param idOrdem ID da ordem.
+ * @return Soma de custo unitário x quantidade dos materiais da ordem (0 se não tiver materiais).
+ */
+float custoMateriaisOrdem (const Materiais *materiais, int idOrdem);
+
 /**
  * @brief Guarda os materiais num ficheiro binário.
  * @param materiais Apontador para a estrutura com a lista de materiais.
+ * @return 1 se o ficheiro foi gravado com sucesso, caso contrário 0.
  */
-void guardarMateriais (Materiais *materiais);
+int guardarMateriais (Materiais *materiais);
 
 /**
  * @brief Carrega os materiais a partir de um ficheiro binário.
@@ -39,4 +56,12 @@ void guardarMateriais (Materiais *materiais);
  */
 void carregarMateriais (Materiais *materiais);
 
+/**
+ * @brief Repõe um material registado no journal (ignorado se a posição já estiver ocupada).
+ * @param materiais Apontador para a estrutura com a lista de materiais.
+ * @param idx Posição do material no momento do registo.
+ * @param material Material lido do journal (o nome é copiado para o pool da lista).
+ */
+void reporMaterial (Materiais *materiais, int idx, const Material *material);
+
 #endif /* MATERIAIS_H */
@@ -11,6 +11,12 @@
 #include "departamentos.h"
 #include "tecnicos.h"
 #include "materiais.h"
+#include "snapshot.h"
+#include "indice.h"
+#include "fila.h"
+#include "datas.h"
+#include "quantis.h"
+#include "filtros.h"
 
 typedef enum {
     PENDENTE,
@@ -30,44 +36,136 @@ typedef enum {
     CORRETIVA
 }TipoManutencao;
 
+/**
+ * @brief Ordem de manutenção, com o mesmo formato em memória e em ordens.bin (o array é gravado e mapeado tal como está).
+ * @details Os três enums ocupam 2 bits cada num único campo de bits e as datas ficam à frente, alinhadas a 8 bytes,
+ * pelo que o registo não tem padding implícito.
+ */
 typedef struct {
+    /* datas/horas para calcular tempo de resolução */
+    Timestamp inicio; /**< Início da execução (SEM_DATA enquanto estiver pendente) */
+    Timestamp fim;    /**< Conclusão/cancelamento (SEM_DATA enquanto não terminar) */
+
     int idOrdem;
     int idAtivo;
     int idDepartamento;
     int idTecnico;
-    EstadoOrdem estado;
-    Prioridade prioridade;
-    TipoManutencao tipo_manutencao;
-
-    /* datas/horas para calcular tempo de resolução */
-    int diaInicio;
-    int mesInicio;
-    int anoInicio;
-    int horaInicio;
-    int minInicio;
-    int segInicio;
-
-    int diaFim;
-    int mesFim;
-    int anoFim;
-    int horaFim;
-    int minFim;
-    int segFim;
+    unsigned int estado : 2;          /**< EstadoOrdem */
+    unsigned int prioridade : 2;      /**< Prioridade */
+    unsigned int tipo_manutencao : 2; /**< TipoManutencao */
+    unsigned int reservado : 26;      /**< Sem uso (a 0) */
+    int reservado2;                   /**< Sem uso (a 0) */
 }Ordem;
 
+_Static_assert(sizeof(Ordem) == 40, "Ordem é gravada tal como está em memória: mudar o registo obriga a aumentar SNAPSHOT_VERSAO");
+
+/**
+ * @brief Histogramas dos tempos de resolução (fim - início) das ordens concluídas, mantidos por contabilizarOrdem().
+ */
+typedef struct {
+    HistogramaTempos geral;                    /**< Todas as ordens concluídas */
+    HistogramaTempos porPrioridade[ALTA + 1];  /**< Por Prioridade */
+    HistogramaTempos porTipo[CORRETIVA + 1];   /**< Por TipoManutencao */
+    HistogramasPorID porDepartamento;          /**< Por ID de departamento */
+    HistogramasPorID porTecnico;               /**< Por ID de técnico */
+}TemposResolucao;
+
+#define URGENCIA_MEIA_VIDA (30 * 24 * 3600) /**< Segundos para o peso de uma ordem fechada passar a metade (com decaimento) */
+
+/**
+ * @brief Urgência de um departamento: peso das prioridades (BAIXA=1, MEDIA=3, ALTA=5) das suas ordens.
+ */
+typedef struct {
+    int idDepartamento;        /**< ID do departamento */
+    int abertas;               /**< Ordens PENDENTE ou EXECUCAO */
+    int fechadas;              /**< Ordens CONCLUIDA ou CANCELADA */
+    int urgenciaAbertas;       /**< Soma dos pesos das ordens abertas */
+    int urgenciaFechadas;      /**< Soma dos pesos das ordens fechadas */
+    double fechadasPonderadas; /**< Soma de peso * 2^periodo(fim) das ordens fechadas (ver urgenciaDepartamento()) */
+}UrgenciaDepartamento;
+
+/**
+ * @brief Urgência de cada departamento, indexada pelo ID e mantida por contabilizarOrdem().
+ */
+typedef struct {
+    UrgenciaDepartamento *departamentos; /**< Urgência de cada departamento com ordens */
+    int contador;                        /**< Número de departamentos no array */
+    int capacidade;                      /**< Capacidade do array */
+    IndiceHash indice;                   /**< ID do departamento -> posição no array */
+    Timestamp referencia;                /**< Início do período 0 do decaimento (fixado em reconstruirContadores()) */
+}AgregadoUrgencia;
+
+/**
+ * @brief Cópia em colunas dos campos das ordens usados nos filtros (um byte por enum).
+ * @details Mantida por contabilizarOrdem(), que é chamada sempre que uma ordem é criada ou muda de estado.
+ */
+typedef struct {
+    uint8_t *estado;          /**< EstadoOrdem de cada ordem */
+    uint8_t *prioridade;      /**< Prioridade de cada ordem */
+    uint8_t *tipo;            /**< TipoManutencao de cada ordem */
+    int32_t *idDepartamento;  /**< ID do departamento de cada ordem */
+    int capacidade;           /**< Capacidade dos arrays */
+    int desligadas;           /**< 1 se faltou memória (os filtros passam a percorrer o array de ordens) */
+}ColunasOrdens;
+
+/**
+ * @brief Índices secundários das ordens: um mapa de bits (bit = posição da ordem) por valor de cada enum.
+ * @details Mantidos por contabilizarOrdem() e gravados em ordens.bin (secção 1), ao lado dos registos.
+ * As contagens de cada valor são os contadores porEstado/porPrioridade/porTipo de Ordens (O(1)).
+ */
+typedef struct {
+    Selecao porEstado[CANCELADA + 1];     /**< Ordens em cada EstadoOrdem */
+    Selecao porPrioridade[ALTA + 1];      /**< Ordens em cada Prioridade (a posição 0 não é usada) */
+    Selecao porTipo[CORRETIVA + 1];       /**< Ordens em cada TipoManutencao (a posição 0 não é usada) */
+    int carregados;                       /**< 1 se vieram de ordens.bin e ainda correspondem às ordens */
+    int desligados;                       /**< 1 se faltou memória (as listagens passam a usar selecionarOrdens()) */
+}BitmapsOrdens;
+
+#define FILTRO_QUALQUER (-1) /**< Valor de um critério de FiltroOrdens que aceita qualquer valor */
+
+/**
+ * @brief Critérios de seleção de ordens (todos têm de se verificar); FILTRO_QUALQUER ignora o critério.
+ */
+typedef struct {
+    int estado;          /**< EstadoOrdem pretendido */
+    int prioridade;      /**< Prioridade pretendida */
+    int tipo;            /**< TipoManutencao pretendido */
+    int idDepartamento;  /**< ID do departamento pretendido */
+}FiltroOrdens;
+
 typedef struct {
     Ordem *ordem;
     int contador;
     int ordensAtivas;
     int capacidade;
+    MapaSnapshot mapa; /**< ordens.bin mapeado enquanto o array ordem apontar para ele */
+    IndiceHash indice; /**< ID -> posição no array */
+    int proximoID;     /**< Próximo ID a atribuir (guardado no snapshot e no journal) */
+    int porEstado[CANCELADA + 1];  /**< Número de ordens em cada EstadoOrdem */
+    int porPrioridade[ALTA + 1];   /**< Número de ordens em cada Prioridade */
+    int porTipo[CORRETIVA + 1];    /**< Número de ordens em cada TipoManutencao */
+    int *anteriorDoAtivo;          /**< Por posição: ordem anterior do mesmo ativo (-1 se for a primeira) */
+    int capacidadeHistorico;       /**< Capacidade do array anteriorDoAtivo */
+    FilaPrioridade pendentes;      /**< Posições das ordens PENDENTE, por prioridade e antiguidade */
+    TemposResolucao *resolucao;    /**< Histogramas dos tempos de resolução (NULL se não houver memória) */
+    AgregadoUrgencia urgencia;     /**< Urgência de cada departamento */
+    ColunasOrdens colunas;         /**< Colunas usadas pelos filtros */
+    BitmapsOrdens bitmaps;         /**< Mapas de bits por estado, prioridade e tipo */
 }Ordens;
 
 /**
- * @brief Lista as ordens/manutenções pendentes.
+ * @brief Lista as ordens/manutenções pendentes, pela ordem em que devem ser tratadas.
  * @param ordens Estrutura com a lista de ordens.
  */
 void listar_ordens_pendentes (Ordens ordens);
 
+/**
+ * @brief Devolve a próxima ordem pendente a tratar (maior prioridade e, em empate, a mais antiga). O(1).
+ * @param ordens Apontador para a estrutura de ordens.
+ * @return Posição da ordem no array ou -1 se não houver ordens pendentes.
+ */
+int proximaOrdemPendente (const Ordens *ordens);
+
 /**
  * @brief Lista todas as ordens/manutenções registadas.
  * @param ordens Estrutura com a lista de ordens.
@@ -91,11 +189,22 @@ void criar_ordem (Ativos *ativos, Ordens *ordens, Departamentos departamentos);
  */
 void gerir_ordem (Ordens *ordens, Tecnicos *tecnicos, Ativos *ativos, Materiais *materiais);
 
+/**
+ * @brief Passa uma ordem PENDENTE para EXECUCAO com o técnico indicado (contadores, data de início e journal).
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param tecnicos Apontador para a estrutura de técnicos.
+ * @param ativos Apontador para a estrutura de ativos.
+ * @param idxOrdem Posição da ordem no array.
+ * @param idTecnico ID do técnico atribuído.
+ */
+void iniciarExecucaoOrdem (Ordens *ordens, Tecnicos *tecnicos, Ativos *ativos, int idxOrdem, int idTecnico);
+
 /**
  * @brief Guarda as ordens num ficheiro binário.
  * @param ordens Apontador para a estrutura de ordens.
+ * @return 1 se o ficheiro foi gravado com sucesso, caso contrário 0.
  */
-void guardarOrdens (Ordens *ordens);
+int guardarOrdens (Ordens *ordens);
 
 /**
  * @brief Carrega as ordens a partir de um ficheiro binário.
@@ -104,27 +213,32 @@ void guardarOrdens (Ordens *ordens);
 void carregarOrdens (Ordens *ordens);
 
 /**
- * @brief Obtém o maior ID existente na lista de ordens.
+ * @brief Obtém o maior ID já atribuído na lista de ordens (lido do contador proximoID).
  * @param ordens Estrutura com a lista de ordens.
- * @return Retorna o maior ID ou 0 caso não existam ordens.
+ * @return Retorna o maior ID ou 0 caso ainda não tenha sido atribuído nenhum.
  */
 int obterMaiorIDOrdens(Ordens ordens);
 
 /**
- * @brief Conta quantas manutenções (EXECUCAO) estão associadas a um técnico.
- * @param tecnico Estrutura do técnico.
- * @param ordens Estrutura com a lista de ordens.
+ * @brief Devolve quantas manutenções (EXECUCAO) estão associadas a um técnico.
+ * @param tecnico Apontador para o técnico.
  * @return Número de manutenções ativas associadas ao técnico.
  */
-int numeroManutencoesTecnico (Tecnico tecnico, Ordens ordens);
+int numeroManutencoesTecnico (const Tecnico *tecnico);
 
 /**
  * @brief Calcula a taxa de ocupação de um técnico.
  * @param tecnico Apontador para um técnico.
- * @param ordens Apontador para a lista de ordens.
  * @return Retorna a taxa de ocupação em percentagem.
  */
-int mostrarTaxaOcupacaoTecnico (Tecnico *tecnico, Ordens *ordens);
+float mostrarTaxaOcupacaoTecnico (const Tecnico *tecnico);
+
+/**
+ * @brief Calcula a taxa de ocupação a partir do número de ordens em execução de um técnico.
+ * @param ordensAtivas Número de ordens em execução.
+ * @return Taxa de ocupação (ordens ativas / LIMITE_ORDENS_TECNICO * 100).
+ */
+float calcularTaxaOcupacao (int ordensAtivas);
 
 /**
  * @brief Converte o estado de uma ordem (enum) para texto.
@@ -133,6 +247,46 @@ int mostrarTaxaOcupacaoTecnico (Tecnico *tecnico, Ordens *ordens);
  */
 const char *passar_int_string_estado_tecnicos (EstadoOrdem est);
 
+/**
+ * @brief Inicializa as colunas das ordens vazias (não aloca memória).
+ * @param colunas Apontador para as colunas.
+ */
+void inicializarColunasOrdens (ColunasOrdens *colunas);
+
+/**
+ * @brief Liberta a memória das colunas das ordens.
+ * @param colunas Apontador para as colunas.
+ */
+void libertarColunasOrdens (ColunasOrdens *colunas);
+
+/**
+ * @brief Inicializa os mapas de bits das ordens vazios (não aloca memória).
+ * @param bitmaps Apontador para os mapas.
+ */
+void inicializarBitmapsOrdens (BitmapsOrdens *bitmaps);
+
+/**
+ * @brief Liberta a memória dos mapas de bits das ordens.
+ * @param bitmaps Apontador para os mapas.
+ */
+void libertarBitmapsOrdens (BitmapsOrdens *bitmaps);
+
+/**
+ * @brief Seleciona as ordens que verificam todos os critérios, comparando as colunas com SIMD.
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param filtro Critérios (FILTRO_QUALQUER para ignorar um critério).
+ * @param selecao Mapa de seleção a criar (libertar com libertarSelecao()).
+ * @return Número de ordens selecionadas ou -1 se não houver memória.
+ */
+int selecionarOrdens (const Ordens *ordens, const FiltroOrdens *filtro, Selecao *selecao);
+
+/**
+ * @brief Pede ao utilizador os critérios (estado, prioridade, tipo e departamento) e lista as ordens que os verificam.
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param materiais Apontador para a estrutura de materiais (custos de cada ordem).
+ */
+void pesquisarOrdens (Ordens *ordens, Materiais *materiais);
+
 /**
  * @brief Lista as ordens filtrando por estado.
  * @param ordens Apontador para a estrutura de ordens.
@@ -157,4 +311,96 @@ void listarOrdensPrioridade (Ordens *ordens, Prioridade prioridade, Materiais ma
  */
 void listarOrdensTipo (Ordens *ordens, TipoManutencao tipo, Materiais materiais);
 
+/**
+ * @brief Repõe uma ordem registada no journal (cria-a ou substitui a existente com o mesmo ID).
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param ordem Ordem lida do journal.
+ * @param ordensAtivas Contador de ordens ativas no momento do registo.
+ * @param proximoID Próximo ID a atribuir no momento do registo.
+ */
+void reporOrdem (Ordens *ordens, const Ordem *ordem, int ordensAtivas, int proximoID);
+
+/**
+ * @brief Mostra o histórico de manutenções de um ativo (da mais recente para a mais antiga).
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param ativos Apontador para a estrutura de ativos.
+ * @param materiais Apontador para a estrutura de materiais.
+ */
+void listarHistoricoAtivo (Ordens *ordens, Ativos *ativos, Materiais *materiais);
+
+/**
+ * @brief Recalcula todos os contadores derivados das ordens (por estado, prioridade e tipo, por técnico e por ativo)
+ * e a lista de ordens de cada ativo.
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param ativos Apontador para a estrutura de ativos.
+ * @param tecnicos Apontador para a estrutura de técnicos.
+ * @note Deve ser chamada depois de carregar os ficheiros e repor o journal; a partir daí os contadores
+ * são mantidos pelas funções que alteram as ordens.
+ */
+void reconstruirContadores (Ordens *ordens, Ativos *ativos, Tecnicos *tecnicos);
+
+/**
+ * @brief Aloca os histogramas de tempos de resolução (vazios).
+ * @return Apontador para os histogramas ou NULL se não houver memória.
+ */
+TemposResolucao *criarTemposResolucao (void);
+
+/**
+ * @brief Liberta os histogramas de tempos de resolução.
+ * @param resolucao Apontador para os histogramas (pode ser NULL).
+ */
+void libertarTemposResolucao (TemposResolucao *resolucao);
+
+/**
+ * @brief Devolve o tempo de resolução de uma ordem.
+ * @param ordem Apontador para a ordem.
+ * @return Segundos entre o início e o fim, ou -1 se a ordem não tiver as duas datas (ou forem incoerentes).
+ */
+int64_t tempoResolucaoOrdem (const Ordem *ordem);
+
+/**
+ * @brief Inicializa um agregado de urgência vazio (não aloca memória).
+ * @param urgencia Apontador para o agregado.
+ */
+void inicializarAgregadoUrgencia (AgregadoUrgencia *urgencia);
+
+/**
+ * @brief Liberta a memória de um agregado de urgência.
+ * @param urgencia Apontador para o agregado.
+ */
+void libertarAgregadoUrgencia (AgregadoUrgencia *urgencia);
+
+/**
+ * @brief Procura a urgência de um departamento. O(1).
+ * @param urgencia Apontador para o agregado.
+ * @param idDepartamento ID do departamento.
+ * @return Apontador para a urgência ou NULL se o departamento não tiver ordens.
+ */
+const UrgenciaDepartamento *procurarUrgenciaDepartamento (const AgregadoUrgencia *urgencia, int idDepartamento);
+
+/**
+ * @brief Calcula a urgência total de um departamento.
+ * @details Sem decaimento é a soma dos pesos de todas as ordens. Com decaimento as ordens abertas contam
+ * por inteiro e o peso das fechadas passa a metade por cada URGENCIA_MEIA_VIDA completa (contada em períodos
+ * fixos a partir da referência) desde o fecho.
+ * @param urgencia Apontador para o agregado.
+ * @param departamento Apontador para a urgência do departamento.
+ * @param agora Instante de referência para o decaimento.
+ * @param comDecaimento 1 para aplicar o decaimento às ordens fechadas, 0 para somar todos os pesos.
+ * @return Urgência do departamento.
+ */
+double urgenciaDepartamento (const AgregadoUrgencia *urgencia, const UrgenciaDepartamento *departamento,
+                             Timestamp agora, int comDecaimento);
+
+#ifdef VERIFICAR_CONTADORES
+/**
+ * @brief Verifica (apenas com VERIFICAR_CONTADORES definido) se os contadores mantidos coincidem com uma contagem completa.
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param ativos Apontador para a estrutura de ativos.
+ * @param tecnicos Apontador para a estrutura de técnicos.
+ * @return 1 se os contadores estiverem corretos, caso contrário 0 (a diferença é registada nos logs).
+ */
+int verificarContadores (const Ordens *ordens, const Ativos *ativos, const Tecnicos *tecnicos);
+#endif
+
 #endif /* ORDEM_H */
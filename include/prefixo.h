@@ -0,0 +1,115 @@
+/**
+ * @file prefixo.h
+ * @brief Header com o índice de prefixos (array ordenado de chaves normalizadas) usado na pesquisa por texto.
+ * @author Francisco Alves
+ */
+
+#ifndef PREFIXO_H
+#define PREFIXO_H
+
+#include <stddef.h>
+
+#define PREFIXOS_CAPACIDADE_INICIAL 16 /**< Número de entradas do primeiro array (depois duplica) */
+#define PREFIXOS_TAMANHO_BLOCO 16384   /**< Tamanho mínimo de cada bloco da arena das chaves */
+
+/**
+ * @brief Entrada do índice: chave em minúsculas e posição do registo no array da entidade.
+ */
+typedef struct {
+    const char *chave; /**< Cópia do texto em minúsculas (guardada na arena do índice) */
+    int posicao;       /**< Posição do registo no array */
+}EntradaPrefixo;
+
+/**
+ * @brief Bloco da arena onde o índice guarda as chaves (nunca muda de endereço).
+ */
+typedef struct BlocoChaves {
+    struct BlocoChaves *anterior; /**< Bloco alocado antes deste */
+    size_t usado;                 /**< Bytes ocupados em dados */
+    size_t capacidade;            /**< Bytes disponíveis em dados */
+    char dados[];                 /**< Chaves terminadas em '\0', seguidas */
+}BlocoChaves;
+
+/**
+ * @brief Índice de prefixos: entradas ordenadas por (chave, posicao).
+ * @note A pesquisa de um prefixo faz duas procuras binárias, pelo que o custo depende do número
+ * de resultados e não do número de registos. As chaves ficam numa arena libertada de uma só vez
+ * por limparIndicePrefixos(); as chaves removidas só voltam a estar disponíveis nessa altura.
+ */
+typedef struct {
+    EntradaPrefixo *entradas;
+    int contador;
+    int capacidade;
+    BlocoChaves *blocos; /**< Bloco atual da arena das chaves (lista ligada pelos anteriores) */
+}IndicePrefixos;
+
+/**
+ * @brief Inicializa um índice de prefixos vazio (não aloca memória).
+ * @param indice Apontador para o índice.
+ */
+void inicializarIndicePrefixos(IndicePrefixos *indice);
+
+/**
+ * @brief Garante espaço para um número de entradas (para carregamentos em bloco).
+ * @param indice Apontador para o índice.
+ * @param total Número total de entradas previsto.
+ * @return 1 em caso de sucesso, 0 se não houver memória.
+ */
+int reservarIndicePrefixos(IndicePrefixos *indice, int total);
+
+/**
+ * @brief Insere um texto no índice, mantendo a ordenação.
+ * @param indice Apontador para o índice.
+ * @param texto Texto a indexar (é guardada uma cópia em minúsculas).
+ * @param posicao Posição do registo no array.
+ * @return 1 em caso de sucesso, 0 se não houver memória.
+ */
+int inserirIndicePrefixos(IndicePrefixos *indice, const char *texto, int posicao);
+
+/**
+ * @brief Remove do índice a entrada correspondente a (texto, posicao).
+ * @param indice Apontador para o índice.
+ * @param texto Texto com que a entrada foi inserida.
+ * @param posicao Posição do registo no array.
+ * @return 1 se a entrada foi removida, 0 se não existia.
+ */
+int removerIndicePrefixos(IndicePrefixos *indice, const char *texto, int posicao);
+
+/**
+ * @brief Acrescenta uma entrada no fim do índice sem a ordenar (para carregamentos em bloco).
+ * @param indice Apontador para o índice.
+ * @param texto Texto a indexar.
+ * @param posicao Posição do registo no array.
+ * @return 1 em caso de sucesso, 0 se não houver memória.
+ * @warning Depois das inserções é obrigatório chamar ordenarIndicePrefixos().
+ */
+int acrescentarIndicePrefixos(IndicePrefixos *indice, const char *texto, int posicao);
+
+/**
+ * @brief Ordena as entradas acrescentadas com acrescentarIndicePrefixos().
+ * @param indice Apontador para o índice.
+ */
+void ordenarIndicePrefixos(IndicePrefixos *indice);
+
+/**
+ * @brief Procura as entradas cuja chave começa por um prefixo (sem distinguir maiúsculas de minúsculas).
+ * @param indice Apontador para o índice.
+ * @param prefixo Prefixo a procurar.
+ * @param inicio Devolve a posição da primeira entrada encontrada em indice->entradas.
+ * @return Número de entradas encontradas (são consecutivas e estão por ordem lexicográfica).
+ */
+int procurarIndicePrefixos(const IndicePrefixos *indice, const char *prefixo, int *inicio);
+
+/**
+ * @brief Remove todas as entradas e liberta as chaves, mantendo a memória do array.
+ * @param indice Apontador para o índice.
+ */
+void limparIndicePrefixos(IndicePrefixos *indice);
+
+/**
+ * @brief Liberta a memória do índice e das chaves.
+ * @param indice Apontador para o índice.
+ */
+void libertarIndicePrefixos(IndicePrefixos *indice);
+
+#endif /* PREFIXO_H */
@@ -0,0 +1,97 @@
+/**
+ * @file quantis.h
+ * @brief Header com os histogramas logarítmicos usados para estimar percentis (p50/p90/p99) de durações.
+ * @author Francisco Alves
+ */
+
+#ifndef QUANTIS_H
+#define QUANTIS_H
+
+#include <stdint.h>
+#include "indice.h"
+
+#define HISTOGRAMA_SUBDIVISOES 8 /**< Baldes por potência de 2 (erro relativo máximo de 1/16 ≈ 6%) */
+#define HISTOGRAMA_EXPOENTES 40  /**< Potências de 2 cobertas: durações até 2^40 s */
+#define HISTOGRAMA_BALDES (1 + HISTOGRAMA_EXPOENTES * HISTOGRAMA_SUBDIVISOES) /**< O balde 0 guarda as durações de 0 s */
+
+/**
+ * @brief Histograma de durações (em segundos) com baldes de largura proporcional ao valor.
+ * @details Ocupa sempre o mesmo espaço, independentemente do número de durações registadas, e aceita
+ * retirar durações (delta = -1), o que permite manter o histograma quando uma ordem muda de estado.
+ */
+typedef struct {
+    uint32_t baldes[HISTOGRAMA_BALDES]; /**< Número de durações em cada balde */
+    int total;                          /**< Número total de durações */
+}HistogramaTempos;
+
+/**
+ * @brief Conjunto de histogramas identificados por um ID (ex: um por departamento ou por técnico).
+ * @details Os histogramas são criados quando um ID aparece pela primeira vez, pelo que a memória
+ * cresce com o número de IDs e não com o número de durações.
+ */
+typedef struct {
+    HistogramaTempos *histogramas; /**< Histograma de cada ID, pela ordem em que os IDs apareceram */
+    int *ids;                      /**< ID de cada histograma */
+    int contador;                  /**< Número de histogramas */
+    int capacidade;                /**< Capacidade dos arrays histogramas e ids */
+    IndiceHash indice;             /**< ID -> posição nos arrays */
+}HistogramasPorID;
+
+/**
+ * @brief Esvazia um histograma.
+ * @param histograma Apontador para o histograma.
+ */
+void limparHistograma(HistogramaTempos *histograma);
+
+/**
+ * @brief Soma (delta = 1) ou retira (delta = -1) uma duração do histograma. O(1).
+ * @param histograma Apontador para o histograma.
+ * @param segundos Duração em segundos (valores negativos são ignorados).
+ * @param delta 1 para somar, -1 para retirar.
+ */
+void registarTempo(HistogramaTempos *histograma, int64_t segundos, int delta);
+
+/**
+ * @brief Estima o percentil q das durações registadas.
+ * @param histograma Apontador para o histograma.
+ * @param q Percentil pretendido, entre 0 e 1 (ex: 0.9 para p90).
+ * @return Duração estimada em segundos ou -1 se o histograma estiver vazio.
+ */
+int64_t quantilHistograma(const HistogramaTempos *histograma, double q);
+
+/**
+ * @brief Inicializa um conjunto vazio (não aloca memória).
+ * @param grupo Apontador para o conjunto.
+ */
+void inicializarHistogramasPorID(HistogramasPorID *grupo);
+
+/**
+ * @brief Devolve o histograma de um ID, criando-o se ainda não existir.
+ * @param grupo Apontador para o conjunto.
+ * @param id ID pretendido.
+ * @return Apontador para o histograma ou NULL se não houver memória.
+ * @note O apontador deixa de ser válido quando for criado outro histograma.
+ */
+HistogramaTempos *histogramaDoID(HistogramasPorID *grupo, int id);
+
+/**
+ * @brief Procura o histograma de um ID sem o criar.
+ * @param grupo Apontador para o conjunto.
+ * @param id ID pretendido.
+ * @return Apontador para o histograma ou NULL se o ID não existir.
+ */
+const HistogramaTempos *procurarHistogramaDoID(const HistogramasPorID *grupo, int id);
+
+/**
+ * @brief Esvazia todos os histogramas do conjunto, mantendo os IDs e a memória.
+ * @param grupo Apontador para o conjunto.
+ */
+void limparHistogramasPorID(HistogramasPorID *grupo);
+
+/**
+ * @brief Liberta a memória do conjunto.
+ * @param grupo Apontador para o conjunto.
+ */
+void libertarHistogramasPorID(HistogramasPorID *grupo);
+
+#endif /* QUANTIS_H */
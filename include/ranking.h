@@ -0,0 +1,29 @@
+/**
+ * @file ranking.h
+ * @brief Header com a seleção dos k melhores elementos (top-k) usada nos rankings dos relatórios.
+ * @author Francisco Alves
+ */
+
+#ifndef RANKING_H
+#define RANKING_H
+
+/**
+ * @brief Elemento a classificar: o valor da métrica e a posição do elemento no array de origem.
+ * @note Valores maiores ficam à frente; para métricas em que o menor é melhor usa-se o valor negativo.
+ */
+typedef struct {
+    double valor;  /**< Valor da métrica */
+    int posicao;   /**< Posição no array de origem (desempate: a menor fica à frente) */
+}EntradaRanking;
+
+/**
+ * @brief Seleciona os k melhores elementos e devolve-os ordenados do melhor para o pior. O(n log k).
+ * @param entradas Elementos a classificar (não são alterados).
+ * @param n Número de elementos.
+ * @param k Número de elementos pretendidos.
+ * @param destino Array com espaço para k elementos.
+ * @return Número de elementos escritos em destino (min(n, k)).
+ */
+int selecionarTopK(const EntradaRanking *entradas, int n, int k, EntradaRanking *destino);
+
+#endif /* RANKING_H */
@@ -9,6 +9,94 @@
 
 #include "ordem.h"
 #include "materiais.h"
+#include "ranking.h"
+
+#define RANKING_TAMANHO_PAGINA 10 /**< Técnicos por página no ranking de desempenho */
+
+/**
+ * @brief Métricas disponíveis no ranking de técnicos.
+ */
+typedef enum {
+    RANKING_CONCLUIDAS = 1,   /**< Mais ordens concluídas */
+    RANKING_TEMPO_MEDIANO,    /**< Menor tempo mediano de resolução (só técnicos com ordens concluídas) */
+    RANKING_CUSTO_MATERIAIS   /**< Maior custo de materiais nas ordens concluídas */
+}MetricaRanking;
+
+/**
+ * @brief Ranking de técnicos calculado uma vez e mostrado página a página.
+ */
+typedef struct {
+    MetricaRanking metrica;    /**< Métrica usada para ordenar */
+    EntradaRanking *ordenados; /**< Melhores técnicos, do melhor para o pior (posicao = posição no array) */
+    int numOrdenados;          /**< Número de entradas em ordenados */
+    int classificados;         /**< Número de técnicos com valor para a métrica */
+}RankingTecnicos;
+
+/**
+ * @brief Resultado da agregação dos ativos (calculado numa única passagem pelo array).
+ */
+typedef struct {
+    int total;                        /**< Número total de ativos */
+    int disponiveis;                  /**< Ativos no sistema (não abatidos) */
+    int porEstado[INATIVO2 + 1];      /**< Número de ativos em cada EstadoAtivo */
+    int porCategoria[OUTRO + 1];      /**< Número de ativos em cada CategoriaAtivo */
+    int idxMaisCorretivas;            /**< Posição do ativo com mais manutenções corretivas (-1 se nenhum tiver) */
+    float custoTotal;                 /**< Soma do custo de aquisição dos ativos */
+    float custoManutencaoTotal;       /**< Soma do custo acumulado em manutenções */
+}ResumoAtivos;
+
+/**
+ * @brief Resultado da agregação dos departamentos e das ordens que lhes estão associadas.
+ */
+typedef struct {
+    int total;                /**< Número total de departamentos */
+    int ativos;               /**< Departamentos ativos */
+    EntradaRanking *ranking;  /**< Departamentos com ordens, da maior para a menor urgência (posicao = posição no array) */
+    int numRanking;           /**< Número de entradas de ranking */
+    int idxMaisUrgente;       /**< Posição do departamento com maior urgência (-1 se não houver ordens) */
+}ResumoDepartamentos;
+
+/**
+ * @brief Resultado da agregação dos técnicos.
+ * @note Os valores por técnico (ordens em execução e concluídas) são mantidos no próprio Tecnico.
+ */
+typedef struct {
+    int total;                          /**< Número total de técnicos */
+    int porEstado[INATIVO1 + 1];        /**< Número de técnicos em cada EstadoTecnico */
+    int porEspecialidade[OUTROS + 1];   /**< Número de técnicos em cada Especialidade */
+    int emExecucao;                     /**< Total de ordens em execução atribuídas a técnicos */
+    int concluidas;                     /**< Total de ordens concluídas por técnicos */
+}ResumoTecnicos;
+
+/**
+ * @brief Calcula todas as contagens e totais do relatório de ativos numa única passagem.
+ * @param ativos Apontador para a estrutura com a lista de ativos.
+ * @param resumo Apontador para o resumo a preencher.
+ */
+void agregarAtivos(const Ativos *ativos, ResumoAtivos *resumo);
+
+/**
+ * @brief Ordena os departamentos pela urgência mantida em ordens->urgencia, sem percorrer as ordens. O(D log D).
+ * @param departamentos Apontador para a estrutura com a lista de departamentos.
+ * @param ordens Apontador para a estrutura com a lista de ordens (e o agregado de urgência).
+ * @param comDecaimento 1 para ordenar pela urgência com decaimento das ordens fechadas, 0 para a soma de todos os pesos.
+ * @param resumo Apontador para o resumo a preencher (libertar com libertarResumoDepartamentos()).
+ * @return 1 em caso de sucesso, 0 se não houver memória.
+ */
+int agregarDepartamentos(const Departamentos *departamentos, const Ordens *ordens, int comDecaimento, ResumoDepartamentos *resumo);
+
+/**
+ * @brief Liberta a memória de um resumo de departamentos.
+ * @param resumo Apontador para o resumo.
+ */
+void libertarResumoDepartamentos(ResumoDepartamentos *resumo);
+
+/**
+ * @brief Calcula os totais do relatório de técnicos numa única passagem pelos técnicos.
+ * @param tecnicos Apontador para a estrutura com a lista de técnicos.
+ * @param resumo Apontador para o resumo a preencher.
+ */
+void agregarTecnicos(const Tecnicos *tecnicos, ResumoTecnicos *resumo);
 
 /**
  * @brief Mostra o relatório geral de ativos.
@@ -27,9 +115,8 @@ void mostrarRelatorioDepartamentos (Departamentos *departamentos, Ativos *ativos
 /**
  * @brief Mostra o relatório geral de técnicos.
  * @param tecnicos Apontador para a estrutura com a lista de técnicos.
- * @param ordens Apontador para a estrutura com a lista de ordens.
  */
-void mostrarRelatorioTecnicos (Tecnicos *tecnicos, Ordens *ordens);
+void mostrarRelatorioTecnicos (Tecnicos *tecnicos);
 
 /**
  * @brief Mostra o relatório geral das ordens/manutenções.
@@ -46,10 +133,61 @@ void mostrarRelatorioOrdens (Ordens *ordens, Materiais materiais);
 void relatorioAtivosInstaveis(Ativos ativos, Ordens ordens);
 
 /**
- * @brief Mostra uma análise de incidências por local.
- * @param ativos Estrutura com a lista de ativos.
- * @param ordens Estrutura com a lista de ordens.
+ * @brief Mostra os percentis p50/p90/p99 do tempo de resolução das ordens concluídas: no geral, por prioridade,
+ * por tipo de manutenção, por departamento e por técnico.
+ * @param ordens Apontador para a estrutura com a lista de ordens (e os histogramas mantidos).
+ * @param departamentos Apontador para a estrutura com a lista de departamentos.
+ * @param tecnicos Apontador para a estrutura com a lista de técnicos.
+ */
+void relatorioTemposResolucao(const Ordens *ordens, const Departamentos *departamentos, const Tecnicos *tecnicos);
+
+/**
+ * @brief Calcula o ranking de técnicos segundo uma métrica, para depois mostrar uma ou mais páginas.
+ * @param tecnicos Apontador para a estrutura com a lista de técnicos.
+ * @param ordens Apontador para a estrutura de ordens (pode ser NULL em RANKING_CONCLUIDAS).
+ * @param materiais Apontador para a estrutura de materiais (pode ser NULL se a métrica não for RANKING_CUSTO_MATERIAIS).
+ * @param metrica Métrica usada para ordenar.
+ * @param limite Número de técnicos a ordenar (0 ordena todos).
+ * @param ranking Apontador para o resultado (libertar com libertarRankingTecnicos()).
+ * @return 1 em caso de sucesso, 0 se a métrica não estiver disponível ou não houver memória.
+ */
+int calcularRankingTecnicos(const Tecnicos *tecnicos, const Ordens *ordens, const Materiais *materiais,
+                            MetricaRanking metrica, int limite, RankingTecnicos *ranking);
+
+/**
+ * @brief Mostra uma página de um ranking já calculado, sem voltar a percorrer técnicos nem ordens.
+ * @param ranking Ranking devolvido por calcularRankingTecnicos().
+ * @param tecnicos Apontador para a estrutura com a lista de técnicos (a mesma usada no cálculo).
+ * @param pagina Página a mostrar (a primeira é 0).
+ * @param tamanhoPagina Número de técnicos por página.
+ */
+void mostrarPaginaRankingTecnicos(const RankingTecnicos *ranking, const Tecnicos *tecnicos, int pagina, int tamanhoPagina);
+
+/**
+ * @brief Liberta a memória de um ranking de técnicos.
+ * @param ranking Apontador para o ranking.
+ */
+void libertarRankingTecnicos(RankingTecnicos *ranking);
+
+/**
+ * @brief Mostra uma página do ranking de técnicos segundo uma métrica (seleção top-k, O(n log k)).
+ * @param tecnicos Apontador para a estrutura com a lista de técnicos.
+ * @param ordens Apontador para a estrutura de ordens (pode ser NULL em RANKING_CONCLUIDAS).
+ * @param materiais Apontador para a estrutura de materiais (pode ser NULL se a métrica não for RANKING_CUSTO_MATERIAIS).
+ * @param metrica Métrica usada para ordenar.
+ * @param pagina Página a mostrar (a primeira é 0).
+ * @param tamanhoPagina Número de técnicos por página.
+ * @return Número de técnicos classificados (para calcular o número de páginas) ou -1 em caso de erro.
+ */
+int mostrarRankingTecnicos(const Tecnicos *tecnicos, const Ordens *ordens, const Materiais *materiais,
+                           MetricaRanking metrica, int pagina, int tamanhoPagina);
+
+/**
+ * @brief Mostra uma análise de incidências por local, ordenada pelo número de incidências.
+ * @param ativos Apontador para a estrutura com a lista de ativos.
+ * @param ordens Apontador para a estrutura com a lista de ordens.
+ * @param limite Número máximo de locais a mostrar (0 mostra todos).
  */
-void relatorioProblemasPorLocal(Ativos ativos, Ordens ordens);
+void relatorioProblemasPorLocal(const Ativos *ativos, const Ordens *ordens, int limite);
 
 #endif /* RELATORIOS_H */
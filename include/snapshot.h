@@ -0,0 +1,193 @@
+/**
+ * @file snapshot.h
+ * @brief Header com o formato versionado dos ficheiros binários (snapshots) e funções auxiliares.
+ * @author Francisco Alves
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "dicionario.h"
+
+#define SNAPSHOT_MAGIC "SGMA"
+#define SNAPSHOT_VERSAO 4                 /**< Versão escrita nos ficheiros gravados */
+#define SNAPSHOT_VERSAO_TIMESTAMPS 3      /**< Primeira versão com as datas de ativos e ordens em Timestamp */
+#define SNAPSHOT_VERSAO_ORDEM_COMPACTA 4  /**< Primeira versão com as ordens no registo compacto de 40 bytes */
+#define SNAPSHOT_MAX_SECCOES 4
+#define SNAPSHOT_STRING_NULA UINT32_MAX
+
+/**
+ * @brief Localização de uma secção (bloco contíguo) dentro do ficheiro.
+ */
+typedef struct {
+    uint64_t offset;   /**< Posição do início da secção no ficheiro */
+    uint64_t tamanho;  /**< Tamanho da secção em bytes */
+}SeccaoSnapshot;
+
+/**
+ * @brief Cabeçalho escrito no início de cada snapshot.
+ */
+typedef struct {
+    char magic[4];               /**< Identificador do formato (SNAPSHOT_MAGIC) */
+    uint32_t versao;             /**< Versão do esquema dos registos */
+    int32_t contador;            /**< Número de registos guardados */
+    int32_t contadorAuxiliar;    /**< Contador extra da entidade (ex: ativos disponíveis) */
+    int32_t proximoID;           /**< Próximo ID a atribuir (0 nos ficheiros da versão 1) */
+    int32_t reservado[3];        /**< Metadados da entidade, escritos a 0 se não forem usados (ordens.bin: reservado[0]) */
+    uint32_t numSeccoes;         /**< Número de secções utilizadas */
+    uint32_t tamanhoRegisto;     /**< Tamanho de cada registo da secção 0 */
+    SeccaoSnapshot seccoes[SNAPSHOT_MAX_SECCOES]; /**< Tabela de secções */
+}CabecalhoSnapshot;
+
+/**
+ * @brief Buffer onde as strings de um snapshot são concatenadas (terminadas em '\0').
+ */
+typedef struct {
+    char *dados;
+    size_t tamanho;
+    size_t capacidade;
+    const PoolStrings *pool; /**< Pool cujas strings são deduplicadas (NULL se o heap não for deduplicado) */
+    uint32_t *offsetsPool; /**< Offset já escrito de cada ID do pool (NULL se o heap não for deduplicado) */
+    int numOffsetsPool;    /**< Número de entradas de offsetsPool */
+}HeapStrings;
+
+/**
+ * @brief Ficheiro de snapshot mapeado em memória (só leitura do ficheiro, cópia privada ao escrever).
+ */
+typedef struct {
+    void *base;      /**< Início do mapeamento ou NULL se não estiver mapeado */
+    size_t tamanho;  /**< Tamanho do mapeamento em bytes */
+}MapaSnapshot;
+
+/**
+ * @brief Prepara um cabeçalho vazio com o magic e a versão atuais.
+ * @param cab Apontador para o cabeçalho a inicializar.
+ * @param contador Número de registos.
+ * @param contadorAuxiliar Contador extra da entidade.
+ * @param tamanhoRegisto Tamanho de cada registo fixo.
+ */
+void inicializarCabecalhoSnapshot(CabecalhoSnapshot *cab, int contador, int contadorAuxiliar, size_t tamanhoRegisto);
+
+/**
+ * @brief Escreve o cabeçalho e todas as secções, calculando os offsets.
+ * @param fp Ficheiro aberto em modo de escrita binária.
+ * @param cab Cabeçalho com numSeccoes e o tamanho de cada secção preenchidos.
+ * @param blocos Array com o apontador para os dados de cada secção.
+ * @return 1 em caso de sucesso, 0 caso a escrita falhe.
+ */
+int escreverSnapshot(FILE *fp, CabecalhoSnapshot *cab, const void *const *blocos);
+
+/**
+ * @brief Garante que o conteúdo de um ficheiro chegou ao disco (fflush seguido de fsync).
+ * @param fp Ficheiro aberto em modo de escrita.
+ * @return 1 se os dados ficaram no disco, caso contrário 0.
+ */
+int sincronizarFicheiro(FILE *fp);
+
+/**
+ * @brief Garante que as entradas da pasta de um ficheiro (criação, rename) chegaram ao disco.
+ * @param ficheiro Nome do ficheiro cuja pasta vai ser sincronizada.
+ * @return 1 se a pasta foi sincronizada (ou não for necessário), caso contrário 0.
+ */
+int sincronizarDiretorio(const char *ficheiro);
+
+/**
+ * @brief Abre um ficheiro temporário onde o snapshot será escrito.
+ * @param ficheiro Nome do ficheiro final (ex: "ativos.bin").
+ * @return Ficheiro aberto em modo de escrita binária ou NULL em caso de erro.
+ * @note O ficheiro final só é substituído em fecharSnapshotEscrita(), pelo que mapeamentos
+ * existentes do ficheiro antigo continuam válidos.
+ */
+FILE *abrirSnapshotEscrita(const char *ficheiro);
+
+/**
+ * @brief Fecha o ficheiro temporário e substitui o ficheiro final caso a escrita tenha corrido bem.
+ * @details O ficheiro temporário e a pasta são sincronizados com o disco (sincronizarFicheiro(),
+ * sincronizarDiretorio()), pelo que um valor de retorno 1 significa que o snapshot é durável.
+ * @param fp Ficheiro devolvido por abrirSnapshotEscrita().
+ * @param ficheiro Nome do ficheiro final.
+ * @param sucesso 1 se a escrita foi bem sucedida, 0 para descartar o ficheiro temporário.
+ * @return 1 se o ficheiro final foi substituído, 0 caso contrário.
+ */
+int fecharSnapshotEscrita(FILE *fp, const char *ficheiro, int sucesso);
+
+/**
+ * @brief Lê e valida o cabeçalho de um snapshot.
+ * @param fp Ficheiro aberto em modo de leitura binária.
+ * @param cab Apontador onde o cabeçalho será guardado.
+ * @return 1 se o ficheiro estiver no formato versionado, 0 se for um ficheiro antigo (sem cabeçalho).
+ * @note Ficheiros de uma versão mais recente são devolvidos sem secções (numSeccoes = 0).
+ * Quando devolve 0 o ficheiro é reposicionado no início para ser lido pelo leitor antigo.
+ */
+int lerCabecalhoSnapshot(FILE *fp, CabecalhoSnapshot *cab);
+
+/**
+ * @brief Lê uma secção completa com uma única leitura.
+ * @param fp Ficheiro aberto em modo de leitura binária.
+ * @param cab Cabeçalho já validado.
+ * @param seccao Índice da secção.
+ * @param destino Buffer com pelo menos cab->seccoes[seccao].tamanho bytes.
+ * @return 1 em caso de sucesso, 0 caso contrário.
+ */
+int lerSeccaoSnapshot(FILE *fp, const CabecalhoSnapshot *cab, int seccao, void *destino);
+
+/**
+ * @brief Mapeia um snapshot em memória e valida o cabeçalho e a tabela de secções.
+ * @param ficheiro Nome do ficheiro.
+ * @param mapa Apontador onde o mapeamento será guardado.
+ * @param cab Apontador onde o cabeçalho será copiado.
+ * @return 1 se o ficheiro foi mapeado, 0 se não existir, for do formato antigo, estiver
+ * corrompido ou se a plataforma não suportar mmap (deve ser usada a leitura normal).
+ */
+int mapearSnapshot(const char *ficheiro, MapaSnapshot *mapa, CabecalhoSnapshot *cab);
+
+/**
+ * @brief Devolve o início de uma secção de um snapshot mapeado.
+ * @param mapa Mapeamento válido.
+ * @param cab Cabeçalho do snapshot.
+ * @param seccao Índice da secção.
+ * @return Apontador para os dados da secção ou NULL se a secção não existir.
+ */
+void *seccaoMapeada(const MapaSnapshot *mapa, const CabecalhoSnapshot *cab, int seccao);
+
+/**
+ * @brief Desfaz o mapeamento de um snapshot.
+ * @param mapa Apontador para o mapeamento.
+ */
+void desmapearSnapshot(MapaSnapshot *mapa);
+
+/**
+ * @brief Faz com que cada string de um pool seja escrita no heap uma única vez (strings iguais partilham o offset).
+ * @param heap Apontador para o heap (ainda vazio).
+ * @param pool Pool de onde vêm todas as strings que vão ser acrescentadas.
+ * @note Se não houver memória o heap continua a funcionar, mas sem deduplicação.
+ */
+void deduplicarHeapStrings(HeapStrings *heap, const PoolStrings *pool);
+
+/**
+ * @brief Acrescenta uma string ao heap de strings.
+ * @param heap Apontador para o heap.
+ * @param str String a acrescentar (pode ser NULL; do pool indicado em deduplicarHeapStrings(), se tiver sido usada).
+ * @return Offset da string no heap, SNAPSHOT_STRING_NULA se str for NULL ou se a alocação falhar.
+ */
+uint32_t adicionarStringHeap(HeapStrings *heap, const char *str);
+
+/**
+ * @brief Devolve uma string guardada no heap sem a copiar.
+ * @param heap Início do heap de strings.
+ * @param tamanho Tamanho do heap em bytes.
+ * @param offset Offset da string.
+ * @return Apontador para a string dentro do heap ou NULL se o offset for nulo/inválido.
+ */
+const char *stringHeap(const char *heap, size_t tamanho, uint32_t offset);
+
+/**
+ * @brief Liberta a memória do heap de strings.
+ * @param heap Apontador para o heap.
+ */
+void libertarHeapStrings(HeapStrings *heap);
+
+#endif /* SNAPSHOT_H */
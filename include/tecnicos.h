@@ -7,6 +7,11 @@
 #ifndef TECNICOS_H
 #define TECNICOS_H
 
+#include "indice.h"
+#include "dicionario.h"
+
+#define LIMITE_ORDENS_TECNICO 5 /**< Número máximo de ordens em execução por técnico */
+
 /**
  * @brief Especialidades dos técnicos.
  */
@@ -32,10 +37,13 @@ typedef enum {
  */
 typedef struct {
     int idTecnico;                /**< Identificador único do técnico */
-    char *nome;                   /**< Nome do técnico */
+    const char *nome;             /**< Nome do técnico (string de tecnicos->strings) */
     Especialidade especialidade;  /**< Especialidade do técnico */
     EstadoTecnico estado_tecnico; /**< Estado atual do técnico */
     int idManutencaoAssociado;    /**< ID da manutenção associada (se houver) */
+    int ordensEmExecucao;         /**< Ordens em execução atribuídas (calculado, não é guardado) */
+    int idsEmExecucao[LIMITE_ORDENS_TECNICO]; /**< IDs dessas ordens, sem ordem definida (calculado, não é guardado) */
+    int ordensConcluidas;         /**< Ordens concluídas pelo técnico (calculado, não é guardado) */
 }Tecnico;
 
 /**
@@ -46,6 +54,9 @@ typedef struct {
     int contador;      /**< Contador de técnicos na lista */
     int tecnicosAtivos;/**< Contador de técnicos ativos */
     int capacidade;    /**< Capacidade máxima da lista de técnicos */
+    IndiceHash indice; /**< ID -> posição no array */
+    int proximoID;     /**< Próximo ID a atribuir (guardado no snapshot e no journal) */
+    PoolStrings strings; /**< Nomes dos técnicos (cada nome diferente é guardado uma vez) */
 }Tecnicos;
 
 /**
@@ -62,9 +73,9 @@ void listar_tecnicos (Tecnicos tecnicos);
 
 /**
  * @brief Desativa um técnico (marca como INATIVO1).
- * @param tecnicos Estrutura com a lista de técnicos.
+ * @param tecnicos Apontador para a estrutura com a lista de técnicos.
  */
-void desativar_tecnico (Tecnicos tecnicos);
+void desativar_tecnico (Tecnicos *tecnicos);
 
 /**
  * @brief Procura um técnico pelo ID.
@@ -77,8 +88,9 @@ int procurar_tecnico_id (Tecnicos tecnicos, int idProcurado);
 /**
  * @brief Guarda os técnicos num ficheiro binário.
  * @param tecnicos Apontador para a estrutura com a lista de técnicos.
+ * @return 1 se o ficheiro foi gravado com sucesso, caso contrário 0.
  */
-void guardarTecnicos(Tecnicos *tecnicos);
+int guardarTecnicos(Tecnicos *tecnicos);
 
 /**
  * @brief Carrega os técnicos a partir de um ficheiro binário.
@@ -87,9 +99,9 @@ void guardarTecnicos(Tecnicos *tecnicos);
 void carregarTecnicos(Tecnicos *tecnicos);
 
 /**
- * @brief Obtém o maior ID existente na lista de técnicos.
+ * @brief Obtém o maior ID já atribuído na lista de técnicos (lido do contador proximoID).
  * @param tecnicos Estrutura com a lista de técnicos.
- * @return Retorna o maior ID ou 0 caso não existam técnicos.
+ * @return Retorna o maior ID ou 0 caso ainda não tenha sido atribuído nenhum.
  */
 int obterMaiorIDTecnicos(Tecnicos tecnicos);
 
@@ -107,4 +119,13 @@ const char *passar_int_string_especialidade(Especialidade esp);
  */
 const char *passar_int_string_estado (EstadoTecnico estado_tecnico);
 
+/**
+ * @brief Repõe um técnico registado no journal (cria-o ou substitui o existente com o mesmo ID).
+ * @param tecnicos Apontador para a estrutura com a lista de técnicos.
+ * @param tecnico Técnico lido do journal (o nome é copiado para o pool da lista).
+ * @param tecnicosAtivos Contador de técnicos ativos no momento do registo.
+ * @param proximoID Próximo ID a atribuir no momento do registo.
+ */
+void reporTecnico(Tecnicos *tecnicos, const Tecnico *tecnico, int tecnicosAtivos, int proximoID);
+
 #endif /* TECNICOS_H */
@@ -7,52 +7,201 @@
 #include <stdio.h>
 #include<string.h>
 #include <stdlib.h>
-#include <time.h>
+#include <stdint.h>
 #include "../include/departamentos.h"
 #include "../include/ativos.h"
 #include "../include/input.h"
 #include "../include/logs.h"
+#include "../include/snapshot.h"
+#include "../include/journal.h"
 
 #define CRESCIMENTO_5 5
+#define PESQUISA_LIMITE_RESULTADOS 50 /**< Resultados mostrados por pesquisa inteligente */
 
 /**
- * @brief Função para obter o maior ID da lista de ativos.
+ * @brief Função que devolve o maior ID já atribuído a um ativo.
  * @param ativos Estrutura que contém a lista de ativos e o contador.
- * @return Retorna o ID mais alto da lista de ativos.
+ * @return Retorna o último ID atribuído (lido do contador proximoID), ou 0 se ainda não foi atribuído nenhum.
  */
 int obterMaiorIDAtivos(Ativos ativos) {
-    int maxID = 0;
-    for (int i = 0; i < ativos.contador; i++) {
-        if (ativos.ativo[i].id > maxID) {
-            maxID = ativos.ativo[i].id;
-        }
-    }
-    return maxID;
+    return ativos.proximoID > 0 ? ativos.proximoID - 1 : 0;
 }
 
 
 /**
- * @brief Gera um IDúnico e sequencial para um novo ativo.
- * @details Percorre o array de ativos para encontrar o ID mais alto e adiciona uma unidade,
- * este método garante que será sempre criado um ID novo mesmo que o programa seja reiniciado ou sejam removidos registos.
+ * @brief Gera um ID único e sequencial para um novo ativo.
+ * @details Usa o contador proximoID, que é guardado no snapshot e no journal, pelo que a atribuição é O(1)
+ * e um ID nunca é reutilizado, mesmo depois de o programa ser reiniciado.
  * @param ativos Apontador para a estrutura que contém a lista de ativos e contador.
- * @return Retorna o um valor inteiro maior que o ID do ativo mais recente da lista,
- * ou retorna 10 caso o contador ainda esteja a 0.
+ * @return Retorna o ID atribuído (o primeiro é PRIMEIRO_ID).
  */
 static int gerarProximoID(Ativos *ativos) {
-    if (ativos->contador == 0) {
-        return 10;
+    if (ativos->proximoID < PRIMEIRO_ID) {
+        ativos->proximoID = PRIMEIRO_ID;
     }
+    return ativos->proximoID++;
+}
+
+/**
+ * @brief Inicializa as colunas de ativos desligadas (não aloca memória).
+ * @param colunas Apontador para as colunas.
+ */
+void inicializarColunasAtivos (ColunasAtivos *colunas) {
+    memset(colunas, 0, sizeof(*colunas));
+}
+
+/**
+ * @brief Altera a capacidade de todas as colunas.
+ * @param colunas Apontador para as colunas.
+ * @param capacidade Nova capacidade (maior do que 0).
+ * @return 1 em caso de sucesso, 0 se não houver memória (as colunas já realocadas mantêm-se válidas).
+ */
+static int redimensionarColunasAtivos (ColunasAtivos *colunas, int capacidade) {
+    size_t n = (size_t)capacidade;
+    void *tmp;
+
+    if ((tmp = realloc(colunas->id, n * sizeof(int))) == NULL) return 0;
+    colunas->id = tmp;
+    if ((tmp = realloc(colunas->estado, n * sizeof(uint8_t))) == NULL) return 0;
+    colunas->estado = tmp;
+    if ((tmp = realloc(colunas->categoria, n * sizeof(uint8_t))) == NULL) return 0;
+    colunas->categoria = tmp;
+    if ((tmp = realloc(colunas->idDepartamento, n * sizeof(int))) == NULL) return 0;
+    colunas->idDepartamento = tmp;
+    if ((tmp = realloc(colunas->corretivas, n * sizeof(int))) == NULL) return 0;
+    colunas->corretivas = tmp;
+    if ((tmp = realloc(colunas->custo, n * sizeof(float))) == NULL) return 0;
+    colunas->custo = tmp;
+    if ((tmp = realloc(colunas->custoAcumulado, n * sizeof(float))) == NULL) return 0;
+    colunas->custoAcumulado = tmp;
+    if ((tmp = realloc(colunas->dataAquisicao, n * sizeof(Timestamp))) == NULL) return 0;
+    colunas->dataAquisicao = tmp;
+    if ((tmp = realloc(colunas->dataAbate, n * sizeof(Timestamp))) == NULL) return 0;
+    colunas->dataAbate = tmp;
+
+    colunas->capacidade = capacidade;
+    return 1;
+}
+
+/**
+ * @brief Liberta a memória das colunas de ativos e deixa-as desligadas.
+ * @param ativos Apontador para a estrutura com a lista de ativos.
+ */
+void libertarColunasAtivos (Ativos *ativos) {
+    ColunasAtivos *colunas = &ativos->colunas;
+    free(colunas->id);
+    free(colunas->estado);
+    free(colunas->categoria);
+    free(colunas->idDepartamento);
+    free(colunas->corretivas);
+    free(colunas->custo);
+    free(colunas->custoAcumulado);
+    free(colunas->dataAquisicao);
+    free(colunas->dataAbate);
+    inicializarColunasAtivos(colunas);
+}
 
-    int maxID = 0;
+/**
+ * @brief Liga as colunas de ativos, copiando para elas todos os ativos existentes. O(A).
+ * @details A partir daqui as colunas crescem com o array de ativos (garantir_capacidade_ativos). Se faltar
+ * memória as colunas são desligadas e as agregações voltam a percorrer o array de ativos.
+ * @param ativos Apontador para a estrutura com a lista de ativos.
+ * @return 1 em caso de sucesso, 0 se não houver memória (as colunas ficam desligadas).
+ */
+int ativarColunasAtivos (Ativos *ativos) {
+    int capacidade = ativos->capacidade > 0 ? ativos->capacidade : CRESCIMENTO_5;
+    if (!redimensionarColunasAtivos(&ativos->colunas, capacidade)) {
+        registar_log("Erro: Falha ao alocar memória para as colunas de ativos.");
+        libertarColunasAtivos(ativos);
+        return 0;
+    }
     for (int i = 0; i < ativos->contador; i++) {
-        if (ativos->ativo[i].id > maxID) {
-            maxID = ativos->ativo[i].id;
-        }
+        sincronizarColunasAtivo(ativos, i);
     }
+    return 1;
+}
+
+/**
+ * @brief Devolve as colunas de ativos, se estiverem ligadas.
+ * @param ativos Apontador para a estrutura com a lista de ativos.
+ * @return Apontador para as colunas ou NULL se estiverem desligadas.
+ */
+const ColunasAtivos *colunasAtivos (const Ativos *ativos) {
+    return ativos->colunas.capacidade > 0 ? &ativos->colunas : NULL;
+}
+
+/**
+ * @brief Copia os campos de um ativo para as colunas (não faz nada se estiverem desligadas).
+ * @param ativos Apontador para a estrutura com a lista de ativos.
+ * @param idx Posição do ativo no array.
+ */
+void sincronizarColunasAtivo (Ativos *ativos, int idx) {
+    ColunasAtivos *colunas = &ativos->colunas;
+    if (idx < 0 || idx >= colunas->capacidade) return;
+
+    const Ativo *ativo = &ativos->ativo[idx];
+    colunas->id[idx] = ativo->id;
+    colunas->estado[idx] = (uint8_t)ativo->estado;
+    colunas->categoria[idx] = (uint8_t)ativo->categoria;
+    colunas->idDepartamento[idx] = ativo->idDepartamentoAssociado;
+    colunas->corretivas[idx] = ativo->contagemManutencoesCorretivas;
+    colunas->custo[idx] = ativo->custo;
+    colunas->custoAcumulado[idx] = ativo->custoTotalAcumulado;
+    colunas->dataAquisicao[idx] = ativo->dataAquisicao;
+    colunas->dataAbate[idx] = ativo->dataAbate;
+}
+
+/**
+ * @brief Altera o estado de um ativo, mantendo as colunas.
+ * @param ativos Apontador para a estrutura com a lista de ativos.
+ * @param idx Posição do ativo no array.
+ * @param estado Novo estado.
+ */
+void definirEstadoAtivo (Ativos *ativos, int idx, EstadoAtivo estado) {
+    ativos->ativo[idx].estado = estado;
+    if (idx < ativos->colunas.capacidade) ativos->colunas.estado[idx] = (uint8_t)estado;
+}
+
+/**
+ * @brief Soma delta ao número de manutenções corretivas de um ativo, mantendo as colunas.
+ * @param ativos Apontador para a estrutura com a lista de ativos.
+ * @param idx Posição do ativo no array.
+ * @param delta Valor a somar (1 ou -1).
+ */
+void somarCorretivasAtivo (Ativos *ativos, int idx, int delta) {
+    ativos->ativo[idx].contagemManutencoesCorretivas += delta;
+    if (idx < ativos->colunas.capacidade) ativos->colunas.corretivas[idx] += delta;
+}
 
-    return maxID + 1;
+#ifdef VERIFICAR_CONTADORES
+/**
+ * @brief Verifica se as colunas coincidem com o array de ativos.
+ * @details Só existe com VERIFICAR_CONTADORES definido: compara cada coluna com o campo correspondente de cada ativo.
+ * @param ativos Apontador para a estrutura com a lista de ativos.
+ * @return 1 se coincidirem ou estiverem desligadas, caso contrário 0 (a diferença é registada nos logs).
+ */
+int verificarColunasAtivos (const Ativos *ativos) {
+    const ColunasAtivos *colunas = colunasAtivos(ativos);
+    if (colunas == NULL) return 1;
+
+    for (int i = 0; i < ativos->contador; i++) {
+        const Ativo *ativo = &ativos->ativo[i];
+        if (colunas->id[i] != ativo->id || colunas->estado[i] != (uint8_t)ativo->estado ||
+            colunas->categoria[i] != (uint8_t)ativo->categoria ||
+            colunas->idDepartamento[i] != ativo->idDepartamentoAssociado ||
+            colunas->corretivas[i] != ativo->contagemManutencoesCorretivas ||
+            colunas->custo[i] != ativo->custo || colunas->custoAcumulado[i] != ativo->custoTotalAcumulado ||
+            colunas->dataAquisicao[i] != ativo->dataAquisicao || colunas->dataAbate[i] != ativo->dataAbate) {
+            char mensagem[120];
+            snprintf(mensagem, sizeof(mensagem), "Erro: Colunas do ativo %d inconsistentes com o array de ativos.", ativo->id);
+            printf("%s\n", mensagem);
+            registar_log(mensagem);
+            return 0;
+        }
+    }
+    return 1;
 }
+#endif
 
 /**
  * @brief Expande a capacidade do array de ativos de forma dinâmica.
@@ -78,6 +227,11 @@ static int garantir_capacidade_ativos(Ativos *ativos, int minCap) {
 
     ativos->ativo = (Ativo *)tmp;
     ativos->capacidade = novaCap;
+
+    if (ativos->colunas.capacidade > 0 && !redimensionarColunasAtivos(&ativos->colunas, novaCap)) {
+        registar_log("Erro: Falha ao expandir as colunas de ativos; as colunas foram desligadas.");
+        libertarColunasAtivos(ativos);
+    }
     return 1;
 }
 
@@ -123,12 +277,8 @@ static const char *passar_int_string_estado_idx(EstadoAtivo estado_ativo) {
  * @return 1 caso seja válido, caso contrário 0.
  */
 int validar_departamento_associado (Departamentos *departamentos,int idAssociado) {
-    for (int i =0; i < departamentos->contador; i++) {
-        if (departamentos->departamento[i].idDepartamento == idAssociado && departamentos->departamento[i].atividade == ATIVO) {
-            return 1;
-        }
-    }
-    return 0;
+    int idx = procurarIdDepartamento(*departamentos, idAssociado);
+    return idx != -1 && departamentos->departamento[idx].atividade == ATIVO;
 }
 
 /**
@@ -162,7 +312,7 @@ void criar_ativo (Ativos *ativos, Departamentos *departamentos) {
     int idx = ativos->contador;
 
     printf ("\n===== CRIAR ATIVO ===== \n");
-    ativos->ativo[idx].designacao = lerStringDinamica("Indique a designação do ativo:\n");
+    ativos->ativo[idx].designacao = lerStringPool(&ativos->strings, "Indique a designação do ativo:\n");
     ativos->ativo[idx].categoria = obterIntIntervalado(1,5,"Indique a categoria do ativo:\n1 - Viatura\n2 - Informática\n3 - Mobiliário\n4 - Ferramenta\n5 - Outro\n");
     ativos->ativo[idx].custo = obterFloatPositivo("Indique o valor em euros do ativo.");
 
@@ -175,25 +325,23 @@ void criar_ativo (Ativos *ativos, Departamentos *departamentos) {
     } while (validar == 0);
 
     ativos->ativo[idx].idDepartamentoAssociado = idAssociado;
-    ativos->ativo[idx].localizacao = lerStringDinamica("Indique a localização do ativo:\n");
-
-    time_t agora = time(NULL);
-    struct tm *tmLocal = localtime(&agora);
-    if (tmLocal != NULL) {
-        ativos->ativo[idx].diaAquisicao = tmLocal->tm_mday;
-        ativos->ativo[idx].mesAquisicao = tmLocal->tm_mon + 1;
-        ativos->ativo[idx].anoAquisicao = tmLocal->tm_year + 1900;
-    } else {
-        ativos->ativo[idx].diaAquisicao = 1;
-        ativos->ativo[idx].mesAquisicao = 1;
-        ativos->ativo[idx].anoAquisicao = 1970;
-    }
-
+    ativos->ativo[idx].localizacao = lerStringPool(&ativos->strings, "Indique a localização do ativo:\n");
+
+    ativos->ativo[idx].dataAquisicao = timestampAtual();
+    ativos->ativo[idx].dataAbate = SEM_DATA;
+    ativos->ativo[idx].contagemManutencoesCorretivas = 0;
+    ativos->ativo[idx].custoTotalAcumulado = 0;
+    ativos->ativo[idx].totalOrdens = 0;
+    ativos->ativo[idx].ultimaOrdem = -1;
     ativos->ativo[idx].estado = OPERACIONAL;
     ativos->ativo[idx].id = gerarProximoID(ativos);
+    inserirIndice(&ativos->indice, ativos->ativo[idx].id, idx);
+    inserirIndicePrefixos(&ativos->designacoes, ativos->ativo[idx].designacao, idx);
+    sincronizarColunasAtivo(ativos, idx);
 
     ativos->contador++;
     ativos->ativosDisponiveis++;
+    journalAtivo(ativos, idx);
 
     registar_log("Info: Foi criado um novo ativo.");
 
@@ -209,10 +357,9 @@ void criar_ativo (Ativos *ativos, Departamentos *departamentos) {
  * @return Retorna o índice associado ao ativo com o mesmo ID no array ou -1 caso não encontre.
  */
 int procurar_ativo_id (Ativos *ativos, int idProcurado) {
-    for (int i = 0; i<ativos->contador; i++) {
-        if (ativos->ativo[i].id == idProcurado && ativos->ativo[i].estado != ABATIDO) {
-            return i;
-        }
+    int idx = procurarIndice(&ativos->indice, idProcurado);
+    if (idx != -1 && ativos->ativo[idx].estado != ABATIDO) {
+        return idx;
     }
     return -1;
 }
@@ -237,43 +384,130 @@ void listar_ativos(Ativos ativos) {
         pausar_ecra();
         return;
     }
+    char data[TAMANHO_DATA_TEXTO];
     for (int i = 0; i< ativos.contador; i++) {
         printf ("ID: %d\n", ativos.ativo[i].id);
         printf ("Designação: %s\n", ativos.ativo[i].designacao ? ativos.ativo[i].designacao : "(sem designação)");
         printf ("Categoria: %s\n", passar_int_string_categoria_idx(ativos.ativo[i].categoria));
         printf("Estado do ativo: %s\n", passar_int_string_estado_idx(ativos.ativo[i].estado));
-        printf ("Data de aquisição: %d/%d/%d\n", ativos.ativo[i].diaAquisicao, ativos.ativo[i].mesAquisicao, ativos.ativo[i].anoAquisicao);
+        printf ("Data de aquisição: %s\n", formatarData(ativos.ativo[i].dataAquisicao, data, sizeof(data)));
         if (ativos.ativo[i].estado == ABATIDO) {
-            printf("Data de abate: %d/%d/%d\n", ativos.ativo[i].diaAbate, ativos.ativo[i].mesAbate, ativos.ativo[i].anoAbate);
+            printf("Data de abate: %s\n", formatarData(ativos.ativo[i].dataAbate, data, sizeof(data)));
         }
     }
     pausar_ecra();
 }
 
 /**
- * @brief Lista todos os ativos organizados por departamento.
+ * @brief Agrupa os ativos por departamento com duas passagens pelos ativos (counting sort).
+ * @details A primeira passagem encontra o departamento de cada ativo (pelo índice de IDs), conta os ativos
+ * e soma os custos de cada departamento; as somas prefixas dão o início de cada grupo e a segunda passagem
+ * coloca cada ativo no seu grupo. Custo O(A + D), em vez de percorrer todos os ativos por cada departamento.
+ * @param departamentos Apontador para a estrutura com a lista de departamentos.
+ * @param ativos Apontador para a estrutura com a lista de ativos.
+ * @param grupos Apontador para o resultado (libertar com libertarAtivosPorDepartamento()).
+ * @return 1 em caso de sucesso, 0 se não houver memória.
+ */
+int agruparAtivosPorDepartamento (const Departamentos *departamentos, const Ativos *ativos, AtivosPorDepartamento *grupos) {
+    int numDepartamentos = departamentos->contador;
+    grupos->numDepartamentos = numDepartamentos;
+    grupos->posicoes = malloc(((size_t)ativos->contador + 1) * sizeof(int));
+    grupos->inicio = calloc((size_t)numDepartamentos + 2, sizeof(int));
+    grupos->custo = calloc((size_t)numDepartamentos + 1, sizeof(float));
+    grupos->custoAcumulado = calloc((size_t)numDepartamentos + 1, sizeof(float));
+    int *departamentoDoAtivo = malloc(((size_t)ativos->contador + 1) * sizeof(int));
+
+    if (grupos->posicoes == NULL || grupos->inicio == NULL || grupos->custo == NULL ||
+        grupos->custoAcumulado == NULL || departamentoDoAtivo == NULL) {
+        registar_log("Erro: Falha ao alocar memória para agrupar os ativos por departamento.");
+        free(departamentoDoAtivo);
+        libertarAtivosPorDepartamento(grupos);
+        return 0;
+    }
+
+    /* inicio[d + 1] começa por contar os ativos do departamento d. Com as colunas ligadas só são lidas
+     * as colunas do departamento e dos custos. */
+    const ColunasAtivos *colunas = colunasAtivos(ativos);
+    for (int j = 0; j < ativos->contador; j++) {
+        int idDepartamento = colunas ? colunas->idDepartamento[j] : ativos->ativo[j].idDepartamentoAssociado;
+        int d = procurarIndice(&departamentos->indice, idDepartamento);
+        departamentoDoAtivo[j] = d;
+        if (d == -1) continue;
+        grupos->inicio[d + 1]++;
+        grupos->custo[d] += colunas ? colunas->custo[j] : ativos->ativo[j].custo;
+        grupos->custoAcumulado[d] += colunas ? colunas->custoAcumulado[j] : ativos->ativo[j].custoTotalAcumulado;
+    }
+    for (int d = 0; d < numDepartamentos; d++) {
+        grupos->inicio[d + 1] += grupos->inicio[d];
+    }
+
+    /* inicio[d + 1] serve de cursor de escrita; no fim volta a ser o início do grupo seguinte. */
+    for (int j = 0; j < ativos->contador; j++) {
+        int d = departamentoDoAtivo[j];
+        if (d != -1) grupos->posicoes[grupos->inicio[d]++] = j;
+    }
+    for (int d = numDepartamentos; d > 0; d--) {
+        grupos->inicio[d] = grupos->inicio[d - 1];
+    }
+    grupos->inicio[0] = 0;
+
+    free(departamentoDoAtivo);
+    return 1;
+}
+
+/**
+ * @brief Liberta a memória de um agrupamento de ativos por departamento.
+ * @param grupos Apontador para o agrupamento.
+ */
+void libertarAtivosPorDepartamento (AtivosPorDepartamento *grupos) {
+    free(grupos->posicoes);
+    free(grupos->inicio);
+    free(grupos->custo);
+    free(grupos->custoAcumulado);
+    grupos->posicoes = NULL;
+    grupos->inicio = NULL;
+    grupos->custo = NULL;
+    grupos->custoAcumulado = NULL;
+    grupos->numDepartamentos = 0;
+}
+
+/**
+ * @brief Lista todos os ativos organizados por departamento, com os totais de cada departamento.
+ * @details Os ativos são agrupados uma única vez por agruparAtivosPorDepartamento(), pelo que a listagem
+ * custa O(A + D) em vez de percorrer todos os ativos por cada departamento.
  * @param departamentos Estrutura que contém a lista de departamentos.
  * @param ativos Estrutura que contém a lista de ativos.
  */
 void listar_ativos_por_departamento (Departamentos departamentos, Ativos ativos) {
     if (departamentos.departamento == NULL || ativos.ativo == NULL) return;
+
+    AtivosPorDepartamento grupos;
+    if (!agruparAtivosPorDepartamento(&departamentos, &ativos, &grupos)) {
+        printf("Erro: sem memória para listar os ativos por departamento.\n");
+        return;
+    }
+
+    char data[TAMANHO_DATA_TEXTO];
     for (int i = 0; i< departamentos.contador; i++) {
         printf ("===== %s =====\n", departamentos.departamento[i].nomeDepartamento ? departamentos.departamento[i].nomeDepartamento : "(sem nome)");
-        for (int j=0; j < ativos.contador; j++) {
-            if (ativos.ativo[j].idDepartamentoAssociado == departamentos.departamento[i].idDepartamento) {
-                printf ("ID: %d\n", ativos.ativo[j].id);
-                printf ("Designação: %s\n", ativos.ativo[j].designacao ? ativos.ativo[j].designacao : "(sem designação)");
-                printf ("Categoria: %s\n", passar_int_string_categoria_idx(ativos.ativo[j].categoria));
-                printf("Estado do ativo: %s\n", passar_int_string_estado_idx(ativos.ativo[j].estado));
-                printf ("Data de aquisição: %d/%d/%d\n", ativos.ativo[j].diaAquisicao, ativos.ativo[j].mesAquisicao, ativos.ativo[j].anoAquisicao);
-            }
+        for (int k = grupos.inicio[i]; k < grupos.inicio[i + 1]; k++) {
+            const Ativo *ativo = &ativos.ativo[grupos.posicoes[k]];
+            printf ("ID: %d\n", ativo->id);
+            printf ("Designação: %s\n", ativo->designacao ? ativo->designacao : "(sem designação)");
+            printf ("Categoria: %s\n", passar_int_string_categoria_idx(ativo->categoria));
+            printf("Estado do ativo: %s\n", passar_int_string_estado_idx(ativo->estado));
+            printf ("Data de aquisição: %s\n", formatarData(ativo->dataAquisicao, data, sizeof(data)));
         }
+        printf ("Total: %d ativos | Custo: %.2f | Custo em manutenções: %.2f\n",
+                grupos.inicio[i + 1] - grupos.inicio[i], grupos.custo[i], grupos.custoAcumulado[i]);
     }
+
+    libertarAtivosPorDepartamento(&grupos);
 }
 
 /**
  * @brief Função para abater os ativos, registando também a data atual.
- * @details Altera o estado de ativo para ABATIDO e utiliza a biblioteca time.h
+ * @details Altera o estado de ativo para ABATIDO e regista a data de abate (timestampAtual)
  * para capturar automaticamente o momento da operação. Impede que o faça se
  * os ativos ja estiverem abatidos ou se estiverem a meio de uma manutenção.
  * @param ativos Apontador para a estrutura que contém a lista de ativos.
@@ -282,78 +516,148 @@ void listar_ativos_por_departamento (Departamentos departamentos, Ativos ativos)
 void abater_ativo (Ativos *ativos) {
     int idProcurado, idEncontrado;
 
-    time_t agora = time(NULL);
-    struct tm *tmLocal = localtime(&agora);
-
     idProcurado = obterIntPositivo("Indique o id do ativo que deseja abater");
     idEncontrado = procurar_ativo_id(ativos, idProcurado);
 
-    if (ativos->ativo[idEncontrado].estado == EM_MANUTENCAO || ativos->ativo[idEncontrado].estado == ABATIDO) {
+    if (idEncontrado == -1 || ativos->ativo[idEncontrado].estado == EM_MANUTENCAO || ativos->ativo[idEncontrado].estado == ABATIDO) {
         printf("ID inválido tente novamente.\n");
         return;
     }
 
     ativos->ativo[idEncontrado].estado = ABATIDO;
-    ativos->ativo[idEncontrado].diaAbate = tmLocal->tm_mday;
-    ativos->ativo[idEncontrado].mesAbate = tmLocal->tm_mon + 1;
-    ativos->ativo[idEncontrado].anoAbate = tmLocal->tm_year + 1900;
+    removerIndicePrefixos(&ativos->designacoes, ativos->ativo[idEncontrado].designacao, idEncontrado);
+    ativos->ativo[idEncontrado].dataAbate = timestampAtual();
+    sincronizarColunasAtivo(ativos, idEncontrado);
+    journalAtivo(ativos, idEncontrado);
 
     printf("O ativo foi abatido com sucesso.");
     registar_log("Info: Um ativo foi abatido com sucesso.");
 }
 
+/**
+ * @brief Registo de tamanho fixo de um ativo tal como é guardado no snapshot.
+ * @note As strings são guardadas no heap de strings (secção 1) e aqui fica apenas o seu offset.
+ */
+typedef struct {
+    int64_t dataAquisicao;
+    int64_t dataAbate;
+    int32_t id;
+    int32_t categoria;
+    int32_t estado;
+    int32_t idDepartamentoAssociado;
+    int32_t contagemManutencoesCorretivas;
+    float custo;
+    float custoTotalAcumulado;
+    uint32_t designacao;
+    uint32_t localizacao;
+    int32_t reservado; /**< Escrito a 0 (mantém o tamanho múltiplo de 8) */
+} AtivoDisco;
+
+/**
+ * @brief Registo de um ativo no formato anterior do snapshot (datas em campos dia/mês/ano separados).
+ * @note Só é usado para ler e converter ficheiros antigos; a gravação seguinte usa AtivoDisco.
+ */
+typedef struct {
+    int32_t id;
+    int32_t categoria;
+    int32_t estado;
+    int32_t idDepartamentoAssociado;
+    int32_t diaAquisicao;
+    int32_t mesAquisicao;
+    int32_t anoAquisicao;
+    int32_t diaAbate;
+    int32_t mesAbate;
+    int32_t anoAbate;
+    int32_t contagemManutencoesCorretivas;
+    float custo;
+    float custoTotalAcumulado;
+    uint32_t designacao;
+    uint32_t localizacao;
+} AtivoDiscoCampos;
+
 /**
  * @brief Guarda a base de dados de ativos num ficheiro binário.
+ * @details O ficheiro começa por um CabecalhoSnapshot seguido de duas secções: o array de registos
+ * AtivoDisco (tamanho fixo) e o heap com as strings. Cada secção é escrita com um único fwrite.
  * @param ativos Apontador para a estrutura que contém as informações que serão escritas no ficheiro.
+ * @return 1 se o ficheiro foi gravado com sucesso, caso contrário 0.
  * @note O ficheiro é sobrescrito a cada gravação para manter os dados atuais.
  */
-void guardarAtivos(Ativos *ativos) {
-    FILE *fp = fopen("ativos.bin", "wb");
+int guardarAtivos(Ativos *ativos) {
+    AtivoDisco *registos = NULL;
+    HeapStrings heap = {0};
+
+    if (ativos->contador > 0) {
+        registos = malloc((size_t)ativos->contador * sizeof(AtivoDisco));
+        if (registos == NULL) {
+            printf("Erro: sem memória para guardar ativos.\n");
+            registar_log("Erro: Falha ao alocar memória para serializar ativos.");
+            return 0;
+        }
+    }
+
+    deduplicarHeapStrings(&heap, &ativos->strings);
+    for (int i = 0; i < ativos->contador; i++) {
+        Ativo *a = &ativos->ativo[i];
+        registos[i].id = a->id;
+        registos[i].categoria = a->categoria;
+        registos[i].estado = a->estado;
+        registos[i].idDepartamentoAssociado = a->idDepartamentoAssociado;
+        registos[i].dataAquisicao = a->dataAquisicao;
+        registos[i].dataAbate = a->dataAbate;
+        registos[i].reservado = 0;
+        registos[i].contagemManutencoesCorretivas = a->contagemManutencoesCorretivas;
+        registos[i].custo = a->custo;
+        registos[i].custoTotalAcumulado = a->custoTotalAcumulado;
+        registos[i].designacao = adicionarStringHeap(&heap, a->designacao);
+        registos[i].localizacao = adicionarStringHeap(&heap, a->localizacao);
+    }
+
+    FILE *fp = abrirSnapshotEscrita("ativos.bin");
     if (fp == NULL) {
         printf("Erro ao abrir ficheiro de ativos para escrita!\n");
         registar_log("Erro: Não foi possivel abrir ativos.bin para escrita.");
-        return;
+        free(registos);
+        libertarHeapStrings(&heap);
+        return 0;
     }
-    fwrite(&ativos->contador, sizeof(int), 1, fp);
-    fwrite(&ativos->ativosDisponiveis, sizeof(int), 1, fp);
 
-    for (int i = 0; i < ativos->contador; i++) {
-        fwrite(&ativos->ativo[i].id, sizeof(int), 1, fp);
-        fwrite(&ativos->ativo[i].categoria, sizeof(CategoriaAtivo), 1, fp);
-        fwrite(&ativos->ativo[i].estado, sizeof(EstadoAtivo), 1, fp);
-        fwrite(&ativos->ativo[i].custo, sizeof(float), 1, fp);
-        fwrite(&ativos->ativo[i].custoTotalAcumulado, sizeof(float), 1, fp);
-        fwrite(&ativos->ativo[i].idDepartamentoAssociado, sizeof(int), 1, fp);
-        fwrite(&ativos->ativo[i].diaAquisicao, sizeof(int), 1, fp);
-        fwrite(&ativos->ativo[i].mesAquisicao, sizeof(int), 1, fp);
-        fwrite(&ativos->ativo[i].anoAquisicao, sizeof(int), 1, fp);
-        escreverStringBinario(ativos->ativo[i].designacao, fp);
-        escreverStringBinario(ativos->ativo[i].localizacao, fp);
+    CabecalhoSnapshot cab;
+    inicializarCabecalhoSnapshot(&cab, ativos->contador, ativos->ativosDisponiveis, sizeof(AtivoDisco));
+    cab.proximoID = ativos->proximoID;
+    cab.numSeccoes = 2;
+    cab.seccoes[0].tamanho = (uint64_t)ativos->contador * sizeof(AtivoDisco);
+    cab.seccoes[1].tamanho = heap.tamanho;
+    const void *blocos[] = { registos, heap.dados };
+
+    int sucesso = escreverSnapshot(fp, &cab, blocos);
+    if (!fecharSnapshotEscrita(fp, "ativos.bin", sucesso)) {
+        printf("Erro ao escrever o ficheiro de ativos!\n");
+        registar_log("Erro: Falha na escrita de ativos.bin.");
+        sucesso = 0;
     }
 
-    fclose(fp);
+    free(registos);
+    libertarHeapStrings(&heap);
+    return sucesso;
 }
 
 /**
- * @brief Carrega a base de dados de ativos através de um ficheiro binário.
+ * @brief Carrega os ativos a partir do formato antigo (sem cabeçalho, um fread por campo).
  * @param ativos Apontador para a estrutura onde os dados lidos serão armazenados.
- * @note se o ficheiro não existir a função é ignorada.
- * @warning A função realiza alocações dinâmicas pelo que deve ser garantida a libertação posterior de memória
- * para evitar memory leaks.
+ * @param fp Ficheiro aberto e posicionado no início.
  */
-void carregarAtivos(Ativos *ativos) {
-    FILE *fp = fopen("ativos.bin", "rb");
-    if (fp == NULL) return;
-
+static void carregarAtivosLegado(Ativos *ativos, FILE *fp) {
     fread(&ativos->contador, sizeof(int), 1, fp);
     fread(&ativos->ativosDisponiveis, sizeof(int), 1, fp);
 
     ativos->capacidade = ativos->contador;
-    ativos->ativo = malloc(ativos->capacidade * sizeof(Ativo));
+    ativos->ativo = calloc((size_t)ativos->capacidade, sizeof(Ativo));
 
     if (ativos->ativo == NULL && ativos->contador > 0) {
         registar_log("Erro: Falha ao alocar memória ao carregar ativos (malloc devolveu NULL).");
-        fclose(fp);
+        ativos->contador = 0;
+        ativos->capacidade = 0;
         return;
     }
 
@@ -364,62 +668,323 @@ void carregarAtivos(Ativos *ativos) {
         fread(&ativos->ativo[i].custo, sizeof(float), 1, fp);
         fread(&ativos->ativo[i].custoTotalAcumulado, sizeof(float), 1, fp);
         fread(&ativos->ativo[i].idDepartamentoAssociado, sizeof(int), 1, fp);
-        fread(&ativos->ativo[i].diaAquisicao, sizeof(int), 1, fp);
-        fread(&ativos->ativo[i].mesAquisicao, sizeof(int), 1, fp);
-        fread(&ativos->ativo[i].anoAquisicao, sizeof(int), 1, fp);
-        ativos->ativo[i].designacao = lerStringBinario(fp);
-        ativos->ativo[i].localizacao = lerStringBinario(fp);
+        int dia = 0, mes = 0, ano = 0;
+        fread(&dia, sizeof(int), 1, fp);
+        fread(&mes, sizeof(int), 1, fp);
+        fread(&ano, sizeof(int), 1, fp);
+        ativos->ativo[i].dataAquisicao = timestampDeCampos(ano, mes, dia, 0, 0, 0);
+        ativos->ativo[i].dataAbate = SEM_DATA;
+        ativos->ativo[i].designacao = lerStringBinario(fp, &ativos->strings);
+        ativos->ativo[i].localizacao = lerStringBinario(fp, &ativos->strings);
     }
+}
 
+/**
+ * @brief Converte os registos AtivoDisco de um snapshot para o array de ativos.
+ * @param ativos Apontador para a estrutura com o array já alocado.
+ * @param cab Cabeçalho do snapshot.
+ * @param registos Array de registos lidos (ou mapeados) do ficheiro.
+ * @param heap Heap de strings do snapshot (as strings são internadas em ativos->strings).
+ */
+static void preencherAtivosSnapshot(Ativos *ativos, const CabecalhoSnapshot *cab, const AtivoDisco *registos,
+                                    const char *heap) {
+    size_t tamanhoHeap = (size_t)cab->seccoes[1].tamanho;
+    for (int i = 0; i < cab->contador; i++) {
+        Ativo *a = &ativos->ativo[i];
+        a->id = registos[i].id;
+        a->categoria = registos[i].categoria;
+        a->estado = registos[i].estado;
+        a->idDepartamentoAssociado = registos[i].idDepartamentoAssociado;
+        a->dataAquisicao = registos[i].dataAquisicao;
+        a->dataAbate = registos[i].dataAbate;
+        a->contagemManutencoesCorretivas = registos[i].contagemManutencoesCorretivas;
+        a->custo = registos[i].custo;
+        a->custoTotalAcumulado = registos[i].custoTotalAcumulado;
+        a->designacao = internarStringPool(&ativos->strings, stringHeap(heap, tamanhoHeap, registos[i].designacao));
+        a->localizacao = internarStringPool(&ativos->strings, stringHeap(heap, tamanhoHeap, registos[i].localizacao));
+    }
+
+    ativos->contador = cab->contador;
+    ativos->ativosDisponiveis = cab->contadorAuxiliar;
+    ativos->capacidade = cab->contador;
+    if (cab->proximoID > ativos->proximoID) {
+        ativos->proximoID = cab->proximoID;
+    }
+}
+
+/**
+ * @brief Verifica se o cabeçalho corresponde à versão atual dos registos de ativos.
+ * @details O formato é escolhido pela versão; o tamanho do registo só serve para confirmar.
+ * @param cab Cabeçalho lido do ficheiro.
+ * @return 1 se for suportado, caso contrário 0.
+ */
+static int snapshotAtivosValido(const CabecalhoSnapshot *cab) {
+    return cab->versao >= SNAPSHOT_VERSAO_TIMESTAMPS &&
+           cab->numSeccoes >= 2 && cab->tamanhoRegisto == sizeof(AtivoDisco) &&
+           cab->seccoes[0].tamanho == (uint64_t)cab->contador * sizeof(AtivoDisco);
+}
+
+/**
+ * @brief Verifica se o cabeçalho corresponde ao formato anterior dos registos (AtivoDiscoCampos).
+ * @details Os ficheiros anteriores a SNAPSHOT_VERSAO_TIMESTAMPS guardam as datas em dia/mês/ano; o tamanho
+ * do registo só serve para confirmar.
+ * @param cab Cabeçalho lido do ficheiro.
+ * @return 1 se os registos estiverem no formato anterior, caso contrário 0.
+ */
+static int snapshotAtivosCamposValido(const CabecalhoSnapshot *cab) {
+    return cab->versao < SNAPSHOT_VERSAO_TIMESTAMPS &&
+           cab->numSeccoes >= 2 && cab->tamanhoRegisto == sizeof(AtivoDiscoCampos) &&
+           cab->seccoes[0].tamanho == (uint64_t)cab->contador * sizeof(AtivoDiscoCampos);
+}
+
+/**
+ * @brief Converte, no próprio buffer, registos no formato anterior para AtivoDisco.
+ * @details Como sizeof(AtivoDisco) <= sizeof(AtivoDiscoCampos), o registo i é escrito antes de o registo i + 1
+ * ser lido; cada registo antigo é copiado para uma variável local antes de ser reescrito.
+ * @param buffer Buffer com contador registos AtivoDiscoCampos.
+ * @param contador Número de registos.
+ */
+static void converterAtivosCampos(void *buffer, int contador) {
+    _Static_assert(sizeof(AtivoDisco) <= sizeof(AtivoDiscoCampos), "AtivoDisco não pode ser maior que o formato anterior");
+    const unsigned char *origem = buffer;
+    AtivoDisco *destino = buffer;
+    for (int i = 0; i < contador; i++) {
+        AtivoDiscoCampos antigo;
+        memcpy(&antigo, origem + (size_t)i * sizeof(AtivoDiscoCampos), sizeof(antigo));
+        AtivoDisco novo = {
+            .dataAquisicao = timestampDeCampos(antigo.anoAquisicao, antigo.mesAquisicao, antigo.diaAquisicao, 0, 0, 0),
+            .dataAbate = timestampDeCampos(antigo.anoAbate, antigo.mesAbate, antigo.diaAbate, 0, 0, 0),
+            .id = antigo.id,
+            .categoria = antigo.categoria,
+            .estado = antigo.estado,
+            .idDepartamentoAssociado = antigo.idDepartamentoAssociado,
+            .contagemManutencoesCorretivas = antigo.contagemManutencoesCorretivas,
+            .custo = antigo.custo,
+            .custoTotalAcumulado = antigo.custoTotalAcumulado,
+            .designacao = antigo.designacao,
+            .localizacao = antigo.localizacao,
+            .reservado = 0
+        };
+        memcpy(&destino[i], &novo, sizeof(novo));
+    }
+}
+
+/**
+ * @brief Carrega os ativos mapeando o ficheiro em memória.
+ * @details Os registos são lidos diretamente das páginas mapeadas e as strings (designação e
+ * localização) são internadas em ativos->strings, sem nenhum malloc por string: cada texto diferente
+ * é copiado uma vez para a arena do pool. O ficheiro é desmapeado no fim da leitura.
+ * @param ativos Apontador para a estrutura onde os dados serão carregados.
+ * @return 1 se os ativos foram carregados, 0 se deve ser usada a leitura normal.
+ */
+static int carregarAtivosMapeado(Ativos *ativos) {
+    CabecalhoSnapshot cab;
+    MapaSnapshot mapa;
+
+    if (!mapearSnapshot("ativos.bin", &mapa, &cab)) return 0;
+
+    if (!snapshotAtivosValido(&cab)) {
+        desmapearSnapshot(&mapa);
+        return 0;
+    }
+
+    ativos->ativo = malloc(((size_t)cab.contador + 1) * sizeof(Ativo));
+    if (ativos->ativo == NULL) {
+        registar_log("Erro: Falha ao alocar memória ao carregar ativos (malloc devolveu NULL).");
+        desmapearSnapshot(&mapa);
+        return 1;
+    }
+
+    preencherAtivosSnapshot(ativos, &cab, seccaoMapeada(&mapa, &cab, 0), seccaoMapeada(&mapa, &cab, 1));
+    desmapearSnapshot(&mapa);
+    return 1;
+}
+
+/**
+ * @brief Lê ativos.bin no formato disponível (mapeado, versionado ou antigo).
+ * @param ativos Apontador para a estrutura onde os dados lidos serão armazenados.
+ */
+static void lerFicheiroAtivos(Ativos *ativos) {
+    if (carregarAtivosMapeado(ativos)) return;
+
+    FILE *fp = fopen("ativos.bin", "rb");
+    if (fp == NULL) return;
+
+    CabecalhoSnapshot cab;
+    if (!lerCabecalhoSnapshot(fp, &cab)) {
+        carregarAtivosLegado(ativos, fp);
+        fclose(fp);
+        return;
+    }
+
+    int formatoAnterior = snapshotAtivosCamposValido(&cab);
+    if (!snapshotAtivosValido(&cab) && !formatoAnterior) {
+        registar_log("Erro: ativos.bin tem um formato/versão não suportado.");
+        fclose(fp);
+        return;
+    }
+
+    AtivoDisco *registos = malloc((size_t)cab.seccoes[0].tamanho + 1);
+    char *heap = malloc((size_t)cab.seccoes[1].tamanho + 1);
+    ativos->ativo = malloc(((size_t)cab.contador + 1) * sizeof(Ativo));
+
+    if (registos == NULL || heap == NULL || ativos->ativo == NULL) {
+        registar_log("Erro: Falha ao alocar memória ao carregar ativos (malloc devolveu NULL).");
+        free(registos);
+        free(heap);
+        free(ativos->ativo);
+        ativos->ativo = NULL;
+        fclose(fp);
+        return;
+    }
+
+    if (!lerSeccaoSnapshot(fp, &cab, 0, registos) || !lerSeccaoSnapshot(fp, &cab, 1, heap)) {
+        registar_log("Erro: ativos.bin está truncado ou corrompido.");
+        free(registos);
+        free(heap);
+        free(ativos->ativo);
+        ativos->ativo = NULL;
+        fclose(fp);
+        return;
+    }
     fclose(fp);
+
+    if (formatoAnterior) {
+        converterAtivosCampos(registos, cab.contador);
+        registar_log("Info: ativos.bin convertido do formato anterior (datas em dia/mês/ano).");
+    }
+    preencherAtivosSnapshot(ativos, &cab, registos, heap);
+
+    free(registos);
+    free(heap);
+}
+
+/**
+ * @brief Reconstrói o índice de IDs e o índice de designações a partir do array de ativos.
+ * @details Garante também que proximoID é maior do que todos os IDs carregados (ficheiros antigos não o guardam).
+ * As designações são acrescentadas sem ordem (com o espaço reservado de uma vez) e ordenadas no fim com um
+ * único qsort.
+ * @param ativos Apontador para a estrutura que contém a lista de ativos.
+ */
+static void indexarAtivos(Ativos *ativos) {
+    if (!limparIndice(&ativos->indice, ativos->contador)) return;
+    limparIndicePrefixos(&ativos->designacoes);
+    reservarIndicePrefixos(&ativos->designacoes, ativos->contador);
+    for (int i = 0; i < ativos->contador; i++) {
+        inserirIndice(&ativos->indice, ativos->ativo[i].id, i);
+        if (ativos->ativo[i].id >= ativos->proximoID) {
+            ativos->proximoID = ativos->ativo[i].id + 1;
+        }
+        if (ativos->ativo[i].estado != ABATIDO) {
+            acrescentarIndicePrefixos(&ativos->designacoes, ativos->ativo[i].designacao, i);
+        }
+    }
+    ordenarIndicePrefixos(&ativos->designacoes);
+}
+
+/**
+ * @brief Carrega a base de dados de ativos através de um ficheiro binário.
+ * @details Sempre que possível o ficheiro é mapeado em memória (carregarAtivosMapeado). Caso contrário,
+ * se o ficheiro tiver cabeçalho, o array de registos e o heap de strings são lidos com uma leitura cada;
+ * ficheiros sem cabeçalho são entregues ao leitor do formato antigo.
+ * @param ativos Apontador para a estrutura onde os dados lidos serão armazenados.
+ * @note se o ficheiro não existir a função é ignorada.
+ * @warning A função realiza alocações dinâmicas pelo que deve ser garantida a libertação posterior de memória
+ * para evitar memory leaks.
+ */
+void carregarAtivos(Ativos *ativos) {
+    lerFicheiroAtivos(ativos);
+    indexarAtivos(ativos);
+}
+
+/**
+ * @brief Repõe um ativo registado no journal (cria-o ou substitui o existente com o mesmo ID).
+ * @param ativos Apontador para a estrutura que contém a lista de ativos.
+ * @param ativo Ativo lido do journal (as strings são copiadas para ativos->strings).
+ * @param ativosDisponiveis Contador de ativos disponíveis no momento do registo.
+ * @param proximoID Próximo ID a atribuir no momento do registo.
+ */
+void reporAtivo(Ativos *ativos, const Ativo *ativo, int ativosDisponiveis, int proximoID) {
+    int idx = procurarIndice(&ativos->indice, ativo->id);
+
+    if (idx == -1) {
+        if (!garantir_capacidade_ativos(ativos, ativos->contador + 1)) return;
+        idx = ativos->contador++;
+        inserirIndice(&ativos->indice, ativo->id, idx);
+    } else {
+        if (ativos->ativo[idx].estado != ABATIDO) {
+            removerIndicePrefixos(&ativos->designacoes, ativos->ativo[idx].designacao, idx);
+        }
+    }
+    ativos->ativo[idx] = *ativo;
+    ativos->ativo[idx].designacao = internarStringPool(&ativos->strings, ativo->designacao);
+    ativos->ativo[idx].localizacao = internarStringPool(&ativos->strings, ativo->localizacao);
+    sincronizarColunasAtivo(ativos, idx);
+    if (ativo->estado != ABATIDO) {
+        inserirIndicePrefixos(&ativos->designacoes, ativo->designacao, idx);
+    }
+    ativos->ativosDisponiveis = ativosDisponiveis;
+    if (proximoID > ativos->proximoID) {
+        ativos->proximoID = proximoID;
+    }
+    if (ativo->id >= ativos->proximoID) {
+        ativos->proximoID = ativo->id + 1;
+    }
 }
 
 /**
  * @brief Função de pesquisa inteligente de ativos.
- * @details Permite ao usuário pesquisar ativos pela designação, mostrando resultados que começam com o termo pesquisado.
- * A pesquisa não é sensível a maiúsculas ou minúsculas.
+ * @details Permite ao usuário pesquisar ativos pela designação, mostrando por ordem alfabética os resultados
+ * que começam com o termo pesquisado. A pesquisa não é sensível a maiúsculas ou minúsculas e usa o índice
+ * de designações (duas procuras binárias), pelo que o tempo depende do número de resultados e não do
+ * número de ativos. Os ativos abatidos não aparecem.
  * @param ativos Estrutura que contém a lista de ativos.
  * @param termo String com o termo a pesquisar.
+ * @param limite Número máximo de resultados a mostrar (0 para mostrar todos).
+ * @return Número total de ativos encontrados (pode ser maior do que limite).
  */
-void pesquisaInteligenteAtivos(Ativos ativos, const char *termo) {
-    int encontrados = 0;
+int pesquisaInteligenteAtivos(Ativos ativos, const char *termo, int limite) {
+    int inicio, encontrados, mostrar;
 
     if (termo == NULL || termo[0] == '\0') {
         printf("Termo de pesquisa inválido.\n");
-        return;
+        return 0;
     }
 
     if (ativos.contador == 0) {
         printf("Não existem ativos para pesquisar.\n");
-        return;
+        return 0;
     }
 
     if (ativos.ativo == NULL) {
         printf("Erro interno: lista de ativos não inicializada.\n");
         registar_log("Erro: Lista de ativos não inicializada (ativos.ativo == NULL) ao tentar pesquisar.");
-        return;
+        return 0;
     }
 
-    int tam = (int)strlen(termo);
+    encontrados = procurarIndicePrefixos(&ativos.designacoes, termo, &inicio);
+    mostrar = (limite > 0 && encontrados > limite) ? limite : encontrados;
 
     printf("\n--- RESULTADOS PARA '%s' ---\n", termo);
 
-    for (int i = 0; i < ativos.contador; i++) {
-        if (ativos.ativo[i].designacao == NULL) {
-            continue;
-        }
-
-        if (strncasecmp(ativos.ativo[i].designacao, termo, (size_t)tam) == 0) {
-            printf("ID %d: %s\n", ativos.ativo[i].id, ativos.ativo[i].designacao);
-            encontrados++;
-        }
+    for (int i = inicio; i < inicio + mostrar; i++) {
+        const Ativo *ativo = &ativos.ativo[ativos.designacoes.entradas[i].posicao];
+        printf("ID %d: %s\n", ativo->id, ativo->designacao);
     }
 
     if (encontrados == 0) {
         printf("Nenhum ativo começa por '%s'.\n", termo);
+    } else if (mostrar < encontrados) {
+        printf("... e mais %d ativo(s). Refine o termo para ver os restantes.\n", encontrados - mostrar);
     }
+    return encontrados;
 }
 
+/**
+ * @brief Pede ao utilizador um termo e lista os ativos cuja designação começa por esse termo.
+ * @param ativos Estrutura que contém a lista de ativos.
+ * @note São mostrados no máximo PESQUISA_LIMITE_RESULTADOS resultados.
+ */
 void listarComPesquisaInteligente (Ativos ativos) {
     char *termo;
 
@@ -443,7 +1008,7 @@ void listarComPesquisaInteligente (Ativos ativos) {
         return;
     }
 
-    pesquisaInteligenteAtivos(ativos, termo);
+    pesquisaInteligenteAtivos(ativos, termo, PESQUISA_LIMITE_RESULTADOS);
 
     free(termo);
 }
@@ -0,0 +1,120 @@
+/**
+ * @file datas.c
+ * @brief Ficheiro com as funções de datas/horas.
+ * @details As datas são guardadas como Timestamp (segundos desde 1970), o que permite calcular durações
+ * com uma subtração. A conversão para dia/mês/ano só é feita quando a data é apresentada.
+ * @author Francisco Alves
+ */
+
+#define _POSIX_C_SOURCE 200809L /* localtime_r */
+
+#include <stdio.h>
+#include <time.h>
+#include "../include/datas.h"
+
+/**
+ * @brief Devolve o instante atual.
+ * @return Segundos desde 1970 (UTC).
+ */
+Timestamp timestampAtual(void) {
+    return (Timestamp)time(NULL);
+}
+
+/**
+ * @brief Converte uma data/hora local em campos separados (formato antigo dos ficheiros) num Timestamp.
+ * @param ano Ano (0 indica que a data não estava definida).
+ * @param mes Mês (1 a 12).
+ * @param dia Dia do mês.
+ * @param hora Hora.
+ * @param min Minutos.
+ * @param seg Segundos.
+ * @return Timestamp correspondente ou SEM_DATA se a data não estiver definida/for inválida.
+ */
+Timestamp timestampDeCampos(int ano, int mes, int dia, int hora, int min, int seg) {
+    if (ano == 0) return SEM_DATA;
+
+    struct tm campos = {
+        .tm_mday = dia,
+        .tm_mon = mes - 1,
+        .tm_year = ano - 1900,
+        .tm_hour = hora,
+        .tm_min = min,
+        .tm_sec = seg,
+        .tm_isdst = -1
+    };
+    time_t t = mktime(&campos);
+    if (t == (time_t)-1) return SEM_DATA;
+    return (Timestamp)t;
+}
+
+/**
+ * @brief Converte um Timestamp para hora local.
+ * @param t Instante a converter.
+ * @param campos Estrutura a preencher.
+ * @return 1 em caso de sucesso, 0 se a data não estiver definida ou não puder ser convertida.
+ */
+static int decomporTimestamp(Timestamp t, struct tm *campos) {
+    if (t == SEM_DATA) return 0;
+    time_t valor = (time_t)t;
+    return localtime_r(&valor, campos) != NULL;
+}
+
+/**
+ * @brief Escreve a data (d/m/aaaa, hora local) de um Timestamp.
+ * @param t Instante a formatar.
+ * @param destino Buffer de destino (TAMANHO_DATA_TEXTO chega).
+ * @param tamanho Tamanho do buffer.
+ * @return destino, para poder ser usado diretamente num printf.
+ */
+const char *formatarData(Timestamp t, char *destino, size_t tamanho) {
+    struct tm campos;
+    if (!decomporTimestamp(t, &campos)) {
+        snprintf(destino, tamanho, "-");
+    } else {
+        snprintf(destino, tamanho, "%d/%d/%d", campos.tm_mday, campos.tm_mon + 1, campos.tm_year + 1900);
+    }
+    return destino;
+}
+
+/**
+ * @brief Escreve a data e a hora (dd/mm/aaaa hh:mm:ss, hora local) de um Timestamp.
+ * @param t Instante a formatar.
+ * @param destino Buffer de destino (TAMANHO_DATA_TEXTO chega).
+ * @param tamanho Tamanho do buffer.
+ * @return destino, para poder ser usado diretamente num printf.
+ */
+const char *formatarDataHora(Timestamp t, char *destino, size_t tamanho) {
+    struct tm campos;
+    if (!decomporTimestamp(t, &campos)) {
+        snprintf(destino, tamanho, "-");
+    } else {
+        snprintf(destino, tamanho, "%02d/%02d/%04d %02d:%02d:%02d", campos.tm_mday, campos.tm_mon + 1,
+                 campos.tm_year + 1900, campos.tm_hour, campos.tm_min, campos.tm_sec);
+    }
+    return destino;
+}
+
+/**
+ * @brief Escreve uma duração em segundos como "Nd hh:mm:ss" (ou "hh:mm:ss" se for inferior a um dia).
+ * @param segundos Duração (valores negativos são apresentados como "-").
+ * @param destino Buffer de destino (TAMANHO_DATA_TEXTO chega).
+ * @param tamanho Tamanho do buffer.
+ * @return destino, para poder ser usado diretamente num printf.
+ */
+const char *formatarDuracao(int64_t segundos, char *destino, size_t tamanho) {
+    if (segundos < 0) {
+        snprintf(destino, tamanho, "-");
+        return destino;
+    }
+
+    long long dias = segundos / 86400;
+    int horas = (int)(segundos % 86400 / 3600);
+    int minutos = (int)(segundos % 3600 / 60);
+    int segs = (int)(segundos % 60);
+    if (dias > 0) {
+        snprintf(destino, tamanho, "%lldd %02d:%02d:%02d", dias, horas, minutos, segs);
+    } else {
+        snprintf(destino, tamanho, "%02d:%02d:%02d", horas, minutos, segs);
+    }
+    return destino;
+}
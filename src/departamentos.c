@@ -6,49 +6,37 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include "../include/departamentos.h"
 #include "../include/input.h"
 #include "../include/logs.h"
+#include "../include/snapshot.h"
+#include "../include/journal.h"
 #include <string.h>
 
 #define CRESCIMENTO_5 5
 
 /**
- * @brief Identifica o maior ID de departamento presente no sistema.
+ * @brief Função que devolve o maior ID já atribuído a um departamento.
  * @param departamentos Estrutura que contém a lista de departamentos e contador.
- * @return Retorna o valor do maior ID encontrado, ou 0 se não houverem departamentos.
+ * @return Retorna o último ID atribuído (lido do contador proximoID), ou 0 se ainda não foi atribuído nenhum.
  */
 int obterMaiorIDDepartamento(Departamentos departamentos) {
-    int maxID = 0;
-    for (int i = 0; i < departamentos.contador; i++) {
-        if (departamentos.departamento[i].idDepartamento > maxID) {
-            maxID = departamentos.departamento[i].idDepartamento;
-        }
-    }
-    return maxID;
+    return departamentos.proximoID > 0 ? departamentos.proximoID - 1 : 0;
 }
 
 /**
- * @brief Gera um ID único e sequencial para um novo registo.
- * @details Percorre o array de ordens (ou técnicos/ativos) para encontrar o maior ID 
- * atual e incrementa 1. Garante que, mesmo após carregar dados de um ficheiro, 
- * os IDs continuem a sequência correta.
- * @param departamentos Apontador para a estrutura que contém o array e contador
- * @return Retorna o id do departamento que está a ser criado
+ * @brief Gera um ID único e sequencial para um novo departamento.
+ * @details Usa o contador proximoID, que é guardado no snapshot e no journal, pelo que a atribuição é O(1)
+ * e um ID nunca é reutilizado, mesmo depois de o programa ser reiniciado.
+ * @param departamentos Apontador para a estrutura que contém a lista de departamentos.
+ * @return Retorna o ID atribuído (o primeiro é PRIMEIRO_ID).
  */
 static int gerarProximoID(Departamentos *departamentos) {
-    if (departamentos->contador == 0) {
-        return 10;
-    }
-
-    int maxID = 0;
-    for (int i = 0; i < departamentos->contador; i++) {
-        if (departamentos->departamento[i].idDepartamento > maxID) {
-            maxID = departamentos->departamento[i].idDepartamento;
-        }
+    if (departamentos->proximoID < PRIMEIRO_ID) {
+        departamentos->proximoID = PRIMEIRO_ID;
     }
-
-    return maxID + 1;
+    return departamentos->proximoID++;
 }
 
 /**
@@ -127,12 +115,22 @@ char *passar_int_string (Atividade atividade) {
  * @return Retorna o indíce do departamento no array, ou -1 caso não seja encontrado.
  */
 int procurarIdDepartamento (Departamentos departamentos, int idPretendido) {
-    for (int i = 0; i < departamentos.contador; i++) {
-        if (departamentos.departamento[i].idDepartamento == idPretendido) {
-            return i;
+    return procurarIndice(&departamentos.indice, idPretendido);
+}
+
+/**
+ * @brief Reconstrói o índice de IDs a partir do array de departamentos.
+ * @details Garante também que proximoID é maior do que todos os IDs carregados (ficheiros antigos não o guardam).
+ * @param departamentos Apontador para a estrutura que contém a lista de departamentos.
+ */
+static void indexarDepartamentos(Departamentos *departamentos) {
+    if (!limparIndice(&departamentos->indice, departamentos->contador)) return;
+    for (int i = 0; i < departamentos->contador; i++) {
+        inserirIndice(&departamentos->indice, departamentos->departamento[i].idDepartamento, i);
+        if (departamentos->departamento[i].idDepartamento >= departamentos->proximoID) {
+            departamentos->proximoID = departamentos->departamento[i].idDepartamento + 1;
         }
     }
-    return -1;
 }
 
 /**
@@ -242,25 +240,27 @@ void criarDepartamento (Departamentos *departamentos) {
     int validar;
 
     int idx = departamentos->contador;
+    int novoID = gerarProximoID(departamentos);
     departamentos->contador++;
 
     do {
-        departamentos->departamento[idx].nomeDepartamento = lerStringDinamica("Indique o nome do departamento:\n");
+        departamentos->departamento[idx].nomeDepartamento = lerStringPool(&departamentos->strings, "Indique o nome do departamento:\n");
         validar = validar_nome_departamento(*departamentos);
     } while (validar == 0);
 
-    departamentos->departamento[idx].responsavel = lerStringDinamica("Indique o nome do responsável do departamento: \n");
+    departamentos->departamento[idx].responsavel = lerStringPool(&departamentos->strings, "Indique o nome do responsável do departamento: \n");
     escolha = obterIntIntervalado(1,2,"Deseja colocar como contacto um número de telemóvel ou um email? (1) Número de telemóvel (2) Email\n");
     switch (escolha) {
         case 1:
-            departamentos->departamento[idx].contacto = obterNumeroTelemovel();
+            departamentos->departamento[idx].contacto = internarStringLida(&departamentos->strings, obterNumeroTelemovel());
             if (departamentos->departamento[idx].contacto == NULL) {
                 registar_log("Erro: Não foi possível obter contacto (malloc falhou) ao criar departamento.");
             }
             pausar_ecra();
             break;
         case 2:
-            departamentos->departamento[idx].contacto = obterEmail("Indique o email que deseja associar ao departamento\n");
+            departamentos->departamento[idx].contacto = internarStringLida(&departamentos->strings,
+                                                                           obterEmail("Indique o email que deseja associar ao departamento\n"));
             if (departamentos->departamento[idx].contacto == NULL) {
                 registar_log("Erro: Não foi possível obter email (malloc falhou) ao criar departamento.");
             }
@@ -274,8 +274,10 @@ void criarDepartamento (Departamentos *departamentos) {
     }
 
     departamentos->departamento[idx].atividade = ATIVO;
-    departamentos->departamento[idx].idDepartamento = gerarProximoID(departamentos);
+    departamentos->departamento[idx].idDepartamento = novoID;
+    inserirIndice(&departamentos->indice, departamentos->departamento[idx].idDepartamento, idx);
     departamentos->departamentosAtivos++;
+    journalDepartamento(departamentos, idx);
 
     registar_log("Info: Foi criado um novo departamento.");
 }
@@ -345,27 +347,26 @@ void atualizar_departamento(Departamentos *departamentos) {
     switch (escolha) {
         case 1:
             do {
-                free(departamentos->departamento[idProcurado].nomeDepartamento);
-                departamentos->departamento[idProcurado].nomeDepartamento = lerStringDinamica("Indique o novo nome do departamento:\n");
+                departamentos->departamento[idProcurado].nomeDepartamento = lerStringPool(&departamentos->strings, "Indique o novo nome do departamento:\n");
                 validar = validar_nome_departamento(*departamentos);
             }while (validar == 0);
             pausar_ecra();
             break;
         case 2:
-            free(departamentos->departamento[idProcurado].responsavel);
-            departamentos->departamento[idProcurado].responsavel = lerStringDinamica("Indique o nome do novo responsavel do departamento:\n");
+            departamentos->departamento[idProcurado].responsavel = lerStringPool(&departamentos->strings, "Indique o nome do novo responsavel do departamento:\n");
             pausar_ecra();
             break;
         case 3:
-            free(departamentos->departamento[idProcurado].contacto);
+            departamentos->departamento[idProcurado].contacto = NULL;
             escolha1 = obterIntIntervalado(1,2,"Deseja colocar como contacto um n\\u00famero de telem\\u00f3vel ou um email? (1) N\\u00famero de telem\\u00f3vel (2) Email\\n");
             switch (escolha1) {
                 case 1:
-                    departamentos->departamento[idProcurado].contacto = obterNumeroTelemovel();
+                    departamentos->departamento[idProcurado].contacto = internarStringLida(&departamentos->strings, obterNumeroTelemovel());
                     pausar_ecra();
                     break;
                 case 2:
-                    departamentos->departamento[idProcurado].contacto = obterEmail("Indique o email que deseja associar ao departamento\\n");
+                    departamentos->departamento[idProcurado].contacto = internarStringLida(&departamentos->strings,
+                                                                                   obterEmail("Indique o email que deseja associar ao departamento\\n"));
                     pausar_ecra();
                     break;
                 default:
@@ -381,6 +382,7 @@ void atualizar_departamento(Departamentos *departamentos) {
             pausar_ecra();
             break;
     }
+    journalDepartamento(departamentos, idProcurado);
 }
 
 /**
@@ -433,68 +435,209 @@ void inativar_Departamento (Departamentos *departamentos) {
     if (departamentos->departamentosAtivos > 0) {
         departamentos->departamentosAtivos--;
     }
+    journalDepartamento(departamentos, idProcurado);
 
     puts("O departamento foi inativado com sucesso.");
     registar_log("Info: Um departamento foi inativado.");
     pausar_ecra();
 }
 
+/**
+ * @brief Registo de tamanho fixo de um departamento tal como é guardado no snapshot.
+ * @note As strings são guardadas no heap de strings (secção 1) e aqui fica apenas o seu offset.
+ */
+typedef struct {
+    int32_t idDepartamento;
+    int32_t atividade;
+    uint32_t nomeDepartamento;
+    uint32_t responsavel;
+    uint32_t contacto;
+} DepartamentoDisco;
+
 /**
  * @brief Guarda todos os dados dos departamentos num ficheiro binário.
- * @details Serializa a estrutura para o disco, gravando primeiro o contador total e,
- * em seguida, os dados de cada departamento. Utiliza escreverStringBinario() para
- * lidar com os campos de texto dinâmicos.
+ * @details Tal como em ativos.bin, o ficheiro tem um CabecalhoSnapshot (com o contador de departamentos
+ * ativos e o próximo ID a atribuir), o array de registos DepartamentoDisco e o heap com as strings.
  * @param departamentos Apontador para a estrutura que contém os dados a persistir.
- * @note Implementa um formato de armazenamento híbrido: utiliza campos de tamanho fixo para metadados
- * (ID e estado) e delega a escrita de campos de tamanho variável à função auxiliar escreverStringBinario().
+ * @return 1 se o ficheiro foi gravado com sucesso, caso contrário 0.
  */
-void guardarDepartamentos (Departamentos *departamentos) {
-    FILE *fp = fopen("departamentos.bin", "wb");
+int guardarDepartamentos (Departamentos *departamentos) {
+    DepartamentoDisco *registos = NULL;
+    HeapStrings heap = {0};
+
+    if (departamentos->contador > 0) {
+        registos = malloc((size_t)departamentos->contador * sizeof(DepartamentoDisco));
+        if (registos == NULL) {
+            printf("Erro: sem memória para guardar departamentos.\n");
+            registar_log("Erro: Falha ao alocar memória para serializar departamentos.");
+            return 0;
+        }
+    }
+
+    deduplicarHeapStrings(&heap, &departamentos->strings);
+    for (int i = 0; i < departamentos->contador; i++) {
+        Departamento *d = &departamentos->departamento[i];
+        registos[i].idDepartamento = d->idDepartamento;
+        registos[i].atividade = d->atividade;
+        registos[i].nomeDepartamento = adicionarStringHeap(&heap, d->nomeDepartamento);
+        registos[i].responsavel = adicionarStringHeap(&heap, d->responsavel);
+        registos[i].contacto = adicionarStringHeap(&heap, d->contacto);
+    }
+
+    FILE *fp = abrirSnapshotEscrita("departamentos.bin");
     if  (fp == NULL) {
         printf("Erro ao criar o ficheiro de departamentos!\n");
         registar_log("Erro: Não foi possível abrir departamentos.bin para escrita.");
-        return;
+        free(registos);
+        libertarHeapStrings(&heap);
+        return 0;
     }
-    fwrite(&departamentos->contador, sizeof(int), 1, fp);
-
-    for (int i = 0; i < departamentos->contador; i++) {
-        fwrite(&departamentos->departamento[i].idDepartamento, sizeof(int), 1, fp);
-        fwrite(&departamentos->departamento[i].atividade, sizeof(int), 1, fp);
 
-        escreverStringBinario(departamentos->departamento[i].nomeDepartamento, fp);
-        escreverStringBinario(departamentos->departamento[i].responsavel, fp);
-        escreverStringBinario(departamentos->departamento[i].contacto, fp);
+    CabecalhoSnapshot cab;
+    inicializarCabecalhoSnapshot(&cab, departamentos->contador, departamentos->departamentosAtivos, sizeof(DepartamentoDisco));
+    cab.proximoID = departamentos->proximoID;
+    cab.numSeccoes = 2;
+    cab.seccoes[0].tamanho = (uint64_t)departamentos->contador * sizeof(DepartamentoDisco);
+    cab.seccoes[1].tamanho = heap.tamanho;
+    const void *blocos[] = { registos, heap.dados };
+
+    int sucesso = escreverSnapshot(fp, &cab, blocos);
+    if (!fecharSnapshotEscrita(fp, "departamentos.bin", sucesso)) {
+        printf("Erro ao gravar o ficheiro de departamentos!\n");
+        registar_log("Erro: Falha ao escrever departamentos.bin.");
+        sucesso = 0;
     }
+
+    free(registos);
+    libertarHeapStrings(&heap);
+    return sucesso;
 }
 
 /**
- * @brief Recupera os dados dos departamentos a partir de um ficheiro binário.
- * @details Lê o contador de registos e aloca, ajusta a capacidade e aloca o array principal na heap (para evitar memory leaks),
- * reconstroi as strings dinâmicas (nome, responsável, contacto) utilizando a função lerStringBinário().
+ * @brief Recupera os departamentos a partir do formato antigo (sem cabeçalho, um fread por campo).
  * @param departamentos Apontador para a estrutura onde os dados lidos serão carregados.
- * @note Se o ficheiro não existir (Por exemplo numa primeira utilização do programa), a função termina silenciosamente.
- * @warning A função usa várias alocações de memória dinâmica (malloc), pelo que é essencial que a memória seja libertada no final.
+ * @param fp Ficheiro aberto e posicionado no início.
+ * @note O formato antigo não guardava o contador de departamentos ativos, pelo que é recalculado.
  */
-void carregarDepartamentos(Departamentos *departamentos) {
-    FILE *fp = fopen("departamentos.bin", "rb");
-    if (fp == NULL) return;
-
+static void carregarDepartamentosLegado(Departamentos *departamentos, FILE *fp) {
     fread(&departamentos->contador, sizeof(int), 1, fp);
     departamentos->capacidade = departamentos->contador;
 
     departamentos->departamento = malloc(departamentos->capacidade * sizeof(Departamento));
     if (departamentos->departamento == NULL && departamentos->contador > 0) {
         registar_log("Erro: Falha ao alocar memória ao carregar departamentos (malloc devolveu NULL).");
-        fclose(fp);
+        departamentos->contador = 0;
+        departamentos->capacidade = 0;
         return;
     }
 
+    departamentos->departamentosAtivos = 0;
     for (int i = 0; i < departamentos->contador; i++) {
         fread(&departamentos->departamento[i].idDepartamento, sizeof(int), 1, fp);
         fread(&departamentos->departamento[i].atividade, sizeof(int), 1, fp);
-        departamentos->departamento[i].nomeDepartamento = lerStringBinario(fp);
-        departamentos->departamento[i].responsavel = lerStringBinario(fp);
-        departamentos->departamento[i].contacto = lerStringBinario(fp);
+        departamentos->departamento[i].nomeDepartamento = lerStringBinario(fp, &departamentos->strings);
+        departamentos->departamento[i].responsavel = lerStringBinario(fp, &departamentos->strings);
+        departamentos->departamento[i].contacto = lerStringBinario(fp, &departamentos->strings);
+        if (departamentos->departamento[i].atividade == ATIVO) {
+            departamentos->departamentosAtivos++;
+        }
+    }
+}
+
+/**
+ * @brief Recupera os departamentos a partir de um snapshot (registos e heap lidos com uma leitura cada).
+ * @param departamentos Apontador para a estrutura onde os dados lidos serão carregados.
+ * @param fp Ficheiro posicionado depois do cabeçalho.
+ * @param cab Cabeçalho já lido.
+ */
+static void carregarDepartamentosSnapshot(Departamentos *departamentos, FILE *fp, const CabecalhoSnapshot *cab) {
+    if (cab->numSeccoes < 2 || cab->tamanhoRegisto != sizeof(DepartamentoDisco) ||
+        cab->seccoes[0].tamanho != (uint64_t)cab->contador * sizeof(DepartamentoDisco)) {
+        registar_log("Erro: departamentos.bin tem um formato/versão não suportado.");
+        return;
+    }
+
+    DepartamentoDisco *registos = malloc((size_t)cab->seccoes[0].tamanho + 1);
+    char *heap = malloc((size_t)cab->seccoes[1].tamanho + 1);
+    departamentos->departamento = malloc(((size_t)cab->contador + 1) * sizeof(Departamento));
+
+    if (registos == NULL || heap == NULL || departamentos->departamento == NULL ||
+        !lerSeccaoSnapshot(fp, cab, 0, registos) || !lerSeccaoSnapshot(fp, cab, 1, heap)) {
+        registar_log("Erro: Não foi possível ler departamentos.bin (memória insuficiente ou ficheiro corrompido).");
+        free(registos);
+        free(heap);
+        free(departamentos->departamento);
+        departamentos->departamento = NULL;
+        return;
+    }
+
+    size_t tamanhoHeap = (size_t)cab->seccoes[1].tamanho;
+    for (int i = 0; i < cab->contador; i++) {
+        Departamento *d = &departamentos->departamento[i];
+        d->idDepartamento = registos[i].idDepartamento;
+        d->atividade = registos[i].atividade;
+        d->nomeDepartamento = internarStringPool(&departamentos->strings, stringHeap(heap, tamanhoHeap, registos[i].nomeDepartamento));
+        d->responsavel = internarStringPool(&departamentos->strings, stringHeap(heap, tamanhoHeap, registos[i].responsavel));
+        d->contacto = internarStringPool(&departamentos->strings, stringHeap(heap, tamanhoHeap, registos[i].contacto));
+    }
+
+    departamentos->contador = cab->contador;
+    departamentos->departamentosAtivos = cab->contadorAuxiliar;
+    departamentos->capacidade = cab->contador;
+    if (cab->proximoID > departamentos->proximoID) {
+        departamentos->proximoID = cab->proximoID;
+    }
+
+    free(registos);
+    free(heap);
+}
+
+/**
+ * @brief Recupera os dados dos departamentos a partir de um ficheiro binário.
+ * @details Ficheiros com cabeçalho são lidos como snapshot; ficheiros sem cabeçalho são entregues
+ * ao leitor do formato antigo. No fim é reconstruído o índice de IDs.
+ * @param departamentos Apontador para a estrutura onde os dados lidos serão carregados.
+ * @note Se o ficheiro não existir (Por exemplo numa primeira utilização do programa), a função termina silenciosamente.
+ * @warning A função usa várias alocações de memória dinâmica (malloc), pelo que é essencial que a memória seja libertada no final.
+ */
+void carregarDepartamentos(Departamentos *departamentos) {
+    FILE *fp = fopen("departamentos.bin", "rb");
+    if (fp == NULL) return;
+
+    CabecalhoSnapshot cab;
+    if (lerCabecalhoSnapshot(fp, &cab)) {
+        carregarDepartamentosSnapshot(departamentos, fp, &cab);
+    } else {
+        carregarDepartamentosLegado(departamentos, fp);
     }
     fclose(fp);
-}
\ No newline at end of file
+    indexarDepartamentos(departamentos);
+}
+
+/**
+ * @brief Repõe um departamento registado no journal (cria-o ou substitui o existente com o mesmo ID).
+ * @param departamentos Apontador para a estrutura que contém a lista de departamentos.
+ * @param departamento Departamento lido do journal (as strings são copiadas para departamentos->strings).
+ * @param departamentosAtivos Contador de departamentos ativos no momento do registo.
+ * @param proximoID Próximo ID a atribuir no momento do registo.
+ */
+void reporDepartamento(Departamentos *departamentos, const Departamento *departamento, int departamentosAtivos, int proximoID) {
+    int idx = procurarIdDepartamento(*departamentos, departamento->idDepartamento);
+
+    if (idx == -1) {
+        if (!garantir_capacidade_departamentos(departamentos, departamentos->contador + 1)) return;
+        idx = departamentos->contador++;
+        inserirIndice(&departamentos->indice, departamento->idDepartamento, idx);
+    }
+    departamentos->departamento[idx] = *departamento;
+    departamentos->departamento[idx].nomeDepartamento = internarStringPool(&departamentos->strings, departamento->nomeDepartamento);
+    departamentos->departamento[idx].responsavel = internarStringPool(&departamentos->strings, departamento->responsavel);
+    departamentos->departamento[idx].contacto = internarStringPool(&departamentos->strings, departamento->contacto);
+    departamentos->departamentosAtivos = departamentosAtivos;
+    if (proximoID > departamentos->proximoID) {
+        departamentos->proximoID = proximoID;
+    }
+    if (departamento->idDepartamento >= departamentos->proximoID) {
+        departamentos->proximoID = departamento->idDepartamento + 1;
+    }
+}
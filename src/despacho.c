@@ -0,0 +1,203 @@
+/**
+ * @file despacho.c
+ * @brief Ficheiro com a distribuição automática das ordens pendentes pelos técnicos.
+ * @details Os técnicos disponíveis são colocados num min-heap por especialidade, ordenado pela carga
+ * (ordens em execução). As ordens pendentes vêm da fila de pendentes, já por prioridade e antiguidade; cada uma
+ * retira o técnico menos ocupado do heap adequado e, se o técnico ainda estiver abaixo do limite, volta a
+ * inseri-lo com a nova carga. Custo O(P log P + P log T).
+ * @author Francisco Alves
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/despacho.h"
+#include "../include/ordem.h"
+#include "../include/tecnicos.h"
+#include "../include/ativos.h"
+#include "../include/logs.h"
+
+/**
+ * @brief Técnico guardado num heap de carga.
+ */
+typedef struct {
+    int carga;       /**< Ordens em execução do técnico */
+    int idxTecnico;  /**< Posição do técnico no array */
+}CargaTecnico;
+
+/**
+ * @brief Min-heap de técnicos ordenado pela carga.
+ */
+typedef struct {
+    CargaTecnico *entradas; /**< Entradas do heap (fatia de um array partilhado por todas as especialidades) */
+    int tamanho;            /**< Número de entradas */
+}HeapCarga;
+
+/**
+ * @brief Devolve a especialidade de técnico adequada a uma categoria de ativo.
+ * @param categoria Categoria do ativo.
+ * @return Especialidade preferida (MANUTENCAO_GERAL para categorias sem especialidade própria).
+ */
+Especialidade especialidadeParaCategoria(CategoriaAtivo categoria) {
+    switch (categoria) {
+        case VIATURA:
+            return MECANICO;
+        case INFORMATICA:
+            return TECNICO_TI;
+        case FERRAMENTA:
+            return ELETRICISTA;
+        case MOBILIARIO:
+        case OUTRO:
+        default:
+            return MANUTENCAO_GERAL;
+    }
+}
+
+/**
+ * @brief Indica se a entrada a deve sair do heap antes da entrada b (menor carga; em empate, o técnico mais antigo).
+ * @param a Primeira entrada.
+ * @param b Segunda entrada.
+ * @return 1 se a tiver prioridade, caso contrário 0.
+ */
+static int antesNoHeap(const CargaTecnico *a, const CargaTecnico *b) {
+    if (a->carga != b->carga) return a->carga < b->carga;
+    return a->idxTecnico < b->idxTecnico;
+}
+
+/**
+ * @brief Insere um técnico no heap.
+ * @param heap Apontador para o heap (com espaço para mais uma entrada).
+ * @param entrada Entrada a inserir.
+ */
+static void inserirHeapCarga(HeapCarga *heap, CargaTecnico entrada) {
+    int i = heap->tamanho++;
+    while (i > 0) {
+        int pai = (i - 1) / 2;
+        if (!antesNoHeap(&entrada, &heap->entradas[pai])) break;
+        heap->entradas[i] = heap->entradas[pai];
+        i = pai;
+    }
+    heap->entradas[i] = entrada;
+}
+
+/**
+ * @brief Retira o técnico menos ocupado do heap.
+ * @param heap Apontador para o heap (não vazio).
+ * @return Entrada retirada.
+ */
+static CargaTecnico retirarHeapCarga(HeapCarga *heap) {
+    CargaTecnico topo = heap->entradas[0];
+    CargaTecnico ultimo = heap->entradas[--heap->tamanho];
+    int i = 0;
+
+    while (1) {
+        int filho = 2 * i + 1;
+        if (filho >= heap->tamanho) break;
+        if (filho + 1 < heap->tamanho && antesNoHeap(&heap->entradas[filho + 1], &heap->entradas[filho])) {
+            filho++;
+        }
+        if (!antesNoHeap(&heap->entradas[filho], &ultimo)) break;
+        heap->entradas[i] = heap->entradas[filho];
+        i = filho;
+    }
+    if (heap->tamanho > 0) {
+        heap->entradas[i] = ultimo;
+    }
+    return topo;
+}
+
+/**
+ * @brief Atribui automaticamente as ordens pendentes aos técnicos disponíveis e inicia a sua execução.
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param tecnicos Apontador para a estrutura de técnicos.
+ * @param ativos Apontador para a estrutura de ativos.
+ * @return Número de ordens atribuídas.
+ * @note As ordens passam a EXECUCAO sem materiais; os técnicos inativos ou com LIMITE_ORDENS_TECNICO ordens
+ * em execução não recebem ordens.
+ */
+int despacharOrdensPendentes(Ordens *ordens, Tecnicos *tecnicos, Ativos *ativos) {
+    printf("\n===== DISTRIBUIÇÃO AUTOMÁTICA DE ORDENS =====\n");
+
+    int totalPendentes = ordens->pendentes.tamanho;
+    if (totalPendentes == 0) {
+        printf("Não existem ordens pendentes.\n");
+        return 0;
+    }
+
+    int *pendentes = malloc((size_t)totalPendentes * sizeof(int));
+    CargaTecnico *entradas = malloc(((size_t)tecnicos->contador + 1) * sizeof(CargaTecnico));
+    if (pendentes == NULL || entradas == NULL) {
+        printf("Erro: sem memória para distribuir as ordens.\n");
+        registar_log("Erro: Falha ao alocar memória para a distribuição automática de ordens.");
+        free(pendentes);
+        free(entradas);
+        return 0;
+    }
+
+    /* Cada técnico disponível fica no heap da sua especialidade; os heaps partilham o array entradas. */
+    HeapCarga heaps[OUTROS + 1];
+    int porEspecialidade[OUTROS + 1] = {0};
+    for (int i = 0; i < tecnicos->contador; i++) {
+        Especialidade esp = tecnicos->tecnico[i].especialidade;
+        if (esp >= TECNICO_TI && esp <= OUTROS) porEspecialidade[esp]++;
+    }
+    int inicio = 0;
+    for (int esp = 0; esp <= OUTROS; esp++) {
+        heaps[esp].entradas = entradas + inicio;
+        heaps[esp].tamanho = 0;
+        inicio += porEspecialidade[esp];
+    }
+    for (int i = 0; i < tecnicos->contador; i++) {
+        const Tecnico *tecnico = &tecnicos->tecnico[i];
+        if (tecnico->especialidade < TECNICO_TI || tecnico->especialidade > OUTROS) continue;
+        if (tecnico->estado_tecnico == INATIVO1 || tecnico->ordensEmExecucao >= LIMITE_ORDENS_TECNICO) continue;
+        CargaTecnico entrada = { tecnico->ordensEmExecucao, i };
+        inserirHeapCarga(&heaps[tecnico->especialidade], entrada);
+    }
+
+    /* Cópia ordenada da fila: iniciarExecucaoOrdem() retira cada ordem da fila durante o ciclo. */
+    int n = ordenarFila(&ordens->pendentes, pendentes);
+    if (n == -1) {
+        printf("Erro: sem memória para distribuir as ordens.\n");
+        free(pendentes);
+        free(entradas);
+        return 0;
+    }
+
+    int atribuidas = 0;
+    for (int k = 0; k < n; k++) {
+        int idxOrdem = pendentes[k];
+        int idxAtivo = procurarIndice(&ativos->indice, ordens->ordem[idxOrdem].idAtivo);
+        CategoriaAtivo categoria = (idxAtivo != -1) ? ativos->ativo[idxAtivo].categoria : OUTRO;
+
+        HeapCarga *heap = &heaps[especialidadeParaCategoria(categoria)];
+        if (heap->tamanho == 0) {
+            heap = &heaps[MANUTENCAO_GERAL];
+        }
+        if (heap->tamanho == 0) {
+            continue;
+        }
+
+        CargaTecnico escolhido = retirarHeapCarga(heap);
+        const Tecnico *tecnico = &tecnicos->tecnico[escolhido.idxTecnico];
+        iniciarExecucaoOrdem(ordens, tecnicos, ativos, idxOrdem, tecnico->idTecnico);
+        printf("Ordem %d -> Técnico %d (%s, %s)\n", ordens->ordem[idxOrdem].idOrdem, tecnico->idTecnico,
+               tecnico->nome, passar_int_string_especialidade(tecnico->especialidade));
+        atribuidas++;
+
+        escolhido.carga = tecnico->ordensEmExecucao;
+        if (escolhido.carga < LIMITE_ORDENS_TECNICO) {
+            inserirHeapCarga(heap, escolhido);
+        }
+    }
+
+    printf("Ordens atribuídas: %d | Ordens que continuam pendentes: %d\n", atribuidas, n - atribuidas);
+    if (atribuidas > 0) {
+        char mensagem[120];
+        snprintf(mensagem, sizeof(mensagem), "Info: A distribuição automática iniciou %d manutenções.", atribuidas);
+        registar_log(mensagem);
+    }
+
+    free(pendentes);
+    free(entradas);
+    return atribuidas;
+}
@@ -0,0 +1,264 @@
+/**
+ * @file dicionario.c
+ * @brief Ficheiro com o dicionário de strings usado para agrupar registos por texto (ex.: localização).
+ * @details Tabela de endereçamento aberto com sondagem linear, tal como o índice de IDs, mas com chaves
+ * do tipo string (hash FNV-1a). Cada string diferente recebe um ID sequencial, o que permite guardar
+ * os valores agregados num array normal indexado pelo ID.
+ * O pool de strings junta ao dicionário uma arena de blocos: cada string diferente é copiada uma vez,
+ * precedida pelo seu ID, e todas são libertadas em conjunto.
+ * @author Francisco Alves
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "../include/dicionario.h"
+#include "../include/logs.h"
+
+#define DICIONARIO_CAPACIDADE_INICIAL 16
+
+/**
+ * @brief Calcula o hash FNV-1a de uma string.
+ * @param str String terminada em '\0'.
+ * @return Hash de 32 bits.
+ */
+static uint32_t hashString(const char *str) {
+    uint32_t h = 2166136261u;
+    for (const unsigned char *p = (const unsigned char *)str; *p != '\0'; p++) {
+        h ^= *p;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/**
+ * @brief Inicializa um dicionário vazio (não aloca memória).
+ * @param dicionario Apontador para o dicionário.
+ */
+void inicializarDicionario(DicionarioStrings *dicionario) {
+    dicionario->chaves = NULL;
+    dicionario->hashes = NULL;
+    dicionario->contador = 0;
+    dicionario->capacidadeChaves = 0;
+    dicionario->tabela = NULL;
+    dicionario->capacidade = 0;
+}
+
+/**
+ * @brief Procura a posição da tabela onde está (ou deveria estar) uma string.
+ * @param dicionario Apontador para o dicionário (com a tabela alocada).
+ * @param str String a procurar.
+ * @param h Hash da string.
+ * @return Posição da tabela com o ID da string ou a primeira posição livre.
+ */
+static int posicaoTabela(const DicionarioStrings *dicionario, const char *str, uint32_t h) {
+    int mascara = dicionario->capacidade - 1;
+    int i = (int)(h & (uint32_t)mascara);
+
+    while (dicionario->tabela[i] != -1) {
+        int id = dicionario->tabela[i];
+        if (dicionario->hashes[id] == h && strcmp(dicionario->chaves[id], str) == 0) {
+            return i;
+        }
+        i = (i + 1) & mascara;
+    }
+    return i;
+}
+
+/**
+ * @brief Garante espaço para mais uma string (arrays de IDs e tabela com ocupação máxima de 50%).
+ * @param dicionario Apontador para o dicionário.
+ * @return 1 em caso de sucesso, 0 se a alocação falhar.
+ */
+static int garantirCapacidadeDicionario(DicionarioStrings *dicionario) {
+    if (dicionario->contador >= dicionario->capacidadeChaves) {
+        int novaCap = dicionario->capacidadeChaves > 0 ? dicionario->capacidadeChaves * 2 : DICIONARIO_CAPACIDADE_INICIAL;
+        const char **chaves = realloc(dicionario->chaves, (size_t)novaCap * sizeof(*chaves));
+        if (chaves == NULL) {
+            registar_log("Erro: Falha ao expandir o dicionário de strings.");
+            return 0;
+        }
+        dicionario->chaves = chaves;
+        uint32_t *hashes = realloc(dicionario->hashes, (size_t)novaCap * sizeof(*hashes));
+        if (hashes == NULL) {
+            registar_log("Erro: Falha ao expandir o dicionário de strings.");
+            return 0;
+        }
+        dicionario->hashes = hashes;
+        dicionario->capacidadeChaves = novaCap;
+    }
+
+    if (dicionario->capacidade > 0 && (dicionario->contador + 1) * 2 <= dicionario->capacidade) return 1;
+
+    int novaCap = dicionario->capacidade > 0 ? dicionario->capacidade * 2 : DICIONARIO_CAPACIDADE_INICIAL;
+    int *tabela = malloc((size_t)novaCap * sizeof(int));
+    if (tabela == NULL) {
+        registar_log("Erro: Falha ao expandir a tabela do dicionário de strings.");
+        return 0;
+    }
+    for (int i = 0; i < novaCap; i++) {
+        tabela[i] = -1;
+    }
+    free(dicionario->tabela);
+    dicionario->tabela = tabela;
+    dicionario->capacidade = novaCap;
+
+    int mascara = novaCap - 1;
+    for (int id = 0; id < dicionario->contador; id++) {
+        int i = (int)(dicionario->hashes[id] & (uint32_t)mascara);
+        while (tabela[i] != -1) {
+            i = (i + 1) & mascara;
+        }
+        tabela[i] = id;
+    }
+    return 1;
+}
+
+/**
+ * @brief Devolve o ID de uma string, acrescentando-a ao dicionário se ainda não existir.
+ * @param dicionario Apontador para o dicionário.
+ * @param str String a procurar (não é copiada).
+ * @return ID da string ou -1 se não houver memória.
+ */
+int internarString(DicionarioStrings *dicionario, const char *str) {
+    uint32_t h = hashString(str);
+
+    if (dicionario->capacidade > 0) {
+        int i = posicaoTabela(dicionario, str, h);
+        if (dicionario->tabela[i] != -1) {
+            return dicionario->tabela[i];
+        }
+    }
+
+    if (!garantirCapacidadeDicionario(dicionario)) return -1;
+
+    int id = dicionario->contador++;
+    dicionario->chaves[id] = str;
+    dicionario->hashes[id] = h;
+    dicionario->tabela[posicaoTabela(dicionario, str, h)] = id;
+    return id;
+}
+
+/**
+ * @brief Procura o ID de uma string sem a acrescentar.
+ * @param dicionario Apontador para o dicionário.
+ * @param str String a procurar.
+ * @return ID da string ou -1 se não existir.
+ */
+int procurarDicionario(const DicionarioStrings *dicionario, const char *str) {
+    if (dicionario->capacidade == 0) return -1;
+    return dicionario->tabela[posicaoTabela(dicionario, str, hashString(str))];
+}
+
+/**
+ * @brief Liberta a memória do dicionário (as strings não são libertadas).
+ * @param dicionario Apontador para o dicionário.
+ */
+void libertarDicionario(DicionarioStrings *dicionario) {
+    free(dicionario->chaves);
+    free(dicionario->hashes);
+    free(dicionario->tabela);
+    inicializarDicionario(dicionario);
+}
+
+/**
+ * @brief Inicializa um pool vazio (não aloca memória).
+ * @param pool Apontador para o pool.
+ */
+void inicializarPoolStrings(PoolStrings *pool) {
+    inicializarDicionario(&pool->dicionario);
+    pool->blocos = NULL;
+}
+
+/**
+ * @brief Reserva espaço na arena para uma entrada, alocando um bloco novo se o atual não chegar.
+ * @param pool Apontador para o pool.
+ * @param tamanho Bytes da string (com o '\0').
+ * @return Apontador para o espaço reservado (ainda não contado em usado) ou NULL se a alocação falhar.
+ */
+static char *reservarPool(PoolStrings *pool, size_t tamanho) {
+    BlocoPool *bloco = pool->blocos;
+    if (bloco != NULL && bloco->usado + tamanho <= bloco->capacidade) {
+        return bloco->dados + bloco->usado;
+    }
+
+    size_t capacidade = tamanho > POOL_TAMANHO_BLOCO ? tamanho : POOL_TAMANHO_BLOCO;
+    BlocoPool *novo = malloc(sizeof(BlocoPool) + capacidade);
+    if (novo == NULL) {
+        registar_log("Erro: Falha ao alocar um bloco do pool de strings.");
+        return NULL;
+    }
+    novo->anterior = bloco;
+    novo->usado = 0;
+    novo->capacidade = capacidade;
+    pool->blocos = novo;
+    return novo->dados;
+}
+
+/**
+ * @brief Devolve a cópia única de uma string no pool, copiando-a para a arena se ainda não existir.
+ * @param pool Apontador para o pool.
+ * @param str String a internar (pode ser NULL).
+ * @return String do pool (válida até libertarPoolStrings()) ou NULL se str for NULL ou não houver memória.
+ */
+const char *internarStringPool(PoolStrings *pool, const char *str) {
+    if (str == NULL) return NULL;
+
+    int id = procurarDicionario(&pool->dicionario, str);
+    if (id != -1) return pool->dicionario.chaves[id];
+
+    size_t len = strlen(str) + 1;
+    char *copia = reservarPool(pool, len);
+    if (copia == NULL) return NULL;
+
+    memcpy(copia, str, len);
+    if (internarString(&pool->dicionario, copia) == -1) return NULL;
+
+    pool->blocos->usado += len;
+    return copia;
+}
+
+/**
+ * @brief Devolve o ID que o pool atribuiu a uma string (ou a uma string igual).
+ * @details Procura no dicionário do pool, pelo que aceita qualquer string (não só as devolvidas por
+ * internarStringPool()). O custo é o de uma procura na tabela de hash.
+ * @param pool Apontador para o pool.
+ * @param str String a procurar (ou NULL).
+ * @return ID da string (0 a numStringsPool() - 1) ou -1 se str for NULL ou não existir no pool.
+ */
+int idStringPool(const PoolStrings *pool, const char *str) {
+    if (str == NULL) return -1;
+    return procurarDicionario(&pool->dicionario, str);
+}
+
+/**
+ * @brief Devolve a string do pool com um dado ID.
+ * @param pool Apontador para o pool.
+ * @param id ID da string (0 a numStringsPool() - 1).
+ * @return String do pool ou NULL se o ID for inválido.
+ */
+const char *stringPool(const PoolStrings *pool, int id) {
+    if (id < 0 || id >= pool->dicionario.contador) return NULL;
+    return pool->dicionario.chaves[id];
+}
+
+/**
+ * @brief Devolve o número de strings diferentes no pool (os IDs vão de 0 a este valor - 1).
+ * @param pool Apontador para o pool.
+ * @return Número de strings.
+ */
+int numStringsPool(const PoolStrings *pool) {
+    return pool->dicionario.contador;
+}
+
+/**
+ * @brief Liberta a arena e o dicionário do pool (todas as strings de uma vez).
+ * @param pool Apontador para o pool.
+ */
+void libertarPoolStrings(PoolStrings *pool) {
+    while (pool->blocos != NULL) {
+        BlocoPool *anterior = pool->blocos->anterior;
+        free(pool->blocos);
+        pool->blocos = anterior;
+    }
+    libertarDicionario(&pool->dicionario);
+}
@@ -0,0 +1,215 @@
+/**
+ * @file fila.c
+ * @brief Ficheiro com a fila de prioridade indexada (min-heap binário com a posição de cada elemento).
+ * @author Francisco Alves
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "../include/fila.h"
+#include "../include/logs.h"
+
+#define FILA_CAPACIDADE_INICIAL 16
+
+/**
+ * @brief Inicializa uma fila vazia (não aloca memória).
+ * @param fila Apontador para a fila.
+ */
+void inicializarFila(FilaPrioridade *fila) {
+    fila->heap = NULL;
+    fila->tamanho = 0;
+    fila->capacidade = 0;
+    fila->posicoes = NULL;
+    fila->capacidadePosicoes = 0;
+}
+
+/**
+ * @brief Coloca uma entrada numa posição do heap e atualiza o array de posições.
+ * @param fila Apontador para a fila.
+ * @param i Posição no heap.
+ * @param entrada Entrada a colocar.
+ */
+static void colocarEntrada(FilaPrioridade *fila, int i, EntradaFila entrada) {
+    fila->heap[i] = entrada;
+    fila->posicoes[entrada.elemento] = i;
+}
+
+/**
+ * @brief Sobe uma entrada no heap até a chave do pai ser menor ou igual.
+ * @param fila Apontador para a fila.
+ * @param i Posição inicial da entrada.
+ */
+static void subirFila(FilaPrioridade *fila, int i) {
+    EntradaFila entrada = fila->heap[i];
+    while (i > 0) {
+        int pai = (i - 1) / 2;
+        if (fila->heap[pai].chave <= entrada.chave) break;
+        colocarEntrada(fila, i, fila->heap[pai]);
+        i = pai;
+    }
+    colocarEntrada(fila, i, entrada);
+}
+
+/**
+ * @brief Desce uma entrada no heap até as chaves dos filhos serem maiores ou iguais.
+ * @param fila Apontador para a fila.
+ * @param i Posição inicial da entrada.
+ */
+static void descerFila(FilaPrioridade *fila, int i) {
+    EntradaFila entrada = fila->heap[i];
+    while (1) {
+        int filho = 2 * i + 1;
+        if (filho >= fila->tamanho) break;
+        if (filho + 1 < fila->tamanho && fila->heap[filho + 1].chave < fila->heap[filho].chave) {
+            filho++;
+        }
+        if (fila->heap[filho].chave >= entrada.chave) break;
+        colocarEntrada(fila, i, fila->heap[filho]);
+        i = filho;
+    }
+    colocarEntrada(fila, i, entrada);
+}
+
+/**
+ * @brief Garante espaço para mais uma entrada e para o elemento indicado no array de posições.
+ * @param fila Apontador para a fila.
+ * @param elemento Elemento que vai ser inserido.
+ * @return 1 em caso de sucesso, 0 se a alocação falhar.
+ */
+static int garantirCapacidadeFila(FilaPrioridade *fila, int elemento) {
+    if (fila->tamanho >= fila->capacidade) {
+        int novaCap = fila->capacidade > 0 ? fila->capacidade * 2 : FILA_CAPACIDADE_INICIAL;
+        EntradaFila *heap = realloc(fila->heap, (size_t)novaCap * sizeof(EntradaFila));
+        if (heap == NULL) {
+            registar_log("Erro: Falha ao expandir a fila de prioridade.");
+            return 0;
+        }
+        fila->heap = heap;
+        fila->capacidade = novaCap;
+    }
+
+    if (elemento >= fila->capacidadePosicoes) {
+        int novaCap = fila->capacidadePosicoes > 0 ? fila->capacidadePosicoes : FILA_CAPACIDADE_INICIAL;
+        while (novaCap <= elemento) novaCap *= 2;
+        int *posicoes = realloc(fila->posicoes, (size_t)novaCap * sizeof(int));
+        if (posicoes == NULL) {
+            registar_log("Erro: Falha ao expandir a fila de prioridade.");
+            return 0;
+        }
+        for (int i = fila->capacidadePosicoes; i < novaCap; i++) {
+            posicoes[i] = -1;
+        }
+        fila->posicoes = posicoes;
+        fila->capacidadePosicoes = novaCap;
+    }
+    return 1;
+}
+
+/**
+ * @brief Insere um elemento na fila. O(log n).
+ * @param fila Apontador para a fila.
+ * @param elemento Elemento a inserir (não pode já estar na fila).
+ * @param chave Chave do elemento.
+ * @return 1 em caso de sucesso, 0 se não houver memória ou o elemento já estiver na fila.
+ */
+int inserirFila(FilaPrioridade *fila, int elemento, int64_t chave) {
+    if (elemento < 0) return 0;
+    if (elemento < fila->capacidadePosicoes && fila->posicoes[elemento] != -1) return 0;
+    if (!garantirCapacidadeFila(fila, elemento)) return 0;
+
+    EntradaFila entrada = { chave, elemento };
+    int i = fila->tamanho++;
+    colocarEntrada(fila, i, entrada);
+    subirFila(fila, i);
+    return 1;
+}
+
+/**
+ * @brief Remove um elemento qualquer da fila. O(log n).
+ * @details A última entrada ocupa o lugar da removida e sobe ou desce conforme a chave.
+ * @param fila Apontador para a fila.
+ * @param elemento Elemento a remover.
+ * @return 1 se o elemento foi removido, 0 se não estava na fila.
+ */
+int removerFila(FilaPrioridade *fila, int elemento) {
+    if (elemento < 0 || elemento >= fila->capacidadePosicoes) return 0;
+    int i = fila->posicoes[elemento];
+    if (i == -1) return 0;
+
+    fila->posicoes[elemento] = -1;
+    fila->tamanho--;
+    if (i == fila->tamanho) return 1;
+
+    colocarEntrada(fila, i, fila->heap[fila->tamanho]);
+    if (i > 0 && fila->heap[(i - 1) / 2].chave > fila->heap[i].chave) {
+        subirFila(fila, i);
+    } else {
+        descerFila(fila, i);
+    }
+    return 1;
+}
+
+/**
+ * @brief Devolve o elemento com menor chave sem o retirar. O(1).
+ * @param fila Apontador para a fila.
+ * @return Elemento ou -1 se a fila estiver vazia.
+ */
+int topoFila(const FilaPrioridade *fila) {
+    return fila->tamanho > 0 ? fila->heap[0].elemento : -1;
+}
+
+/**
+ * @brief Compara duas entradas pela chave (para qsort).
+ * @param a Apontador para a primeira entrada.
+ * @param b Apontador para a segunda entrada.
+ * @return Valor negativo, zero ou positivo, como em qsort().
+ */
+static int compararEntradas(const void *a, const void *b) {
+    int64_t ca = ((const EntradaFila *)a)->chave;
+    int64_t cb = ((const EntradaFila *)b)->chave;
+    return (ca > cb) - (ca < cb);
+}
+
+/**
+ * @brief Copia os elementos da fila para um array, por ordem crescente de chave (a fila não é alterada).
+ * @param fila Apontador para a fila.
+ * @param destino Array com espaço para fila->tamanho elementos.
+ * @return Número de elementos copiados, ou -1 se não houver memória.
+ */
+int ordenarFila(const FilaPrioridade *fila, int *destino) {
+    if (fila->tamanho == 0) return 0;
+
+    EntradaFila *copia = malloc((size_t)fila->tamanho * sizeof(EntradaFila));
+    if (copia == NULL) {
+        registar_log("Erro: Falha ao alocar memória para ordenar a fila de prioridade.");
+        return -1;
+    }
+    memcpy(copia, fila->heap, (size_t)fila->tamanho * sizeof(EntradaFila));
+    qsort(copia, (size_t)fila->tamanho, sizeof(EntradaFila), compararEntradas);
+    for (int i = 0; i < fila->tamanho; i++) {
+        destino[i] = copia[i].elemento;
+    }
+    free(copia);
+    return fila->tamanho;
+}
+
+/**
+ * @brief Esvazia a fila, mantendo a memória alocada.
+ * @param fila Apontador para a fila.
+ */
+void limparFila(FilaPrioridade *fila) {
+    for (int i = 0; i < fila->tamanho; i++) {
+        fila->posicoes[fila->heap[i].elemento] = -1;
+    }
+    fila->tamanho = 0;
+}
+
+/**
+ * @brief Liberta a memória da fila.
+ * @param fila Apontador para a fila.
+ */
+void libertarFila(FilaPrioridade *fila) {
+    free(fila->heap);
+    free(fila->posicoes);
+    inicializarFila(fila);
+}
@@ -0,0 +1,391 @@
+/**
+ * @file filtros.c
+ * @brief Ficheiro com os mapas de seleção (bitmaps) e os filtros de igualdade sobre colunas compactas.
+ * @details Cada filtro compara um bloco de 64 elementos de uma coluna com o valor pretendido e devolve
+ * os resultados como uma palavra de 64 bits, que é intersetada com o mapa. Em x86 a comparação usa
+ * SSE2 (16 bytes de cada vez) ou, se o processador a suportar, AVX2 (32 bytes de cada vez), escolhida
+ * uma única vez em tempo de execução; nos restantes casos usa a versão escalar. Não há um ramo por
+ * elemento, e as palavras que já estão a 0 não voltam a ler a coluna.
+ * @author Francisco Alves
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "../include/filtros.h"
+#include "../include/logs.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define FILTROS_AVX2 1
+#endif
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define FILTROS_SSE2 1
+#endif
+
+/** @brief Compara um bloco de SELECAO_BITS_PALAVRA bytes com um valor. */
+typedef uint64_t (*FiltroBlocoU8)(const uint8_t *bloco, uint8_t valor);
+
+/** @brief Compara um bloco de SELECAO_BITS_PALAVRA inteiros com um valor. */
+typedef uint64_t (*FiltroBlocoI32)(const int32_t *bloco, int32_t valor);
+
+/**
+ * @brief Versão escalar do filtro de bytes.
+ * @param bloco Primeiro elemento do bloco.
+ * @param valor Valor pretendido.
+ * @return Bit i a 1 se bloco[i] == valor.
+ */
+static uint64_t blocoIgualU8Escalar(const uint8_t *bloco, uint8_t valor) {
+    uint64_t mascara = 0;
+    for (int i = 0; i < SELECAO_BITS_PALAVRA; i++) {
+        mascara |= (uint64_t)(bloco[i] == valor) << i;
+    }
+    return mascara;
+}
+
+/**
+ * @brief Versão escalar do filtro de inteiros.
+ * @param bloco Primeiro elemento do bloco.
+ * @param valor Valor pretendido.
+ * @return Bit i a 1 se bloco[i] == valor.
+ */
+static uint64_t blocoIgualI32Escalar(const int32_t *bloco, int32_t valor) {
+    uint64_t mascara = 0;
+    for (int i = 0; i < SELECAO_BITS_PALAVRA; i++) {
+        mascara |= (uint64_t)(bloco[i] == valor) << i;
+    }
+    return mascara;
+}
+
+#ifdef FILTROS_SSE2
+/**
+ * @brief Filtro de bytes com SSE2: 4 comparações de 16 bytes, cada uma reduzida a 16 bits (movemask).
+ * @param bloco Primeiro elemento do bloco.
+ * @param valor Valor pretendido.
+ * @return Bit i a 1 se bloco[i] == valor.
+ */
+static uint64_t blocoIgualU8SSE2(const uint8_t *bloco, uint8_t valor) {
+    __m128i procurado = _mm_set1_epi8((char)valor);
+    uint64_t mascara = 0;
+    for (int i = 0; i < 4; i++) {
+        __m128i dados = _mm_loadu_si128((const __m128i *)(bloco + 16 * i));
+        uint64_t bits = (uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(dados, procurado));
+        mascara |= bits << (16 * i);
+    }
+    return mascara;
+}
+
+/**
+ * @brief Filtro de inteiros com SSE2: 16 comparações de 4 inteiros, cada uma reduzida a 4 bits.
+ * @param bloco Primeiro elemento do bloco.
+ * @param valor Valor pretendido.
+ * @return Bit i a 1 se bloco[i] == valor.
+ */
+static uint64_t blocoIgualI32SSE2(const int32_t *bloco, int32_t valor) {
+    __m128i procurado = _mm_set1_epi32(valor);
+    uint64_t mascara = 0;
+    for (int i = 0; i < 16; i++) {
+        __m128i dados = _mm_loadu_si128((const __m128i *)(bloco + 4 * i));
+        uint64_t bits = (unsigned)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(dados, procurado)));
+        mascara |= bits << (4 * i);
+    }
+    return mascara;
+}
+#endif
+
+#ifdef FILTROS_AVX2
+/**
+ * @brief Filtro de bytes com AVX2: 2 comparações de 32 bytes.
+ * @param bloco Primeiro elemento do bloco.
+ * @param valor Valor pretendido.
+ * @return Bit i a 1 se bloco[i] == valor.
+ */
+__attribute__((target("avx2")))
+static uint64_t blocoIgualU8AVX2(const uint8_t *bloco, uint8_t valor) {
+    __m256i procurado = _mm256_set1_epi8((char)valor);
+    __m256i baixo = _mm256_loadu_si256((const __m256i *)bloco);
+    __m256i alto = _mm256_loadu_si256((const __m256i *)(bloco + 32));
+    uint64_t bitsBaixo = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(baixo, procurado));
+    uint64_t bitsAlto = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(alto, procurado));
+    return bitsBaixo | (bitsAlto << 32);
+}
+
+/**
+ * @brief Filtro de inteiros com AVX2: 8 comparações de 8 inteiros.
+ * @param bloco Primeiro elemento do bloco.
+ * @param valor Valor pretendido.
+ * @return Bit i a 1 se bloco[i] == valor.
+ */
+__attribute__((target("avx2")))
+static uint64_t blocoIgualI32AVX2(const int32_t *bloco, int32_t valor) {
+    __m256i procurado = _mm256_set1_epi32(valor);
+    uint64_t mascara = 0;
+    for (int i = 0; i < 8; i++) {
+        __m256i dados = _mm256_loadu_si256((const __m256i *)(bloco + 8 * i));
+        uint64_t bits = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(dados, procurado)));
+        mascara |= bits << (8 * i);
+    }
+    return mascara;
+}
+#endif
+
+static FiltroBlocoU8 filtroU8 = NULL;   /**< Versão escolhida do filtro de bytes */
+static FiltroBlocoI32 filtroI32 = NULL; /**< Versão escolhida do filtro de inteiros */
+
+/**
+ * @brief Escolhe a versão mais rápida dos filtros suportada pelo processador.
+ */
+static void escolherFiltros(void) {
+    filtroU8 = blocoIgualU8Escalar;
+    filtroI32 = blocoIgualI32Escalar;
+#ifdef FILTROS_SSE2
+    filtroU8 = blocoIgualU8SSE2;
+    filtroI32 = blocoIgualI32SSE2;
+#endif
+#ifdef FILTROS_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        filtroU8 = blocoIgualU8AVX2;
+        filtroI32 = blocoIgualI32AVX2;
+    }
+#endif
+}
+
+/**
+ * @brief Inicializa um mapa vazio, sem elementos (não aloca memória).
+ * @param selecao Apontador para o mapa.
+ */
+void inicializarSelecao(Selecao *selecao) {
+    selecao->palavras = NULL;
+    selecao->numPalavras = 0;
+    selecao->tamanho = 0;
+    selecao->capacidadePalavras = 0;
+}
+
+/**
+ * @brief Cria um mapa de seleção com todos os elementos selecionados.
+ * @param selecao Apontador para o mapa.
+ * @param tamanho Número de elementos.
+ * @return 1 em caso de sucesso, 0 se não houver memória.
+ */
+int criarSelecao(Selecao *selecao, int tamanho) {
+    if (tamanho < 0) tamanho = 0;
+    selecao->tamanho = tamanho;
+    selecao->numPalavras = (tamanho + SELECAO_BITS_PALAVRA - 1) / SELECAO_BITS_PALAVRA;
+    selecao->capacidadePalavras = selecao->numPalavras + 1;
+    selecao->palavras = malloc((size_t)selecao->capacidadePalavras * sizeof(uint64_t));
+    if (selecao->palavras == NULL) {
+        registar_log("Erro: Falha ao alocar memória para um mapa de seleção.");
+        inicializarSelecao(selecao);
+        return 0;
+    }
+
+    memset(selecao->palavras, 0xFF, (size_t)selecao->numPalavras * sizeof(uint64_t));
+    int resto = tamanho % SELECAO_BITS_PALAVRA;
+    if (resto != 0) {
+        selecao->palavras[selecao->numPalavras - 1] = ((uint64_t)1 << resto) - 1;
+    }
+    return 1;
+}
+
+/**
+ * @brief Liberta a memória de um mapa de seleção.
+ * @param selecao Apontador para o mapa.
+ */
+void libertarSelecao(Selecao *selecao) {
+    free(selecao->palavras);
+    inicializarSelecao(selecao);
+}
+
+/**
+ * @brief Retira todos os elementos do mapa, mantendo a memória.
+ * @param selecao Apontador para o mapa.
+ */
+void limparSelecao(Selecao *selecao) {
+    selecao->numPalavras = 0;
+    selecao->tamanho = 0;
+}
+
+/**
+ * @brief Seleciona ou retira um elemento, aumentando o mapa se a posição estiver para lá do fim. O(1) amortizado.
+ * @details Retirar um elemento para lá do fim não faz nada; selecioná-lo aumenta o tamanho até à posição,
+ * com os novos elementos por selecionar. A capacidade duplica quando é preciso crescer.
+ * @param selecao Apontador para o mapa.
+ * @param posicao Posição do elemento (>= 0).
+ * @param selecionado 1 para selecionar, 0 para retirar.
+ * @return 1 em caso de sucesso, 0 se não houver memória.
+ */
+int alterarSelecionado(Selecao *selecao, int posicao, int selecionado) {
+    if (posicao < 0) return 0;
+
+    int palavra = posicao / SELECAO_BITS_PALAVRA;
+    uint64_t bit = (uint64_t)1 << (posicao % SELECAO_BITS_PALAVRA);
+    if (posicao >= selecao->tamanho) {
+        if (!selecionado) return 1;
+
+        if (palavra >= selecao->capacidadePalavras) {
+            int novaCap = selecao->capacidadePalavras > 0 ? selecao->capacidadePalavras * 2 : 4;
+            while (novaCap <= palavra) novaCap *= 2;
+            uint64_t *palavras = realloc(selecao->palavras, (size_t)novaCap * sizeof(uint64_t));
+            if (palavras == NULL) {
+                registar_log("Erro: Falha ao expandir um mapa de seleção.");
+                return 0;
+            }
+            selecao->palavras = palavras;
+            selecao->capacidadePalavras = novaCap;
+        }
+        for (int w = selecao->numPalavras; w <= palavra; w++) selecao->palavras[w] = 0;
+        if (palavra >= selecao->numPalavras) selecao->numPalavras = palavra + 1;
+        selecao->tamanho = posicao + 1;
+    }
+
+    if (selecionado) {
+        selecao->palavras[palavra] |= bit;
+    } else {
+        selecao->palavras[palavra] &= ~bit;
+    }
+    return 1;
+}
+
+/**
+ * @brief Indica se um elemento está selecionado.
+ * @param selecao Apontador para o mapa.
+ * @param posicao Posição do elemento.
+ * @return 1 se estiver selecionado, caso contrário 0.
+ */
+int estaSelecionado(const Selecao *selecao, int posicao) {
+    if (posicao < 0 || posicao >= selecao->tamanho) return 0;
+    return (int)((selecao->palavras[posicao / SELECAO_BITS_PALAVRA] >> (posicao % SELECAO_BITS_PALAVRA)) & 1);
+}
+
+/**
+ * @brief Substitui o conteúdo do mapa por tamanho elementos copiados de um array de palavras (ex: lido de um ficheiro).
+ * @details Os bits da última palavra para lá de tamanho são postos a 0.
+ * @param selecao Apontador para o mapa.
+ * @param palavras Palavras a copiar (pelo menos ceil(tamanho / SELECAO_BITS_PALAVRA)).
+ * @param tamanho Número de elementos.
+ * @return 1 em caso de sucesso, 0 se não houver memória (o mapa fica inalterado).
+ */
+int copiarPalavrasSelecao(Selecao *selecao, const uint64_t *palavras, int tamanho) {
+    if (tamanho < 0) tamanho = 0;
+    int numPalavras = (tamanho + SELECAO_BITS_PALAVRA - 1) / SELECAO_BITS_PALAVRA;
+
+    if (numPalavras > selecao->capacidadePalavras) {
+        uint64_t *novas = realloc(selecao->palavras, (size_t)numPalavras * sizeof(uint64_t));
+        if (novas == NULL) {
+            registar_log("Erro: Falha ao expandir um mapa de seleção.");
+            return 0;
+        }
+        selecao->palavras = novas;
+        selecao->capacidadePalavras = numPalavras;
+    }
+    if (numPalavras > 0) memcpy(selecao->palavras, palavras, (size_t)numPalavras * sizeof(uint64_t));
+    if (tamanho % SELECAO_BITS_PALAVRA != 0) {
+        selecao->palavras[numPalavras - 1] &= ((uint64_t)1 << (tamanho % SELECAO_BITS_PALAVRA)) - 1;
+    }
+    selecao->numPalavras = numPalavras;
+    selecao->tamanho = tamanho;
+    return 1;
+}
+
+/**
+ * @brief Mantém selecionados apenas os elementos em que coluna[i] == valor (1 byte por elemento).
+ * @param selecao Apontador para o mapa (o tamanho indica quantos elementos da coluna são lidos).
+ * @param coluna Coluna com um byte por elemento.
+ * @param valor Valor pretendido.
+ */
+void filtrarIgualU8(Selecao *selecao, const uint8_t *coluna, uint8_t valor) {
+    if (filtroU8 == NULL) escolherFiltros();
+
+    int completas = selecao->tamanho / SELECAO_BITS_PALAVRA;
+    for (int w = 0; w < completas; w++) {
+        if (selecao->palavras[w] == 0) continue;
+        selecao->palavras[w] &= filtroU8(coluna + (size_t)w * SELECAO_BITS_PALAVRA, valor);
+    }
+
+    int resto = selecao->tamanho % SELECAO_BITS_PALAVRA;
+    if (resto != 0) {
+        const uint8_t *bloco = coluna + (size_t)completas * SELECAO_BITS_PALAVRA;
+        uint64_t mascara = 0;
+        for (int i = 0; i < resto; i++) mascara |= (uint64_t)(bloco[i] == valor) << i;
+        selecao->palavras[completas] &= mascara;
+    }
+}
+
+/**
+ * @brief Mantém selecionados apenas os elementos em que coluna[i] == valor (4 bytes por elemento).
+ * @param selecao Apontador para o mapa (o tamanho indica quantos elementos da coluna são lidos).
+ * @param coluna Coluna com um inteiro por elemento.
+ * @param valor Valor pretendido.
+ */
+void filtrarIgualI32(Selecao *selecao, const int32_t *coluna, int32_t valor) {
+    if (filtroI32 == NULL) escolherFiltros();
+
+    int completas = selecao->tamanho / SELECAO_BITS_PALAVRA;
+    for (int w = 0; w < completas; w++) {
+        if (selecao->palavras[w] == 0) continue;
+        selecao->palavras[w] &= filtroI32(coluna + (size_t)w * SELECAO_BITS_PALAVRA, valor);
+    }
+
+    int resto = selecao->tamanho % SELECAO_BITS_PALAVRA;
+    if (resto != 0) {
+        const int32_t *bloco = coluna + (size_t)completas * SELECAO_BITS_PALAVRA;
+        uint64_t mascara = 0;
+        for (int i = 0; i < resto; i++) mascara |= (uint64_t)(bloco[i] == valor) << i;
+        selecao->palavras[completas] &= mascara;
+    }
+}
+
+/**
+ * @brief Interseção de dois mapas com o mesmo tamanho (destino = destino E outra).
+ * @param destino Apontador para o mapa alterado.
+ * @param outra Apontador para o outro mapa.
+ */
+void intersetarSelecao(Selecao *destino, const Selecao *outra) {
+    for (int w = 0; w < destino->numPalavras && w < outra->numPalavras; w++) {
+        destino->palavras[w] &= outra->palavras[w];
+    }
+}
+
+/**
+ * @brief União de dois mapas com o mesmo tamanho (destino = destino OU outra).
+ * @param destino Apontador para o mapa alterado.
+ * @param outra Apontador para o outro mapa.
+ */
+void unirSelecao(Selecao *destino, const Selecao *outra) {
+    for (int w = 0; w < destino->numPalavras && w < outra->numPalavras; w++) {
+        destino->palavras[w] |= outra->palavras[w];
+    }
+}
+
+/**
+ * @brief Conta os elementos selecionados (popcount de cada palavra).
+ * @param selecao Apontador para o mapa.
+ * @return Número de elementos selecionados.
+ */
+int contarSelecao(const Selecao *selecao) {
+    int total = 0;
+    for (int w = 0; w < selecao->numPalavras; w++) {
+        total += __builtin_popcountll(selecao->palavras[w]);
+    }
+    return total;
+}
+
+/**
+ * @brief Devolve o primeiro elemento selecionado a partir de uma posição (salta as palavras a 0).
+ * @param selecao Apontador para o mapa.
+ * @param desde Primeira posição a considerar.
+ * @return Posição do elemento ou -1 se não houver mais elementos selecionados.
+ */
+int proximoSelecionado(const Selecao *selecao, int desde) {
+    if (desde < 0) desde = 0;
+    if (desde >= selecao->tamanho) return -1;
+
+    int w = desde / SELECAO_BITS_PALAVRA;
+    uint64_t palavra = selecao->palavras[w] & (~(uint64_t)0 << (desde % SELECAO_BITS_PALAVRA));
+    while (palavra == 0) {
+        if (++w >= selecao->numPalavras) return -1;
+        palavra = selecao->palavras[w];
+    }
+    return w * SELECAO_BITS_PALAVRA + __builtin_ctzll(palavra);
+}
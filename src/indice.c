@@ -0,0 +1,157 @@
+/**
+ * @file indice.c
+ * @brief Ficheiro com o índice hash partilhado por ativos, ordens, técnicos e departamentos.
+ * @details Tabela de endereçamento aberto com sondagem linear. A capacidade é sempre uma potência
+ * de 2 e a tabela é expandida quando fica meio cheia, pelo que as procuras são O(1) em média.
+ * @author Francisco Alves
+ */
+
+#include <stdlib.h>
+#include <limits.h>
+#include "../include/indice.h"
+#include "../include/logs.h"
+
+#define INDICE_VAZIO INT_MIN
+#define INDICE_CAPACIDADE_INICIAL 16
+
+/**
+ * @brief Calcula a posição inicial de um ID na tabela (hash multiplicativo de Fibonacci).
+ * @param id ID a procurar.
+ * @param capacidade Capacidade da tabela (potência de 2).
+ * @return Posição inicial da sondagem.
+ */
+static int posicaoInicial(int id, int capacidade) {
+    unsigned int h = (unsigned int)id * 2654435769u;
+    return (int)(h & (unsigned int)(capacidade - 1));
+}
+
+/**
+ * @brief Inicializa um índice vazio (não aloca memória).
+ * @param indice Apontador para o índice.
+ */
+void inicializarIndice(IndiceHash *indice) {
+    indice->chaves = NULL;
+    indice->posicoes = NULL;
+    indice->capacidade = 0;
+    indice->ocupados = 0;
+}
+
+/**
+ * @brief Coloca uma entrada na tabela sem verificar a capacidade.
+ * @param indice Apontador para o índice (com pelo menos uma posição livre).
+ * @param id ID a guardar.
+ * @param posicao Posição do registo no array.
+ */
+static void colocarEntrada(IndiceHash *indice, int id, int posicao) {
+    int mascara = indice->capacidade - 1;
+    int i = posicaoInicial(id, indice->capacidade);
+
+    while (indice->chaves[i] != INDICE_VAZIO && indice->chaves[i] != id) {
+        i = (i + 1) & mascara;
+    }
+    if (indice->chaves[i] == INDICE_VAZIO) {
+        indice->chaves[i] = id;
+        indice->ocupados++;
+    }
+    indice->posicoes[i] = posicao;
+}
+
+/**
+ * @brief Garante que a tabela tem espaço para minimo entradas com ocupação máxima de 50%.
+ * @param indice Apontador para o índice.
+ * @param minimo Número de entradas pretendido.
+ * @return 1 em caso de sucesso, 0 se a alocação falhar.
+ */
+static int garantirCapacidadeIndice(IndiceHash *indice, int minimo) {
+    if (indice->capacidade > 0 && minimo * 2 <= indice->capacidade) return 1;
+
+    int novaCap = indice->capacidade > 0 ? indice->capacidade : INDICE_CAPACIDADE_INICIAL;
+    while (minimo * 2 > novaCap) novaCap *= 2;
+
+    int *chaves = malloc((size_t)novaCap * sizeof(int));
+    int *posicoes = malloc((size_t)novaCap * sizeof(int));
+    if (chaves == NULL || posicoes == NULL) {
+        free(chaves);
+        free(posicoes);
+        registar_log("Erro: Falha ao alocar memória para o índice de IDs.");
+        return 0;
+    }
+    for (int i = 0; i < novaCap; i++) {
+        chaves[i] = INDICE_VAZIO;
+    }
+
+    IndiceHash antigo = *indice;
+    indice->chaves = chaves;
+    indice->posicoes = posicoes;
+    indice->capacidade = novaCap;
+    indice->ocupados = 0;
+
+    for (int i = 0; i < antigo.capacidade; i++) {
+        if (antigo.chaves[i] != INDICE_VAZIO) {
+            colocarEntrada(indice, antigo.chaves[i], antigo.posicoes[i]);
+        }
+    }
+    free(antigo.chaves);
+    free(antigo.posicoes);
+    return 1;
+}
+
+/**
+ * @brief Associa um ID a uma posição (substitui a posição se o ID já existir).
+ * @param indice Apontador para o índice.
+ * @param id ID a guardar.
+ * @param posicao Posição do registo no array.
+ * @return 1 em caso de sucesso, 0 se não houver memória para expandir o índice.
+ */
+int inserirIndice(IndiceHash *indice, int id, int posicao) {
+    if (id == INDICE_VAZIO) return 0;
+    if (!garantirCapacidadeIndice(indice, indice->ocupados + 1)) return 0;
+
+    colocarEntrada(indice, id, posicao);
+    return 1;
+}
+
+/**
+ * @brief Procura a posição associada a um ID.
+ * @param indice Apontador para o índice.
+ * @param id ID a procurar.
+ * @return Posição no array ou -1 se o ID não existir.
+ */
+int procurarIndice(const IndiceHash *indice, int id) {
+    if (indice->capacidade == 0 || id == INDICE_VAZIO) return -1;
+
+    int mascara = indice->capacidade - 1;
+    int i = posicaoInicial(id, indice->capacidade);
+
+    while (indice->chaves[i] != INDICE_VAZIO) {
+        if (indice->chaves[i] == id) {
+            return indice->posicoes[i];
+        }
+        i = (i + 1) & mascara;
+    }
+    return -1;
+}
+
+/**
+ * @brief Remove todas as entradas, reservando espaço para minimo entradas.
+ * @param indice Apontador para o índice.
+ * @param minimo Número de entradas que se espera inserir.
+ * @return 1 em caso de sucesso, 0 se não houver memória.
+ */
+int limparIndice(IndiceHash *indice, int minimo) {
+    for (int i = 0; i < indice->capacidade; i++) {
+        indice->chaves[i] = INDICE_VAZIO;
+    }
+    indice->ocupados = 0;
+    return garantirCapacidadeIndice(indice, minimo);
+}
+
+/**
+ * @brief Liberta a memória do índice.
+ * @param indice Apontador para o índice.
+ */
+void libertarIndice(IndiceHash *indice) {
+    free(indice->chaves);
+    free(indice->posicoes);
+    inicializarIndice(indice);
+}
@@ -8,6 +8,7 @@
 #include <string.h>
 #include <ctype.h>
 #include <stdlib.h>
+#include "../include/dicionario.h"
 #define VALOR_INVALIDO "O valor inserido e invalido."
 
 
@@ -114,6 +115,29 @@ char* lerStringDinamica(const char *msg) {
     return string;
 }
 
+/**
+ * @brief Guarda num pool uma string alocada (ex: devolvida por lerStringDinamica) e liberta-a.
+ * @param pool Pool onde a string é internada.
+ * @param str String alocada com malloc (pode ser NULL).
+ * @return String do pool ou NULL se str for NULL ou a alocação falhar.
+ */
+const char* internarStringLida(PoolStrings *pool, char *str) {
+    const char *internada = internarStringPool(pool, str);
+    free(str);
+    return internada;
+}
+
+/**
+ * @brief Lê uma string do teclado e guarda-a num pool de strings.
+ * @details Strings iguais já existentes no pool não ocupam memória nova; o buffer de leitura é libertado.
+ * @param pool Pool onde a string é internada.
+ * @param msg Mensagem a exibir ao utilizador antes da leitura.
+ * @return String do pool (não deve ser libertada) ou NULL se a alocação falhar.
+ */
+const char* lerStringPool(PoolStrings *pool, const char *msg) {
+    return internarStringLida(pool, lerStringDinamica(msg));
+}
+
 /**
  * @brief Lê e valida o nome de uma entidade (Técnico ou Responsável).
  * @details Garante que o nome cumpre três regras de validação: ter no mínimo 3 caracteres,
@@ -192,7 +216,7 @@ int obterIntIntervalado(int minValor, int maxValor, char *msg) {
  * @param str Apontador para a string a ser guarada, pode ser NULL.
  * @param fp Apontador para o ficheiro binário  aberto em modo de escrita.
  */
-void escreverStringBinario(char *str, FILE *fp) {
+void escreverStringBinario(const char *str, FILE *fp) {
     int tam = (str != NULL) ? strlen(str) + 1 : 0;
     fwrite(&tam, sizeof(int), 1, fp); // Grava o tamanho
     if (tam > 0) {
@@ -201,18 +225,26 @@ void escreverStringBinario(char *str, FILE *fp) {
 }
 
 /**
- * @brief Lê a string de um ficheiro binário e aloca a memória necessária.
+ * @brief Lê a string de um ficheiro binário e guarda-a num pool de strings.
+ * @details As strings curtas são lidas para um buffer local, sem nenhum malloc por string.
  * @param fp Apontador para o ficheiro binário aberto em modo de leitura.
- * @return Um apontador para a string alocada ou NULL se a string for vazia ou a alocação falhar.
+ * @param pool Pool onde a string é internada.
+ * @return Um apontador para a string do pool ou NULL se a string for vazia ou a alocação falhar.
  */
-char* lerStringBinario(FILE *fp) {
-    int tam;
+const char* lerStringBinario(FILE *fp, PoolStrings *pool) {
+    char local[256];
+    int tam = 0;
     fread(&tam, sizeof(int), 1, fp);
-    if (tam == 0) return NULL;
+    if (tam <= 0) return NULL;
+
+    char *str = (size_t)tam <= sizeof(local) ? local : malloc(tam * sizeof(char));
+    if (str == NULL) return NULL;
 
-    char *str = malloc(tam * sizeof(char));
-    if (str != NULL) {
-        fread(str, sizeof(char), tam, fp);
+    const char *internada = NULL;
+    if (fread(str, sizeof(char), tam, fp) == (size_t)tam) {
+        str[tam - 1] = '\0';
+        internada = internarStringPool(pool, str);
     }
-    return str;
+    if (str != local) free(str);
+    return internada;
 }
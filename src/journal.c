@@ -0,0 +1,611 @@
+/**
+ * @file journal.c
+ * @brief Ficheiro com o journal append-only que torna persistente cada alteração feita durante a sessão.
+ * @details Cada operação que altera dados acrescenta ao ficheiro "journal.bin" um registo com a imagem
+ * completa da entidade alterada. No arranque os registos são repostos sobre os ficheiros binários
+ * (snapshots) e, periodicamente ou à saída, é feito um checkpoint que grava os snapshots e esvazia o journal.
+ * @author Francisco Alves
+ */
+
+#define _POSIX_C_SOURCE 200809L /* truncate */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "../include/journal.h"
+#include "../include/snapshot.h"
+#include "../include/logs.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <unistd.h>
+#endif
+
+#define FICHEIRO_JOURNAL "journal.bin"
+
+/**
+ * @brief Cabeçalho de cada registo do journal.
+ */
+typedef struct {
+    uint32_t tipo;      /**< TipoRegistoJournal */
+    uint32_t tamanho;   /**< Tamanho do conteúdo em bytes */
+    uint32_t checksum;  /**< FNV-1a do conteúdo, para detetar registos incompletos */
+} CabecalhoRegistoJournal;
+
+/**
+ * @brief Buffer onde o conteúdo de um registo é montado antes de ser escrito com um único fwrite.
+ */
+typedef struct {
+    unsigned char *dados;
+    size_t tamanho;
+    size_t capacidade;
+    int erro;
+} BufferJournal;
+
+/**
+ * @brief Cursor de leitura sobre o conteúdo de um registo.
+ */
+typedef struct {
+    const unsigned char *dados;
+    size_t restante;
+    int erro;
+} LeitorJournal;
+
+static FILE *ficheiroJournal = NULL;
+static BufferJournal buffer = {0};
+static int registosDesdeCheckpoint = 0;
+
+/**
+ * @brief Calcula o checksum FNV-1a de um bloco de bytes.
+ * @param dados Bytes a processar.
+ * @param tamanho Número de bytes.
+ * @return Valor do checksum.
+ */
+static uint32_t checksumJournal(const unsigned char *dados, size_t tamanho) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < tamanho; i++) {
+        hash ^= dados[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Acrescenta bytes ao buffer, expandindo-o quando necessário.
+ * @param buf Apontador para o buffer.
+ * @param dados Bytes a acrescentar.
+ * @param tamanho Número de bytes.
+ */
+static void escreverBytes(BufferJournal *buf, const void *dados, size_t tamanho) {
+    if (buf->erro) return;
+
+    if (buf->tamanho + tamanho > buf->capacidade) {
+        size_t novaCap = buf->capacidade > 0 ? buf->capacidade : 256;
+        while (novaCap < buf->tamanho + tamanho) novaCap *= 2;
+
+        unsigned char *tmp = realloc(buf->dados, novaCap);
+        if (tmp == NULL) {
+            buf->erro = 1;
+            return;
+        }
+        buf->dados = tmp;
+        buf->capacidade = novaCap;
+    }
+    memcpy(buf->dados + buf->tamanho, dados, tamanho);
+    buf->tamanho += tamanho;
+}
+
+static void escreverInt(BufferJournal *buf, int valor) {
+    int32_t v = valor;
+    escreverBytes(buf, &v, sizeof(v));
+}
+
+static void escreverInt64(BufferJournal *buf, int64_t valor) {
+    escreverBytes(buf, &valor, sizeof(valor));
+}
+
+static void escreverFloat(BufferJournal *buf, float valor) {
+    escreverBytes(buf, &valor, sizeof(valor));
+}
+
+/**
+ * @brief Escreve uma string no mesmo formato de escreverStringBinario (tamanho + conteúdo, 0 se NULL).
+ * @param buf Apontador para o buffer.
+ * @param str String a escrever (pode ser NULL).
+ */
+static void escreverString(BufferJournal *buf, const char *str) {
+    int tam = (str != NULL) ? (int)strlen(str) + 1 : 0;
+    escreverInt(buf, tam);
+    if (tam > 0) {
+        escreverBytes(buf, str, (size_t)tam);
+    }
+}
+
+static void lerBytes(LeitorJournal *leitor, void *destino, size_t tamanho) {
+    if (leitor->erro || leitor->restante < tamanho) {
+        leitor->erro = 1;
+        memset(destino, 0, tamanho);
+        return;
+    }
+    memcpy(destino, leitor->dados, tamanho);
+    leitor->dados += tamanho;
+    leitor->restante -= tamanho;
+}
+
+static int lerInt(LeitorJournal *leitor) {
+    int32_t v;
+    lerBytes(leitor, &v, sizeof(v));
+    return v;
+}
+
+static int64_t lerInt64(LeitorJournal *leitor) {
+    int64_t v;
+    lerBytes(leitor, &v, sizeof(v));
+    return v;
+}
+
+/**
+ * @brief Lê uma data guardada em campos separados (registos do formato anterior) e converte-a.
+ * @param leitor Cursor de leitura.
+ * @param comHora 1 se a data incluir hora, minutos e segundos, 0 se só tiver dia/mês/ano.
+ * @return Timestamp correspondente ou SEM_DATA.
+ */
+static Timestamp lerDataCampos(LeitorJournal *leitor, int comHora) {
+    int dia = lerInt(leitor);
+    int mes = lerInt(leitor);
+    int ano = lerInt(leitor);
+    int hora = comHora ? lerInt(leitor) : 0;
+    int min = comHora ? lerInt(leitor) : 0;
+    int seg = comHora ? lerInt(leitor) : 0;
+    return timestampDeCampos(ano, mes, dia, hora, min, seg);
+}
+
+static float lerFloat(LeitorJournal *leitor) {
+    float v;
+    lerBytes(leitor, &v, sizeof(v));
+    return v;
+}
+
+/**
+ * @brief Lê uma string escrita por escreverString(), sem a copiar.
+ * @param leitor Cursor de leitura.
+ * @return String dentro do registo (válida enquanto o registo estiver em memória; as funções repor*
+ * copiam-na para o pool da entidade) ou NULL se estiver vazia/for inválida.
+ */
+static const char *lerString(LeitorJournal *leitor) {
+    int tam = lerInt(leitor);
+    if (leitor->erro || tam <= 0) return NULL;
+
+    if ((size_t)tam > leitor->restante || leitor->dados[tam - 1] != '\0') {
+        leitor->erro = 1;
+        return NULL;
+    }
+
+    const char *str = (const char *)leitor->dados;
+    leitor->dados += tam;
+    leitor->restante -= (size_t)tam;
+    return str;
+}
+
+/**
+ * @brief Corta o journal num tamanho, descartando um registo incompleto no fim.
+ * @param tamanho Tamanho a manter (fim do último registo válido).
+ * @return 1 se o ficheiro foi cortado, caso contrário 0.
+ */
+static int cortarJournal(long tamanho) {
+#ifdef _WIN32
+    int fd = _open(FICHEIRO_JOURNAL, _O_RDWR | _O_BINARY);
+    int ok = fd != -1 && _chsize_s(fd, tamanho) == 0;
+    if (fd != -1) _close(fd);
+#else
+    int ok = truncate(FICHEIRO_JOURNAL, (off_t)tamanho) == 0;
+#endif
+    if (!ok) {
+        registar_log("Erro: Não foi possível remover um registo incompleto do journal.");
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Escreve no ficheiro o registo que está montado no buffer.
+ * @details O cabeçalho e o conteúdo são escritos de seguida e o ficheiro é sincronizado com o disco
+ * (sincronizarFicheiro()) antes de a operação ser dada como feita, pelo que o registo sobrevive a uma falha
+ * de energia. O custo de cada operação é constante e não depende do tamanho das tabelas.
+ * Se a escrita falhar a meio, o ficheiro é cortado no fim do registo anterior, para que os registos
+ * seguintes não fiquem depois de um registo ilegível (a recuperação pára no primeiro registo inválido).
+ * @param tipo Tipo do registo.
+ */
+static void acrescentarRegisto(TipoRegistoJournal tipo) {
+    if (ficheiroJournal == NULL) return;
+
+    if (buffer.erro) {
+        registar_log("Erro: Falha ao alocar memória para um registo do journal.");
+        buffer.erro = 0;
+        return;
+    }
+
+    CabecalhoRegistoJournal cab;
+    cab.tipo = (uint32_t)tipo;
+    cab.tamanho = (uint32_t)buffer.tamanho;
+    cab.checksum = checksumJournal(buffer.dados, buffer.tamanho);
+
+    /* o journal é sempre descarregado depois de cada registo, pelo que o tamanho atual é o fim do último registo */
+    long fimAnterior = -1;
+    if (fseek(ficheiroJournal, 0, SEEK_END) == 0) fimAnterior = ftell(ficheiroJournal);
+    if (fimAnterior < 0) {
+        registar_log("Erro: Não foi possível obter o tamanho do journal.");
+        return;
+    }
+
+    if (fwrite(&cab, sizeof(cab), 1, ficheiroJournal) != 1 ||
+        fwrite(buffer.dados, 1, buffer.tamanho, ficheiroJournal) != buffer.tamanho ||
+        !sincronizarFicheiro(ficheiroJournal)) {
+        registar_log("Erro: Falha ao escrever um registo no journal.");
+        fclose(ficheiroJournal);
+        cortarJournal(fimAnterior);
+        ficheiroJournal = fopen(FICHEIRO_JOURNAL, "ab");
+        return;
+    }
+    registosDesdeCheckpoint++;
+}
+
+/**
+ * @brief Abre o ficheiro do journal para acrescentar registos.
+ * @return 1 se o journal ficou aberto, caso contrário 0.
+ */
+int abrirJournal(void) {
+    if (ficheiroJournal != NULL) return 1;
+
+    ficheiroJournal = fopen(FICHEIRO_JOURNAL, "ab");
+    if (ficheiroJournal == NULL) {
+        printf("Aviso: não foi possível abrir o journal, as alterações só serão gravadas à saída.\n");
+        registar_log("Erro: Não foi possível abrir journal.bin para escrita.");
+        return 0;
+    }
+    /* o journal pode ter sido criado agora: a entrada na pasta também tem de chegar ao disco */
+    if (!sincronizarDiretorio(FICHEIRO_JOURNAL)) {
+        registar_log("Aviso: Não foi possível sincronizar a pasta do journal com o disco.");
+    }
+    return 1;
+}
+
+/**
+ * @brief Fecha o ficheiro do journal.
+ */
+void fecharJournal(void) {
+    if (ficheiroJournal != NULL) {
+        fclose(ficheiroJournal);
+        ficheiroJournal = NULL;
+    }
+    free(buffer.dados);
+    buffer.dados = NULL;
+    buffer.tamanho = 0;
+    buffer.capacidade = 0;
+}
+
+/**
+ * @brief Regista no journal o estado atual de um departamento.
+ * @param departamentos Apontador para a estrutura com a lista de departamentos.
+ * @param idx Índice do departamento alterado.
+ */
+void journalDepartamento(const Departamentos *departamentos, int idx) {
+    const Departamento *d = &departamentos->departamento[idx];
+
+    buffer.tamanho = 0;
+    escreverInt(&buffer, departamentos->departamentosAtivos);
+    escreverInt(&buffer, departamentos->proximoID);
+    escreverInt(&buffer, d->idDepartamento);
+    escreverInt(&buffer, d->atividade);
+    escreverString(&buffer, d->nomeDepartamento);
+    escreverString(&buffer, d->responsavel);
+    escreverString(&buffer, d->contacto);
+    acrescentarRegisto(JOURNAL_DEPARTAMENTO);
+}
+
+/**
+ * @brief Regista no journal o estado atual de um ativo.
+ * @param ativos Apontador para a estrutura com a lista de ativos.
+ * @param idx Índice do ativo alterado.
+ */
+void journalAtivo(const Ativos *ativos, int idx) {
+    const Ativo *a = &ativos->ativo[idx];
+
+    buffer.tamanho = 0;
+    escreverInt(&buffer, ativos->ativosDisponiveis);
+    escreverInt(&buffer, ativos->proximoID);
+    escreverInt(&buffer, a->id);
+    escreverInt(&buffer, a->categoria);
+    escreverInt(&buffer, a->estado);
+    escreverInt(&buffer, a->idDepartamentoAssociado);
+    escreverInt64(&buffer, a->dataAquisicao);
+    escreverInt64(&buffer, a->dataAbate);
+    escreverInt(&buffer, a->contagemManutencoesCorretivas);
+    escreverFloat(&buffer, a->custo);
+    escreverFloat(&buffer, a->custoTotalAcumulado);
+    escreverString(&buffer, a->designacao);
+    escreverString(&buffer, a->localizacao);
+    acrescentarRegisto(JOURNAL_ATIVO);
+}
+
+/**
+ * @brief Regista no journal o estado atual de um técnico.
+ * @param tecnicos Apontador para a estrutura com a lista de técnicos.
+ * @param idx Índice do técnico alterado.
+ */
+void journalTecnico(const Tecnicos *tecnicos, int idx) {
+    const Tecnico *t = &tecnicos->tecnico[idx];
+
+    buffer.tamanho = 0;
+    escreverInt(&buffer, tecnicos->tecnicosAtivos);
+    escreverInt(&buffer, tecnicos->proximoID);
+    escreverInt(&buffer, t->idTecnico);
+    escreverInt(&buffer, t->especialidade);
+    escreverInt(&buffer, t->estado_tecnico);
+    escreverInt(&buffer, t->idManutencaoAssociado);
+    escreverString(&buffer, t->nome);
+    acrescentarRegisto(JOURNAL_TECNICO);
+}
+
+/**
+ * @brief Regista no journal o estado atual de uma ordem.
+ * @param ordens Apontador para a estrutura com a lista de ordens.
+ * @param idx Índice da ordem alterada.
+ */
+void journalOrdem(const Ordens *ordens, int idx) {
+    const Ordem *o = &ordens->ordem[idx];
+
+    buffer.tamanho = 0;
+    escreverInt(&buffer, ordens->ordensAtivas);
+    escreverInt(&buffer, ordens->proximoID);
+    escreverInt(&buffer, o->idOrdem);
+    escreverInt(&buffer, o->idAtivo);
+    escreverInt(&buffer, o->idDepartamento);
+    escreverInt(&buffer, o->idTecnico);
+    escreverInt(&buffer, o->estado);
+    escreverInt(&buffer, o->prioridade);
+    escreverInt(&buffer, o->tipo_manutencao);
+    escreverInt64(&buffer, o->inicio);
+    escreverInt64(&buffer, o->fim);
+    acrescentarRegisto(JOURNAL_ORDEM);
+}
+
+/**
+ * @brief Regista no journal um material adicionado.
+ * @param materiais Apontador para a estrutura com a lista de materiais.
+ * @param idx Índice do material adicionado.
+ * @note O índice é guardado para que a reposição seja idempotente (os materiais não têm ID).
+ */
+void journalMaterial(const Materiais *materiais, int idx) {
+    const Material *m = &materiais->material[idx];
+
+    buffer.tamanho = 0;
+    escreverInt(&buffer, idx);
+    escreverInt(&buffer, m->quantidade);
+    escreverFloat(&buffer, m->custoUnitário);
+    escreverInt(&buffer, m->OrdemAssociada);
+    escreverString(&buffer, m->nomeMaterial);
+    acrescentarRegisto(JOURNAL_MATERIAL);
+}
+
+/**
+ * @brief Descodifica e aplica um registo do journal.
+ * @return 1 se o registo foi aplicado, 0 se o conteúdo for inválido.
+ */
+static int aplicarRegisto(uint32_t tipo, LeitorJournal *leitor, Departamentos *departamentos, Ativos *ativos,
+                          Tecnicos *tecnicos, Ordens *ordens, Materiais *materiais) {
+    switch (tipo) {
+        case JOURNAL_DEPARTAMENTO: {
+            Departamento d;
+            int ativosTotal = lerInt(leitor);
+            int proximoID = lerInt(leitor);
+            d.idDepartamento = lerInt(leitor);
+            d.atividade = lerInt(leitor);
+            d.nomeDepartamento = lerString(leitor);
+            d.responsavel = lerString(leitor);
+            d.contacto = lerString(leitor);
+            if (leitor->erro) return 0;
+            reporDepartamento(departamentos, &d, ativosTotal, proximoID);
+            return 1;
+        }
+        case JOURNAL_ATIVO:
+        case JOURNAL_ATIVO_CAMPOS: {
+            Ativo a = {0};
+            int disponiveis = lerInt(leitor);
+            int proximoID = lerInt(leitor);
+            a.id = lerInt(leitor);
+            a.categoria = lerInt(leitor);
+            a.estado = lerInt(leitor);
+            a.idDepartamentoAssociado = lerInt(leitor);
+            if (tipo == JOURNAL_ATIVO) {
+                a.dataAquisicao = lerInt64(leitor);
+                a.dataAbate = lerInt64(leitor);
+            } else {
+                a.dataAquisicao = lerDataCampos(leitor, 0);
+                a.dataAbate = lerDataCampos(leitor, 0);
+            }
+            a.contagemManutencoesCorretivas = lerInt(leitor);
+            a.custo = lerFloat(leitor);
+            a.custoTotalAcumulado = lerFloat(leitor);
+            a.designacao = lerString(leitor);
+            a.localizacao = lerString(leitor);
+            if (leitor->erro) return 0;
+            reporAtivo(ativos, &a, disponiveis, proximoID);
+            return 1;
+        }
+        case JOURNAL_TECNICO: {
+            Tecnico t = {0};
+            int ativosTotal = lerInt(leitor);
+            int proximoID = lerInt(leitor);
+            t.idTecnico = lerInt(leitor);
+            t.especialidade = lerInt(leitor);
+            t.estado_tecnico = lerInt(leitor);
+            t.idManutencaoAssociado = lerInt(leitor);
+            t.nome = lerString(leitor);
+            if (leitor->erro) return 0;
+            reporTecnico(tecnicos, &t, ativosTotal, proximoID);
+            return 1;
+        }
+        case JOURNAL_ORDEM:
+        case JOURNAL_ORDEM_CAMPOS: {
+            Ordem o = {0};
+            int ativas = lerInt(leitor);
+            int proximoID = lerInt(leitor);
+            o.idOrdem = lerInt(leitor);
+            o.idAtivo = lerInt(leitor);
+            o.idDepartamento = lerInt(leitor);
+            o.idTecnico = lerInt(leitor);
+            o.estado = lerInt(leitor);
+            o.prioridade = lerInt(leitor);
+            o.tipo_manutencao = lerInt(leitor);
+            if (tipo == JOURNAL_ORDEM) {
+                o.inicio = lerInt64(leitor);
+                o.fim = lerInt64(leitor);
+            } else {
+                o.inicio = lerDataCampos(leitor, 1);
+                o.fim = lerDataCampos(leitor, 1);
+            }
+            if (leitor->erro) return 0;
+            reporOrdem(ordens, &o, ativas, proximoID);
+            return 1;
+        }
+        case JOURNAL_MATERIAL: {
+            Material m;
+            int idx = lerInt(leitor);
+            m.quantidade = lerInt(leitor);
+            m.custoUnitário = lerFloat(leitor);
+            m.OrdemAssociada = lerInt(leitor);
+            m.nomeMaterial = lerString(leitor);
+            if (leitor->erro) return 0;
+            reporMaterial(materiais, idx, &m);
+            return 1;
+        }
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Repõe sobre os dados carregados as alterações registadas no journal.
+ * @details Os registos são lidos por ordem e aplicados como "upsert" (por ID). A leitura pára no
+ * primeiro registo incompleto ou com checksum inválido, que corresponde a uma escrita interrompida;
+ * o ficheiro é então cortado no fim do último registo válido, para que os registos acrescentados
+ * nesta sessão não fiquem escondidos atrás dele. Deve ser chamada antes de abrirJournal().
+ * @param departamentos Apontador para a estrutura de departamentos.
+ * @param ativos Apontador para a estrutura de ativos.
+ * @param tecnicos Apontador para a estrutura de técnicos.
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param materiais Apontador para a estrutura de materiais.
+ * @return Número de registos repostos.
+ */
+int recuperarJournal(Departamentos *departamentos, Ativos *ativos, Tecnicos *tecnicos, Ordens *ordens, Materiais *materiais) {
+    FILE *fp = fopen(FICHEIRO_JOURNAL, "rb");
+    if (fp == NULL) return 0;
+
+    int repostos = 0;
+    int cortar = 0;
+    long fimValido = 0;
+    unsigned char *conteudo = NULL;
+    size_t capacidade = 0;
+    CabecalhoRegistoJournal cab;
+
+    for (;;) {
+        size_t lido = fread(&cab, 1, sizeof(cab), fp);
+        if (lido != sizeof(cab)) {
+            cortar = lido > 0;
+            break;
+        }
+        if (cab.tamanho > capacidade) {
+            unsigned char *tmp = realloc(conteudo, cab.tamanho);
+            if (tmp == NULL) {
+                registar_log("Erro: Falha ao alocar memória ao repor o journal.");
+                break;
+            }
+            conteudo = tmp;
+            capacidade = cab.tamanho;
+        }
+
+        if (fread(conteudo, 1, cab.tamanho, fp) != cab.tamanho ||
+            checksumJournal(conteudo, cab.tamanho) != cab.checksum) {
+            registar_log("Aviso: O journal termina num registo incompleto, que foi ignorado.");
+            cortar = 1;
+            break;
+        }
+        fimValido += (long)(sizeof(cab) + cab.tamanho);
+
+        LeitorJournal leitor = { conteudo, cab.tamanho, 0 };
+        if (!aplicarRegisto(cab.tipo, &leitor, departamentos, ativos, tecnicos, ordens, materiais)) {
+            registar_log("Aviso: Registo do journal com conteúdo inválido foi ignorado.");
+            continue;
+        }
+        repostos++;
+    }
+
+    free(conteudo);
+    fclose(fp);
+
+    if (cortar && cortarJournal(fimValido)) {
+        registar_log("Aviso: O registo incompleto foi removido do journal.");
+    }
+
+    registosDesdeCheckpoint += repostos;
+    if (repostos > 0) {
+        registar_log("Info: Foram repostas alterações do journal após um encerramento inesperado.");
+    }
+    return repostos;
+}
+
+/**
+ * @brief Indica se o journal já tem registos suficientes para justificar um checkpoint.
+ * @return 1 se deve ser feito um checkpoint, caso contrário 0.
+ */
+int journalPrecisaCheckpoint(void) {
+    return registosDesdeCheckpoint >= JOURNAL_LIMITE_REGISTOS;
+}
+
+/**
+ * @brief Grava todos os ficheiros binários e esvazia o journal.
+ * @details O journal só é esvaziado se todos os snapshots forem gravados com sucesso; cada snapshot é
+ * sincronizado com o disco (ficheiro e pasta) por fecharSnapshotEscrita() antes de o journal ser cortado,
+ * pelo que nem uma falha de energia a meio do checkpoint perde alterações. Se o programa terminar a meio
+ * do checkpoint, os registos são repostos novamente no arranque seguinte (a reposição é idempotente).
+ * @param departamentos Apontador para a estrutura de departamentos.
+ * @param ativos Apontador para a estrutura de ativos.
+ * @param tecnicos Apontador para a estrutura de técnicos.
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param materiais Apontador para a estrutura de materiais.
+ * @return 1 se todos os ficheiros foram gravados e o journal esvaziado, caso contrário 0.
+ */
+int checkpointJournal(Departamentos *departamentos, Ativos *ativos, Tecnicos *tecnicos, Ordens *ordens, Materiais *materiais) {
+    int sucesso = 1;
+    sucesso &= guardarDepartamentos(departamentos);
+    sucesso &= guardarAtivos(ativos);
+    sucesso &= guardarTecnicos(tecnicos);
+    sucesso &= guardarOrdens(ordens);
+    sucesso &= guardarMateriais(materiais);
+
+    if (!sucesso) {
+        registar_log("Erro: Checkpoint incompleto, o journal foi mantido.");
+        return 0;
+    }
+
+    int aberto = ficheiroJournal != NULL;
+    if (aberto) {
+        fclose(ficheiroJournal);
+        ficheiroJournal = NULL;
+    }
+
+    FILE *fp = fopen(FICHEIRO_JOURNAL, "wb");
+    if (fp != NULL) {
+        fclose(fp);
+    }
+    registosDesdeCheckpoint = 0;
+
+    if (aberto) {
+        ficheiroJournal = fopen(FICHEIRO_JOURNAL, "ab");
+    }
+    return 1;
+}
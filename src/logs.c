@@ -1,22 +1,46 @@
-
+#define _POSIX_C_SOURCE 200809L /* sigaction, localtime_r, fileno */
 
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 #include "../include/logs.h"
 #include "../include/input.h"
 
+#if defined(__unix__) || defined(__APPLE__)
+#define LOGS_ASSINCRONOS
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
+#define FICHEIRO_LOG "log.txt"
+#define LOG_CAPACIDADE 256
+#define LOG_TAMANHO_MENSAGEM 240
+
+static NivelLog nivelMinimo = LOG_INFO;
+
 /**
-* @brief Regista eventos críticos e falhas do sistema num ficheiro de auditoria.
- * @details Conforme exigido pelo enunciado, permite a depuração e o acompanhamento
- * do funcionamento do software através de carimbos temporais. [cite: 180, 181]
- * @param mensagem Descrição do evento (ex: erro de memória ou ação de utilizador).
+ * @brief Deduz o nível de severidade a partir do prefixo da mensagem.
+ * @param mensagem Mensagem a classificar.
+ * @return Nível correspondente (LOG_INFO se não tiver prefixo conhecido).
  */
-void registar_log(const char *mensagem) {
-    FILE *fp = fopen("log.txt", "a");
+static NivelLog nivelDaMensagem(const char *mensagem) {
+    if (strncmp(mensagem, "Erro", 4) == 0) return LOG_ERRO;
+    if (strncmp(mensagem, "Aviso", 5) == 0) return LOG_AVISO;
+    return LOG_INFO;
+}
+
+/**
+ * @brief Escreve diretamente no ficheiro (usado antes de iniciarLogs() ou sem suporte para threads).
+ * @param quando Momento do registo.
+ * @param mensagem Mensagem a registar.
+ */
+static void escreverLogDireto(time_t quando, const char *mensagem) {
+    FILE *fp = fopen(FICHEIRO_LOG, "a");
     if (fp == NULL) return;
 
-    time_t agora = time(NULL);
-    struct tm *t = localtime(&agora);
+    struct tm *t = localtime(&quando);
 
     fprintf(fp, "[%02d-%02d-%04d %02d:%02d:%02d] %s\n",
             t->tm_mday, t->tm_mon + 1, t->tm_year + 1900,
@@ -26,13 +50,324 @@ void registar_log(const char *mensagem) {
     fclose(fp);
 }
 
+#ifdef LOGS_ASSINCRONOS
+
+/**
+ * @brief Registo guardado no buffer circular até ser escrito pela thread.
+ */
+typedef struct {
+    time_t quando;
+    char texto[LOG_TAMANHO_MENSAGEM];
+}EntradaLog;
+
+static EntradaLog anel[LOG_CAPACIDADE];
+static EntradaLog lote[LOG_CAPACIDADE];
+static volatile size_t inicio = 0;  /**< Próximo registo a escrever no ficheiro */
+static volatile size_t fim = 0;     /**< Próxima posição livre (ambos crescem sem dar a volta) */
+
+static pthread_t threadEscrita;
+static pthread_mutex_t mutexLogs = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t haRegistos = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t haEspaco = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t escritos = PTHREAD_COND_INITIALIZER;
+static int ativo = 0;
+static int terminar = 0;
+
+static FILE *ficheiroLog = NULL;
+static volatile int descritorLog = -1;
+static volatile long deslocamentoUtc = 0;
+
+/**
+ * @brief Escreve um inteiro com um número fixo de algarismos (preenchido com zeros).
+ * @return Apontador para a posição seguinte ao último algarismo.
+ */
+static char *escreverAlgarismos(char *dest, long valor, int largura) {
+    for (int i = largura - 1; i >= 0; i--) {
+        dest[i] = (char)('0' + valor % 10);
+        valor /= 10;
+    }
+    return dest + largura;
+}
+
+/**
+ * @brief Formata um registo no formato "[dd-mm-aaaa hh:mm:ss] mensagem\n".
+ * @details Não usa localtime() nem stdio (a conversão da data é aritmética, com o deslocamento
+ * para a hora local calculado pela thread), pelo que pode ser chamada dentro de um signal handler.
+ * @param entrada Registo a formatar.
+ * @param dest Buffer com pelo menos LOG_TAMANHO_MENSAGEM + 32 bytes.
+ * @return Número de bytes escritos.
+ */
+static size_t formatarEntrada(const EntradaLog *entrada, char *dest) {
+    long long local = (long long)entrada->quando + deslocamentoUtc;
+    long long dias = local / 86400;
+    long segundos = (long)(local % 86400);
+    if (segundos < 0) {
+        segundos += 86400;
+        dias--;
+    }
+
+    /* conversão de dias desde 1970-01-01 para data civil (calendário gregoriano) */
+    long long z = dias + 719468;
+    long long era = (z >= 0 ? z : z - 146096) / 146097;
+    long doe = (long)(z - era * 146097);
+    long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    long mp = (5 * doy + 2) / 153;
+    long dia = doy - (153 * mp + 2) / 5 + 1;
+    long mes = mp < 10 ? mp + 3 : mp - 9;
+    long ano = (long)(yoe + era * 400) + (mes <= 2);
+
+    char *p = dest;
+    *p++ = '[';
+    p = escreverAlgarismos(p, dia, 2);
+    *p++ = '-';
+    p = escreverAlgarismos(p, mes, 2);
+    *p++ = '-';
+    p = escreverAlgarismos(p, ano, 4);
+    *p++ = ' ';
+    p = escreverAlgarismos(p, segundos / 3600, 2);
+    *p++ = ':';
+    p = escreverAlgarismos(p, (segundos / 60) % 60, 2);
+    *p++ = ':';
+    p = escreverAlgarismos(p, segundos % 60, 2);
+    *p++ = ']';
+    *p++ = ' ';
+    for (const char *s = entrada->texto; *s != '\0'; s++) {
+        *p++ = *s;
+    }
+    *p++ = '\n';
+    return (size_t)(p - dest);
+}
+
+/**
+ * @brief Atualiza o deslocamento entre a hora local e UTC (muda com a hora de verão).
+ */
+static void atualizarDeslocamentoUtc(void) {
+    time_t agora = time(NULL);
+    struct tm local, utc;
+    if (localtime_r(&agora, &local) == NULL || gmtime_r(&agora, &utc) == NULL) return;
+
+    long dias = local.tm_yday - utc.tm_yday;
+    if (dias > 1) dias = -1;
+    else if (dias < -1) dias = 1;
+
+    deslocamentoUtc = dias * 86400L + (local.tm_hour - utc.tm_hour) * 3600L +
+                      (local.tm_min - utc.tm_min) * 60L + (local.tm_sec - utc.tm_sec);
+}
+
+/**
+ * @brief Thread que escreve os registos em lotes.
+ * @details Dorme sem limite de tempo enquanto o buffer estiver vazio e é acordada por colocarNoAnel()
+ * (quando o buffer deixa de estar vazio), por descarregarLogs() ou por terminarLogs(). Os registos
+ * feitos enquanto escreve um lote são apanhados de uma vez no lote seguinte.
+ */
+static void *escreverLogsThread(void *arg) {
+    (void)arg;
+    char linha[LOG_TAMANHO_MENSAGEM + 32];
+
+    pthread_mutex_lock(&mutexLogs);
+    while (1) {
+        while (inicio == fim && !terminar) {
+            pthread_cond_wait(&haRegistos, &mutexLogs);
+        }
+        if (inicio == fim) break;
+
+        size_t primeiro = inicio;
+        size_t n = fim - inicio;
+        for (size_t i = 0; i < n; i++) {
+            lote[i] = anel[(primeiro + i) % LOG_CAPACIDADE];
+        }
+        pthread_mutex_unlock(&mutexLogs);
+
+        atualizarDeslocamentoUtc();
+        if (ficheiroLog != NULL) {
+            for (size_t i = 0; i < n; i++) {
+                fwrite(linha, 1, formatarEntrada(&lote[i], linha), ficheiroLog);
+            }
+            fflush(ficheiroLog);
+        }
+
+        pthread_mutex_lock(&mutexLogs);
+        inicio = primeiro + n;
+        pthread_cond_broadcast(&haEspaco);
+        pthread_cond_broadcast(&escritos);
+    }
+    pthread_mutex_unlock(&mutexLogs);
+    return NULL;
+}
+
+/**
+ * @brief Handler de sinais fatais: escreve os registos que ainda estão no buffer e volta a lançar o sinal.
+ * @note Só usa write() e a formatação aritmética (async-signal-safe). Registos que a thread estava
+ * a escrever no momento do crash podem aparecer duplicados, mas nunca se perdem.
+ * @param sinal Sinal recebido.
+ */
+static void tratarSinalLogs(int sinal) {
+    int fd = descritorLog;
+    if (fd >= 0) {
+        char linha[LOG_TAMANHO_MENSAGEM + 32];
+        for (size_t i = inicio; i != fim; i++) {
+            ssize_t escrito = write(fd, linha, formatarEntrada(&anel[i % LOG_CAPACIDADE], linha));
+            (void)escrito;
+        }
+    }
+    signal(sinal, SIG_DFL);
+    raise(sinal);
+}
+
+/**
+ * @brief Inicia o registo assíncrono (buffer circular em memória e thread de escrita).
+ */
+void iniciarLogs(void) {
+    if (ativo) return;
+
+    ficheiroLog = fopen(FICHEIRO_LOG, "a");
+    if (ficheiroLog == NULL) return;
+    descritorLog = fileno(ficheiroLog);
+    atualizarDeslocamentoUtc();
+
+    terminar = 0;
+    if (pthread_create(&threadEscrita, NULL, escreverLogsThread, NULL) != 0) {
+        fclose(ficheiroLog);
+        ficheiroLog = NULL;
+        descritorLog = -1;
+        return;
+    }
+    ativo = 1;
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = tratarSinalLogs;
+    sigemptyset(&sa.sa_mask);
+    int sinais[] = { SIGSEGV, SIGABRT, SIGFPE, SIGBUS, SIGILL, SIGINT, SIGTERM, SIGHUP };
+    for (size_t i = 0; i < sizeof(sinais) / sizeof(sinais[0]); i++) {
+        sigaction(sinais[i], &sa, NULL);
+    }
+    atexit(terminarLogs);
+}
+
+/**
+ * @brief Escreve todos os registos pendentes e termina a thread de escrita.
+ */
+void terminarLogs(void) {
+    if (!ativo) return;
+
+    pthread_mutex_lock(&mutexLogs);
+    terminar = 1;
+    pthread_cond_signal(&haRegistos);
+    pthread_mutex_unlock(&mutexLogs);
+    pthread_join(threadEscrita, NULL);
+
+    ativo = 0;
+    descritorLog = -1;
+    fclose(ficheiroLog);
+    ficheiroLog = NULL;
+}
+
+/**
+ * @brief Bloqueia até todos os registos feitos até ao momento estarem escritos no ficheiro.
+ */
+void descarregarLogs(void) {
+    if (!ativo) return;
+
+    pthread_mutex_lock(&mutexLogs);
+    size_t alvo = fim;
+    pthread_cond_signal(&haRegistos);
+    while (inicio < alvo) {
+        pthread_cond_wait(&escritos, &mutexLogs);
+    }
+    pthread_mutex_unlock(&mutexLogs);
+}
+
+/**
+ * @brief Copia a mensagem para o buffer circular (se estiver cheio espera que a thread liberte espaço).
+ * @return 1 se a mensagem ficou no buffer, 0 se o registo assíncrono não estiver ativo.
+ */
+static int colocarNoAnel(time_t quando, const char *mensagem) {
+    pthread_mutex_lock(&mutexLogs);
+    if (!ativo || terminar) {
+        pthread_mutex_unlock(&mutexLogs);
+        return 0;
+    }
+    while (fim - inicio == LOG_CAPACIDADE) {
+        pthread_cond_signal(&haRegistos);
+        pthread_cond_wait(&haEspaco, &mutexLogs);
+    }
+
+    EntradaLog *entrada = &anel[fim % LOG_CAPACIDADE];
+    size_t tam = strlen(mensagem);
+    if (tam >= LOG_TAMANHO_MENSAGEM) tam = LOG_TAMANHO_MENSAGEM - 1;
+    entrada->quando = quando;
+    memcpy(entrada->texto, mensagem, tam);
+    entrada->texto[tam] = '\0';
+    fim++;
+
+    /* a thread só dorme com o buffer vazio, pelo que basta acordá-la no primeiro registo */
+    if (fim - inicio == 1) {
+        pthread_cond_signal(&haRegistos);
+    }
+    pthread_mutex_unlock(&mutexLogs);
+    return 1;
+}
+
+#else
+
+void iniciarLogs(void) {
+}
+
+void terminarLogs(void) {
+}
+
+void descarregarLogs(void) {
+}
+
+#endif /* LOGS_ASSINCRONOS */
+
+/**
+ * @brief Define a severidade mínima dos registos que são guardados.
+ * @param nivel Nível mínimo (os registos abaixo deste nível são ignorados).
+ */
+void definirNivelMinimoLog(NivelLog nivel) {
+    nivelMinimo = nivel;
+}
+
+/**
+ * @brief Regista uma mensagem com um nível de severidade explícito.
+ * @details Com o registo assíncrono ativo, o custo para quem chama é apenas copiar a mensagem para
+ * o buffer circular; a formatação da data e a escrita no disco são feitas pela thread em lotes.
+ * @param nivel Severidade da mensagem.
+ * @param mensagem Mensagem a registar.
+ */
+void registar_log_nivel(NivelLog nivel, const char *mensagem) {
+    if (mensagem == NULL || nivel < nivelMinimo) return;
+
+    time_t agora = time(NULL);
+#ifdef LOGS_ASSINCRONOS
+    if (colocarNoAnel(agora, mensagem)) return;
+#endif
+    escreverLogDireto(agora, mensagem);
+}
+
+/**
+* @brief Regista eventos críticos e falhas do sistema num ficheiro de auditoria.
+ * @details Conforme exigido pelo enunciado, permite a depuração e o acompanhamento
+ * do funcionamento do software através de carimbos temporais. [cite: 180, 181]
+ * @param mensagem Descrição do evento (ex: erro de memória ou ação de utilizador).
+ */
+void registar_log(const char *mensagem) {
+    if (mensagem == NULL) return;
+    registar_log_nivel(nivelDaMensagem(mensagem), mensagem);
+}
+
 /**
  * @brief Exibe o conteúdo do ficheiro de logs na consola.
  * @details Esta funcionalidade adicional permite que o administrador consulte
  * o histórico de ações e erros sem fechar a aplicação.
  */
 void consultar_logs() {
-    FILE *fp = fopen("log.txt", "r");
+    descarregarLogs();
+
+    FILE *fp = fopen(FICHEIRO_LOG, "r");
     if (fp == NULL) {
         printf("Ainda não existem registos de log.\n");
         return;
@@ -44,4 +379,4 @@ void consultar_logs() {
         printf("%s", linha);
     }
     fclose(fp);
-}
\ No newline at end of file
+}
@@ -9,16 +9,20 @@
 #include "../include/materiais.h"
 #include "../include/logs.h"
 #include "../include/relatorios.h"
+#include "../include/journal.h"
+#include "../include/despacho.h"
 
 
 /**
  * @brief Ponto de entrada principal do Sistema de Gestão de Manutenção de Ativos.
  * @details Gere o ciclo de vida da aplicação, incluindo a inicialização das estruturas,
- * o carregamento dos dados a partir de ficheiros binários (persistência) e a
- * exibição do menu principal. No encerramento, garante a salvaguarda dos dados.
+ * o carregamento dos dados a partir de ficheiros binários (persistência), a reposição
+ * do journal e a exibição do menu principal. No encerramento, garante a salvaguarda dos dados.
  * @return Retorna 0 após a execução bem-sucedida do programa.
  */
 int main(void) {
+    iniciarLogs();
+
     Departamentos *departamentos = malloc(sizeof(*departamentos));
     if (departamentos == NULL) {
         printf("ERRO: Falha ao alocar memoria para a estrutura Departamentos.\n");
@@ -29,6 +33,9 @@ int main(void) {
     departamentos->contador = 0;
     departamentos->departamentosAtivos = 0;
     departamentos->capacidade = 0;
+    inicializarIndice(&departamentos->indice);
+    departamentos->proximoID = 0;
+    inicializarPoolStrings(&departamentos->strings);
 
     Ativos *ativos = malloc(sizeof(*ativos));
     if (ativos == NULL) {
@@ -41,6 +48,11 @@ int main(void) {
     ativos->contador = 0;
     ativos->ativosDisponiveis = 0;
     ativos->capacidade = 0;
+    inicializarPoolStrings(&ativos->strings);
+    inicializarIndice(&ativos->indice);
+    ativos->proximoID = 0;
+    inicializarIndicePrefixos(&ativos->designacoes);
+    inicializarColunasAtivos(&ativos->colunas);
 
     Tecnicos *tecnicos = malloc(sizeof(*tecnicos));
     if (tecnicos == NULL) {
@@ -55,6 +67,9 @@ int main(void) {
     tecnicos->contador = 0;
     tecnicos->tecnicosAtivos = 0;
     tecnicos->capacidade = 0;
+    inicializarIndice(&tecnicos->indice);
+    tecnicos->proximoID = 0;
+    inicializarPoolStrings(&tecnicos->strings);
 
 
     Ordens *ordens = malloc(sizeof(*ordens));
@@ -70,11 +85,24 @@ int main(void) {
     ordens->contador = 0;
     ordens->ordensAtivas = 0;
     ordens->capacidade = 0;
+    ordens->mapa.base = NULL;
+    ordens->mapa.tamanho = 0;
+    inicializarIndice(&ordens->indice);
+    ordens->proximoID = 0;
+    ordens->anteriorDoAtivo = NULL;
+    ordens->capacidadeHistorico = 0;
+    inicializarFila(&ordens->pendentes);
+    ordens->resolucao = criarTemposResolucao();
+    inicializarAgregadoUrgencia(&ordens->urgencia);
+    inicializarColunasOrdens(&ordens->colunas);
+    inicializarBitmapsOrdens(&ordens->bitmaps);
 
     Materiais *materiais = malloc(sizeof(*materiais));
     if (materiais == NULL) {
         printf("ERRO: Falha ao alocar memoria para a estrutura Materiais.\n");
         registar_log("Erro: Falha na alocação de memória para a estrutura de Materiais");
+        libertarTemposResolucao(ordens->resolucao);
+        libertarAgregadoUrgencia(&ordens->urgencia);
         free(ordens);
         free(tecnicos);
         free(ativos);
@@ -84,12 +112,25 @@ int main(void) {
     materiais->material = NULL;
     materiais->contador = 0;
     materiais->capacidade = 0;
+    inicializarPoolStrings(&materiais->strings);
+    inicializarIndice(&materiais->porOrdem);
 
     carregarDepartamentos(departamentos);
     carregarAtivos(ativos);
     carregarTecnicos(tecnicos);
     carregarOrdens(ordens);
     carregarMateriais(materiais);
+
+    /* os contadores e os mapas de bits têm de refletir as ordens repostas antes de o checkpoint os gravar */
+    int repostos = recuperarJournal(departamentos, ativos, tecnicos, ordens, materiais);
+    reconstruirContadores(ordens, ativos, tecnicos);
+    if (repostos > 0) {
+        printf("Foram recuperadas alterações que não tinham sido gravadas na última sessão.\n");
+        checkpointJournal(departamentos, ativos, tecnicos, ordens, materiais);
+    }
+    abrirJournal();
+    ativarColunasAtivos(ativos);
+
     int escolha, escolha_ativos, escolha_departamentos, escolha_tecnico, escolha_manutencoes, escolha_relatorios;
     int sair = 0;
     do {
@@ -174,7 +215,7 @@ int main(void) {
                         listar_tecnicos(*tecnicos);
                         break;
                     case 3:
-                        desativar_tecnico(*tecnicos);
+                        desativar_tecnico(tecnicos);
                         break;
                     case 4:
                         pausar_ecra();
@@ -189,8 +230,11 @@ int main(void) {
                 printf("1 - Criar manutenção\n");
                 printf("2 - Gerir manutenção\n");
                 printf("3 - Listar manutenções\n");
-                printf("4 - Voltar\n");
-                escolha_manutencoes = obterIntIntervalado(1,4, "Indique qual opção deseja usar:\n");
+                printf("4 - Histórico de manutenções de um ativo\n");
+                printf("5 - Distribuir ordens pendentes automaticamente\n");
+                printf("6 - Pesquisar manutenções por critérios\n");
+                printf("7 - Voltar\n");
+                escolha_manutencoes = obterIntIntervalado(1,7, "Indique qual opção deseja usar:\n");
                 switch (escolha_manutencoes) {
                     case 1:
                         criar_ordem(ativos,ordens,*departamentos);
@@ -205,6 +249,18 @@ int main(void) {
                         pausar_ecra();
                         break;
                     case 4:
+                        listarHistoricoAtivo(ordens, ativos, materiais);
+                        pausar_ecra();
+                        break;
+                    case 5:
+                        despacharOrdensPendentes(ordens, tecnicos, ativos);
+                        pausar_ecra();
+                        break;
+                    case 6:
+                        pesquisarOrdens(ordens, materiais);
+                        pausar_ecra();
+                        break;
+                    case 7:
                         pausar_ecra();
                         break;
                     default:
@@ -221,8 +277,10 @@ int main(void) {
                 printf("5 - Ver relatório de ordens\n");
                 printf("6 - Ver relatório de ativos instáveis\n");
                 printf("7 - Ver relatório de problemas por local\n");
-                printf("8 - Voltar\n");
-                escolha_relatorios = obterIntIntervalado(1, 8, "Indique a opção que deseja utilizar\n");
+                printf("8 - Ver tempos de resolução (percentis)\n");
+                printf("9 - Ver ranking de técnicos\n");
+                printf("10 - Voltar\n");
+                escolha_relatorios = obterIntIntervalado(1, 10, "Indique a opção que deseja utilizar\n");
 
                 switch (escolha_relatorios) {
                     case 1:
@@ -238,7 +296,7 @@ int main(void) {
                         pausar_ecra();
                         break;
                     case 4:
-                        mostrarRelatorioTecnicos(tecnicos, ordens);
+                        mostrarRelatorioTecnicos(tecnicos);
                         pausar_ecra();
                         break;
                     case 5:
@@ -250,10 +308,32 @@ int main(void) {
                         pausar_ecra();
                         break;
                     case 7:
-                        relatorioProblemasPorLocal(*ativos, *ordens);
+                        relatorioProblemasPorLocal(ativos, ordens,
+                                                   obterIntIntervalado(0, ativos->contador, "Quantos locais deseja ver (0 = todos)? "));
                         pausar_ecra();
                         break;
                     case 8:
+                        relatorioTemposResolucao(ordens, departamentos, tecnicos);
+                        pausar_ecra();
+                        break;
+                    case 9: {
+                        MetricaRanking metrica = obterIntIntervalado(1, 3, "Ordenar por:\n1 - Ordens concluídas\n2 - Tempo mediano de resolução\n3 - Custo de materiais\n");
+                        /* o ranking é calculado uma vez; cada página só mostra entradas já ordenadas */
+                        RankingTecnicos ranking;
+                        if (calcularRankingTecnicos(tecnicos, ordens, materiais, metrica, 0, &ranking)) {
+                            int pagina = 0;
+                            mostrarPaginaRankingTecnicos(&ranking, tecnicos, pagina, RANKING_TAMANHO_PAGINA);
+                            while (ranking.classificados > (pagina + 1) * RANKING_TAMANHO_PAGINA &&
+                                   obterIntIntervalado(1, 2, "(1) Página seguinte (2) Voltar\n") == 1) {
+                                pagina++;
+                                mostrarPaginaRankingTecnicos(&ranking, tecnicos, pagina, RANKING_TAMANHO_PAGINA);
+                            }
+                            libertarRankingTecnicos(&ranking);
+                        }
+                        pausar_ecra();
+                        break;
+                    }
+                    case 10:
                         pausar_ecra();
                         break;
                     default:
@@ -272,12 +352,34 @@ int main(void) {
                 break;
         }
 
+#ifdef VERIFICAR_CONTADORES
+        verificarContadores(ordens, ativos, tecnicos);
+        verificarColunasAtivos(ativos);
+#endif
+        if (journalPrecisaCheckpoint()) {
+            checkpointJournal(departamentos, ativos, tecnicos, ordens, materiais);
+        }
     } while (sair == 0);
-    guardarDepartamentos(departamentos);
-    guardarAtivos(ativos);
-    guardarTecnicos(tecnicos);
-    guardarOrdens(ordens);
-    guardarMateriais(materiais);
+    checkpointJournal(departamentos, ativos, tecnicos, ordens, materiais);
+    fecharJournal();
+    terminarLogs();
+    libertarIndice(&ordens->indice);
+    free(ordens->anteriorDoAtivo);
+    libertarFila(&ordens->pendentes);
+    libertarTemposResolucao(ordens->resolucao);
+    libertarAgregadoUrgencia(&ordens->urgencia);
+    libertarColunasOrdens(&ordens->colunas);
+    libertarBitmapsOrdens(&ordens->bitmaps);
+    libertarIndice(&tecnicos->indice);
+    libertarIndice(&ativos->indice);
+    libertarIndicePrefixos(&ativos->designacoes);
+    libertarColunasAtivos(ativos);
+    libertarIndice(&departamentos->indice);
+    libertarIndice(&materiais->porOrdem);
+    libertarPoolStrings(&departamentos->strings);
+    libertarPoolStrings(&ativos->strings);
+    libertarPoolStrings(&tecnicos->strings);
+    libertarPoolStrings(&materiais->strings);
     free(ordens);
     free(tecnicos);
     free(ativos);
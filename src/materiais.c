@@ -6,9 +6,12 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include "../include/materiais.h"
 #include "../include/input.h"
 #include "../include/logs.h"
+#include "../include/snapshot.h"
+#include "../include/journal.h"
 #define CRESCIMENTO_5 5
 
 
@@ -38,73 +41,294 @@ static int garantirCapacidadeMateriais (Materiais *materiais, int minCap) {
     return 1;
 }
 
+/**
+ * @brief Liga o material na posição idx à lista de materiais da sua ordem.
+ * @details Cada material aponta para o anterior da mesma ordem e guarda o custo acumulado até si, pelo que
+ * o último material de uma ordem (guardado em porOrdem) tem o custo total da ordem. Como os materiais só
+ * são acrescentados, a soma é feita pela mesma ordem em que uma passagem por todo o array a faria.
+ * @param materiais Apontador para a estrutura que contém a lista de materiais.
+ * @param idx Posição do material a ligar.
+ */
+static void ligarMaterialOrdem (Materiais *materiais, int idx) {
+    Material *material = &materiais->material[idx];
+    int anterior = procurarIndice(&materiais->porOrdem, material->OrdemAssociada);
+    float custo = material->custoUnitário * (float)material->quantidade;
+
+    material->anteriorDaOrdem = anterior;
+    material->custoAcumulado = anterior == -1 ? custo : materiais->material[anterior].custoAcumulado + custo;
+    inserirIndice(&materiais->porOrdem, material->OrdemAssociada, idx);
+}
+
+/**
+ * @brief Reconstrói o índice de materiais por ordem a partir do array de materiais.
+ * @param materiais Apontador para a estrutura que contém a lista de materiais.
+ */
+static void indexarMateriais (Materiais *materiais) {
+    if (!limparIndice(&materiais->porOrdem, materiais->contador)) return;
+    for (int i = 0; i < materiais->contador; i++) {
+        ligarMaterialOrdem(materiais, i);
+    }
+}
+
+/**
+ * @brief Obtém o custo total dos materiais associados a uma ordem.
+ * @details O custo acumulado do último material da ordem já inclui todos os anteriores, pelo que
+ * a consulta é O(1), independentemente do número de materiais.
+ * @param materiais Apontador para a estrutura que contém a lista de materiais.
+ * @param idOrdem ID da ordem.
+ * @return Soma de custo unitário x quantidade dos materiais da ordem (0 se não tiver materiais).
+ */
+float custoMateriaisOrdem (const Materiais *materiais, int idOrdem) {
+    int ultimo = procurarIndice(&materiais->porOrdem, idOrdem);
+    if (ultimo == -1) return 0;
+    return materiais->material[ultimo].custoAcumulado;
+}
+
 /**
  * @brief Esta função serve para criar materiais novos que serão usados nas manutenções.
  * @param materiais Apontador para a estrutura que contém a lista de materiais e contador.
  * @param idx ID da ordem que será associada a este material.
- * @note Esta função utiliza funções como lerSringDinamica() e obterIntPositivo() para
- * ler strings e valores int.
+ * @note Esta função utiliza funções como lerStringPool() e obterIntPositivo() para
+ * ler strings e valores int (nomes repetidos partilham a mesma string do pool).
  */
 void adicionar_materiais (Materiais *materiais, int idx) {
     if (!garantirCapacidadeMateriais(materiais, materiais->contador + 1)) {
         pausar_ecra();
         return;
     }
-    materiais->material[materiais->contador].nomeMaterial = lerStringDinamica("Indique o nome do material que deseja usar:\n");
+    materiais->material[materiais->contador].nomeMaterial = lerStringPool(&materiais->strings, "Indique o nome do material que deseja usar:\n");
     materiais->material[materiais->contador].custoUnitário = obterFloatPositivo("Indique o preço por unidade do material:\n");
     materiais->material[materiais->contador].OrdemAssociada = idx;
     materiais->material[materiais->contador].quantidade = obterIntPositivo("Indique a quantidade deste material que deseja usar que deseja usar:\n");
+    ligarMaterialOrdem(materiais, materiais->contador);
     materiais->contador++;
+    journalMaterial(materiais, materiais->contador - 1);
     registar_log("Info: Foi adicionado um material a uma ordem/manutenção.");
 }
 
+/**
+ * @brief Registo de tamanho fixo de um material tal como é guardado no snapshot.
+ * @note O nome é guardado no heap de strings (secção 1) e aqui fica apenas o seu offset.
+ */
+typedef struct {
+    int32_t quantidade;
+    float custoUnitario;
+    int32_t OrdemAssociada;
+    uint32_t nomeMaterial;
+} MaterialDisco;
+
 /**
  * @brief Função que escreve as informações dos materiais num ficheiro binário.
+ * @details Tal como em ativos.bin, o ficheiro tem um CabecalhoSnapshot, o array de registos
+ * MaterialDisco e o heap com os nomes dos materiais.
  * @param materiais Apontador para a estrutura que contém as informações que serão escritas no ficheiro.
+ * @return 1 se o ficheiro foi gravado com sucesso, caso contrário 0.
  */
-void guardarMateriais (Materiais *materiais) {
+int guardarMateriais (Materiais *materiais) {
+    MaterialDisco *registos = NULL;
+    HeapStrings heap = {0};
+
+    if (materiais->contador > 0) {
+        registos = malloc((size_t)materiais->contador * sizeof(MaterialDisco));
+        if (registos == NULL) {
+            registar_log("Erro: Falha ao alocar memória para serializar materiais.");
+            return 0;
+        }
+    }
+
+    deduplicarHeapStrings(&heap, &materiais->strings);
+    for (int i = 0; i < materiais->contador; i++) {
+        registos[i].quantidade = materiais->material[i].quantidade;
+        registos[i].custoUnitario = materiais->material[i].custoUnitário;
+        registos[i].OrdemAssociada = materiais->material[i].OrdemAssociada;
+        registos[i].nomeMaterial = adicionarStringHeap(&heap, materiais->material[i].nomeMaterial);
+    }
 
-    FILE *fp = fopen ("materiais.bin", "wb");
+    FILE *fp = abrirSnapshotEscrita("materiais.bin");
     if (fp == NULL) {
         registar_log("Erro: Não foi possível abrir materiais.bin para escrita.");
-        return;
+        free(registos);
+        libertarHeapStrings(&heap);
+        return 0;
     }
 
-    fwrite(&materiais->contador, sizeof(int), 1, fp);
+    CabecalhoSnapshot cab;
+    inicializarCabecalhoSnapshot(&cab, materiais->contador, 0, sizeof(MaterialDisco));
+    cab.numSeccoes = 2;
+    cab.seccoes[0].tamanho = (uint64_t)materiais->contador * sizeof(MaterialDisco);
+    cab.seccoes[1].tamanho = heap.tamanho;
+    const void *blocos[] = { registos, heap.dados };
 
-    for (int i = 0; i<materiais->contador; i++) {
-        fwrite(&materiais->material[i].quantidade, sizeof(int), 1, fp);
-        fwrite (&materiais->material[i].custoUnitário, sizeof(float), 1, fp);
-        fwrite(&materiais->material[i].OrdemAssociada, sizeof(int), 1, fp);
-        escreverStringBinario(materiais->material[i].nomeMaterial, fp);
+    int sucesso = escreverSnapshot(fp, &cab, blocos);
+    if (!fecharSnapshotEscrita(fp, "materiais.bin", sucesso)) {
+        registar_log("Erro: Falha na escrita de materiais.bin.");
+        sucesso = 0;
     }
 
+    free(registos);
+    libertarHeapStrings(&heap);
+    return sucesso;
 }
 
 /**
- * @brief Função que guarda as informações dos materiais num ficheiro binário.
- * @param materiais Apontador para a estrutura com as informações que serão guardadas.
- * @warning A função utiliza malloc pelo que será necessário posteriormente libertar a memória heap.
+ * @brief Carrega os materiais a partir do formato antigo (sem cabeçalho, um fread por campo).
+ * @param materiais Apontador para a estrutura onde os dados serão carregados.
+ * @param fp Ficheiro aberto e posicionado no início.
+ * @note Os campos são lidos pela mesma ordem em que o formato antigo os escrevia.
  */
-void carregarMateriais (Materiais *materiais) {
-    FILE *fp = fopen ("materiais.bin", "rb");
-
-    if (fp == NULL) return;
-
+static void carregarMateriaisLegado (Materiais *materiais, FILE *fp) {
     fread(&materiais->contador, sizeof(int), 1, fp);
     materiais->capacidade = materiais->contador;
 
     materiais->material = malloc(materiais->capacidade * sizeof(Material));
     if (materiais->material == NULL && materiais->contador > 0) {
         registar_log("Erro: Falha ao alocar memória ao carregar materiais (malloc devolveu NULL).");
-        fclose(fp);
+        materiais->contador = 0;
+        materiais->capacidade = 0;
         return;
     }
 
     for (int i = 0; i < materiais->contador; i++) {
-        fread(&materiais->material[i].custoUnitário, sizeof(float), 1, fp);
         fread(&materiais->material[i].quantidade, sizeof(int), 1, fp);
+        fread(&materiais->material[i].custoUnitário, sizeof(float), 1, fp);
         fread(&materiais->material[i].OrdemAssociada, sizeof(int), 1, fp);
-        materiais->material[i].nomeMaterial = lerStringBinario(fp);
+        materiais->material[i].nomeMaterial = lerStringBinario(fp, &materiais->strings);
+    }
+}
+
+/**
+ * @brief Converte os registos MaterialDisco de um snapshot para o array de materiais.
+ * @param materiais Apontador para a estrutura com o array já alocado.
+ * @param cab Cabeçalho do snapshot.
+ * @param registos Array de registos lidos (ou mapeados) do ficheiro.
+ * @param heap Heap de strings do snapshot (os nomes são internados em materiais->strings).
+ */
+static void preencherMateriaisSnapshot (Materiais *materiais, const CabecalhoSnapshot *cab,
+                                        const MaterialDisco *registos, const char *heap) {
+    size_t tamanhoHeap = (size_t)cab->seccoes[1].tamanho;
+    for (int i = 0; i < cab->contador; i++) {
+        materiais->material[i].quantidade = registos[i].quantidade;
+        materiais->material[i].custoUnitário = registos[i].custoUnitario;
+        materiais->material[i].OrdemAssociada = registos[i].OrdemAssociada;
+        materiais->material[i].nomeMaterial = internarStringPool(&materiais->strings,
+                                                                 stringHeap(heap, tamanhoHeap, registos[i].nomeMaterial));
+    }
+    materiais->contador = cab->contador;
+    materiais->capacidade = cab->contador;
+}
+
+/**
+ * @brief Verifica se o cabeçalho corresponde à versão atual dos registos de materiais.
+ * @param cab Cabeçalho lido do ficheiro.
+ * @return 1 se for suportado, caso contrário 0.
+ */
+static int snapshotMateriaisValido (const CabecalhoSnapshot *cab) {
+    return cab->numSeccoes >= 2 && cab->tamanhoRegisto == sizeof(MaterialDisco) &&
+           cab->seccoes[0].tamanho == (uint64_t)cab->contador * sizeof(MaterialDisco);
+}
+
+/**
+ * @brief Carrega os materiais mapeando materiais.bin em memória.
+ * @details Os nomes dos materiais são internados em materiais->strings a partir do heap mapeado, sem um
+ * malloc por string (cada nome diferente é copiado uma vez). O ficheiro é desmapeado no fim da leitura.
+ * @param materiais Apontador para a estrutura onde os dados serão carregados.
+ * @return 1 se os materiais foram carregados, 0 se deve ser usada a leitura normal.
+ */
+static int carregarMateriaisMapeado (Materiais *materiais) {
+    CabecalhoSnapshot cab;
+    MapaSnapshot mapa;
+
+    if (!mapearSnapshot("materiais.bin", &mapa, &cab)) return 0;
+
+    if (!snapshotMateriaisValido(&cab)) {
+        desmapearSnapshot(&mapa);
+        return 0;
+    }
+
+    materiais->material = malloc(((size_t)cab.contador + 1) * sizeof(Material));
+    if (materiais->material == NULL) {
+        registar_log("Erro: Falha ao alocar memória ao carregar materiais (malloc devolveu NULL).");
+        desmapearSnapshot(&mapa);
+        return 1;
+    }
+
+    preencherMateriaisSnapshot(materiais, &cab, seccaoMapeada(&mapa, &cab, 0), seccaoMapeada(&mapa, &cab, 1));
+    desmapearSnapshot(&mapa);
+    return 1;
+}
+
+/**
+ * @brief Lê materiais.bin para o array de materiais.
+ * @details Tenta primeiro mapear o ficheiro; caso não seja possível lê as duas secções com um fread
+ * cada, ou usa o leitor do formato antigo se o ficheiro não tiver cabeçalho.
+ * @param materiais Apontador para a estrutura onde as informações serão carregadas.
+ */
+static void lerFicheiroMateriais (Materiais *materiais) {
+    if (carregarMateriaisMapeado(materiais)) return;
+
+    FILE *fp = fopen ("materiais.bin", "rb");
+
+    if (fp == NULL) return;
+
+    CabecalhoSnapshot cab;
+    if (!lerCabecalhoSnapshot(fp, &cab)) {
+        carregarMateriaisLegado(materiais, fp);
+        fclose(fp);
+        return;
     }
-}
\ No newline at end of file
+
+    if (!snapshotMateriaisValido(&cab)) {
+        registar_log("Erro: materiais.bin tem um formato/versão não suportado.");
+        fclose(fp);
+        return;
+    }
+
+    MaterialDisco *registos = malloc((size_t)cab.seccoes[0].tamanho + 1);
+    char *heap = malloc((size_t)cab.seccoes[1].tamanho + 1);
+    materiais->material = malloc(((size_t)cab.contador + 1) * sizeof(Material));
+
+    if (registos == NULL || heap == NULL || materiais->material == NULL ||
+        !lerSeccaoSnapshot(fp, &cab, 0, registos) || !lerSeccaoSnapshot(fp, &cab, 1, heap)) {
+        registar_log("Erro: Falha ao carregar materiais.bin (memória insuficiente ou ficheiro corrompido).");
+        free(registos);
+        free(heap);
+        free(materiais->material);
+        materiais->material = NULL;
+        fclose(fp);
+        return;
+    }
+    fclose(fp);
+
+    preencherMateriaisSnapshot(materiais, &cab, registos, heap);
+
+    free(registos);
+    free(heap);
+}
+
+/**
+ * @brief Função que carrega as informações dos materiais a partir de um ficheiro binário.
+ * @details Depois da leitura (lerFicheiroMateriais) é reconstruído o índice de materiais por ordem.
+ * @param materiais Apontador para a estrutura onde as informações serão carregadas.
+ * @warning A função utiliza malloc pelo que será necessário posteriormente libertar a memória heap.
+ */
+void carregarMateriais (Materiais *materiais) {
+    lerFicheiroMateriais(materiais);
+    indexarMateriais(materiais);
+}
+
+/**
+ * @brief Repõe um material registado no journal.
+ * @details Os materiais não têm ID, por isso é usada a posição no array: se o material já existir
+ * (idx menor que o contador) o registo é ignorado, o que torna a reposição idempotente.
+ * @param materiais Apontador para a estrutura que contém a lista de materiais.
+ * @param idx Posição do material no momento do registo.
+ * @param material Material lido do journal (o nome é copiado para materiais->strings).
+ */
+void reporMaterial (Materiais *materiais, int idx, const Material *material) {
+    if (idx < materiais->contador) return;
+    if (!garantirCapacidadeMateriais(materiais, materiais->contador + 1)) return;
+    materiais->material[materiais->contador] = *material;
+    materiais->material[materiais->contador].nomeMaterial = internarStringPool(&materiais->strings, material->nomeMaterial);
+    ligarMaterialOrdem(materiais, materiais->contador);
+    materiais->contador++;
+}
@@ -6,7 +6,8 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
+#include <stdint.h>
+#include <string.h>
 #include "../include/ordem.h"
 #include "../include/ativos.h"
 #include "../include/departamentos.h"
@@ -14,98 +15,815 @@
 #include "../include/tecnicos.h"
 #include "../include/materiais.h"
 #include "../include/logs.h"
+#include "../include/snapshot.h"
+#include "../include/journal.h"
 
 #define CRESCIMENTO_5 5
+#define BITMAPS_ORDENS 9 /**< Mapas de bits gravados em ordens.bin: 4 estados, 3 prioridades e 2 tipos */
 
 
 /**
- * @brief Função que procura o maior ID registado nas ordens.
+ * @brief Função que devolve o maior ID já atribuído a uma ordem.
  * @param ordens Estrutura com o array de ordens e contador.
- * @return Retorna o maior ID registado. Caso não existam ordens devolve 0.
+ * @return Retorna o último ID atribuído (lido do contador proximoID), ou 0 se ainda não foi atribuído nenhum.
  */
 int obterMaiorIDOrdens(Ordens ordens) {
-    int maxID = 0;
-    for (int i = 0; i < ordens.contador; i++) {
-        if (ordens.ordem[i].idOrdem > maxID) {
-            maxID = ordens.ordem[i].idOrdem;
-        }
-    }
-    return maxID;
+    return ordens.proximoID > 0 ? ordens.proximoID - 1 : 0;
 }
 
 
 /**
- * @brief Função que conta o número de ordens em execução associadas ao tecnico que analisa.
- * @param tecnico Estrutura do tipo Tecnico que contem os dados do tecnico a analisar
- * @param ordens Estrutura que contem o array e o contador total de ordens.
+ * @brief Função que devolve o número de ordens em execução associadas ao tecnico que analisa.
+ * @param tecnico Apontador para o tecnico a analisar.
  * @return Retorna o numero total de ordens em execução associadas ao tecnico.
+ * @note O valor é mantido por contabilizarOrdem(), pelo que não percorre as ordens.
+ */
+int numeroManutencoesTecnico (const Tecnico *tecnico) {
+    return tecnico->ordensEmExecucao;
+}
+
+/**
+ * @brief Chave de uma ordem na fila de pendentes: prioridade mais alta primeiro e, em empate, a mais antiga.
+ * @details Os IDs são atribuídos por ordem de criação (gerarProximoID), pelo que o ID serve de antiguidade.
+ * @param ordem Apontador para a ordem.
+ * @return Chave (a menor sai primeiro da fila).
+ */
+static int64_t chavePendente (const Ordem *ordem) {
+    return ((int64_t)(ALTA - ordem->prioridade) << 32) | (uint32_t)ordem->idOrdem;
+}
+
+/**
+ * @brief Volta a preencher o conjunto de ordens em execução de um técnico a partir das ordens.
+ * @details Só é usada quando o técnico tem mais de LIMITE_ORDENS_TECNICO ordens em execução (dados antigos
+ * ou editados à mão) e sai do conjunto uma ordem guardada: as que não cabiam passam a ocupar o seu lugar.
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param tecnico Apontador para o técnico.
+ * @param idIgnorar ID da ordem que está a sair de EXECUCAO (ainda tem esse estado).
  */
-int numeroManutencoesTecnico (Tecnico tecnico, Ordens ordens) {
-    int numero = 0;
-    for (int i = 0; i<ordens.contador; i++) {
-        if (ordens.ordem[i].estado == EXECUCAO) {
-            if (ordens.ordem[i].idTecnico == tecnico.idTecnico) {
-                numero++;
+static void reconstruirOrdensEmExecucao (const Ordens *ordens, Tecnico *tecnico, int idIgnorar) {
+    int guardados = 0;
+    for (int i = 0; i < ordens->contador && guardados < LIMITE_ORDENS_TECNICO; i++) {
+        const Ordem *ordem = &ordens->ordem[i];
+        if (ordem->estado == EXECUCAO && ordem->idTecnico == tecnico->idTecnico && ordem->idOrdem != idIgnorar) {
+            tecnico->idsEmExecucao[guardados++] = ordem->idOrdem;
+        }
+    }
+}
+
+/**
+ * @brief Acrescenta ou retira uma ordem do conjunto de ordens em execução de um técnico.
+ * @details O conjunto tem no máximo LIMITE_ORDENS_TECNICO elementos (limite verificado na atribuição),
+ * pelo que retirar é uma procura linear curta seguida de troca com o último elemento. Se o técnico tiver
+ * mais ordens do que as guardadas, retirar uma guardada reconstrói o conjunto (reconstruirOrdensEmExecucao()).
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param tecnico Apontador para o técnico.
+ * @param idOrdem ID da ordem.
+ * @param delta 1 para acrescentar, -1 para retirar.
+ */
+static void atualizarOrdensEmExecucao (const Ordens *ordens, Tecnico *tecnico, int idOrdem, int delta) {
+    int guardados = tecnico->ordensEmExecucao < LIMITE_ORDENS_TECNICO ? tecnico->ordensEmExecucao : LIMITE_ORDENS_TECNICO;
+
+    if (delta > 0) {
+        if (guardados < LIMITE_ORDENS_TECNICO) {
+            tecnico->idsEmExecucao[guardados] = idOrdem;
+        }
+        tecnico->ordensEmExecucao++;
+        return;
+    }
+
+    for (int k = 0; k < guardados; k++) {
+        if (tecnico->idsEmExecucao[k] == idOrdem) {
+            if (tecnico->ordensEmExecucao > LIMITE_ORDENS_TECNICO) {
+                reconstruirOrdensEmExecucao(ordens, tecnico, idOrdem);
+            } else {
+                tecnico->idsEmExecucao[k] = tecnico->idsEmExecucao[guardados - 1];
             }
+            break;
         }
     }
-    return numero;
+    tecnico->ordensEmExecucao--;
 }
 
-static const char *passarIntStringPrioridade (Prioridade prioridade) {
+/**
+ * @brief Devolve o tempo de resolução de uma ordem.
+ * @param ordem Apontador para a ordem.
+ * @return Segundos entre o início e o fim, ou -1 se a ordem não tiver as duas datas (ou forem incoerentes).
+ */
+int64_t tempoResolucaoOrdem (const Ordem *ordem) {
+    if (ordem->inicio == SEM_DATA || ordem->fim == SEM_DATA || ordem->fim < ordem->inicio) return -1;
+    return ordem->fim - ordem->inicio;
+}
+
+/**
+ * @brief Soma ou retira o tempo de resolução de uma ordem concluída de todos os histogramas.
+ * @param resolucao Apontador para os histogramas.
+ * @param ordem Apontador para a ordem (CONCLUIDA).
+ * @param delta 1 para somar, -1 para retirar.
+ */
+static void contabilizarResolucao (TemposResolucao *resolucao, const Ordem *ordem, int delta) {
+    int64_t segundos = tempoResolucaoOrdem(ordem);
+    if (segundos < 0) return;
+
+    registarTempo(&resolucao->geral, segundos, delta);
+    if (ordem->prioridade >= BAIXA) {
+        registarTempo(&resolucao->porPrioridade[ordem->prioridade], segundos, delta);
+    }
+    if (ordem->tipo_manutencao >= PREVENTIVA && ordem->tipo_manutencao <= CORRETIVA) {
+        registarTempo(&resolucao->porTipo[ordem->tipo_manutencao], segundos, delta);
+    }
+
+    HistogramaTempos *histograma = histogramaDoID(&resolucao->porDepartamento, ordem->idDepartamento);
+    if (histograma != NULL) registarTempo(histograma, segundos, delta);
+    histograma = histogramaDoID(&resolucao->porTecnico, ordem->idTecnico);
+    if (histograma != NULL) registarTempo(histograma, segundos, delta);
+}
+
+/**
+ * @brief Peso de uma prioridade no cálculo da urgência de um departamento.
+ * @param prioridade Prioridade da ordem.
+ * @return 1 para BAIXA, 3 para MEDIA, 5 para ALTA e 0 para valores desconhecidos.
+ */
+static int pesoPrioridade (Prioridade prioridade) {
     switch (prioridade) {
         case BAIXA:
-            return "Baixa";
+            return 1;
         case MEDIA:
-            return "Media";
+            return 3;
         case ALTA:
-            return "Alta";
+            return 5;
         default:
-            return "Desconhecido";
+            return 0;
     }
 }
 
-float calcularCustos (Ordem *ordem, Materiais *materiais) {
-    float total = 0;
+/**
+ * @brief Calcula 2^expoente por quadrados sucessivos (evita depender da biblioteca matemática).
+ * @param expoente Expoente (limitado a [-1000, 1000]).
+ * @return 2 elevado ao expoente.
+ */
+static double potenciaDeDois (int64_t expoente) {
+    if (expoente > 1000) expoente = 1000;
+    if (expoente < -1000) expoente = -1000;
+
+    double base = expoente < 0 ? 0.5 : 2.0;
+    int64_t restante = expoente < 0 ? -expoente : expoente;
+    double resultado = 1.0;
+    while (restante > 0) {
+        if (restante & 1) resultado *= base;
+        base *= base;
+        restante >>= 1;
+    }
+    return resultado;
+}
 
-    if (ordem == NULL || materiais == NULL) {
+/**
+ * @brief Devolve o período de decaimento (de URGENCIA_MEIA_VIDA segundos) a que pertence um instante.
+ * @param referencia Início do período 0.
+ * @param instante Instante a classificar.
+ * @return Número do período (negativo antes da referência).
+ */
+static int64_t periodoDecaimento (Timestamp referencia, Timestamp instante) {
+    int64_t diferenca = instante - referencia;
+    int64_t periodo = diferenca / URGENCIA_MEIA_VIDA;
+    if (diferenca % URGENCIA_MEIA_VIDA < 0) periodo--;
+    return periodo;
+}
+
+/**
+ * @brief Inicializa um agregado de urgência vazio (não aloca memória).
+ * @param urgencia Apontador para o agregado.
+ */
+void inicializarAgregadoUrgencia (AgregadoUrgencia *urgencia) {
+    urgencia->departamentos = NULL;
+    urgencia->contador = 0;
+    urgencia->capacidade = 0;
+    inicializarIndice(&urgencia->indice);
+    urgencia->referencia = timestampAtual();
+}
+
+/**
+ * @brief Liberta a memória de um agregado de urgência.
+ * @param urgencia Apontador para o agregado.
+ */
+void libertarAgregadoUrgencia (AgregadoUrgencia *urgencia) {
+    free(urgencia->departamentos);
+    libertarIndice(&urgencia->indice);
+    inicializarAgregadoUrgencia(urgencia);
+}
+
+/**
+ * @brief Devolve a urgência de um departamento, acrescentando-o ao agregado se ainda não existir.
+ * @param urgencia Apontador para o agregado.
+ * @param idDepartamento ID do departamento.
+ * @return Apontador para a urgência ou NULL se não houver memória.
+ */
+static UrgenciaDepartamento *urgenciaDoDepartamento (AgregadoUrgencia *urgencia, int idDepartamento) {
+    int pos = procurarIndice(&urgencia->indice, idDepartamento);
+    if (pos != -1) return &urgencia->departamentos[pos];
+
+    if (urgencia->contador >= urgencia->capacidade) {
+        int novaCap = urgencia->capacidade > 0 ? urgencia->capacidade * 2 : 8;
+        UrgenciaDepartamento *tmp = realloc(urgencia->departamentos, (size_t)novaCap * sizeof(UrgenciaDepartamento));
+        if (tmp == NULL) {
+            registar_log("Erro: Falha no realloc ao tentar expandir a urgência dos departamentos.");
+            return NULL;
+        }
+        urgencia->departamentos = tmp;
+        urgencia->capacidade = novaCap;
+    }
+    if (!inserirIndice(&urgencia->indice, idDepartamento, urgencia->contador)) return NULL;
+
+    UrgenciaDepartamento *departamento = &urgencia->departamentos[urgencia->contador++];
+    memset(departamento, 0, sizeof(*departamento));
+    departamento->idDepartamento = idDepartamento;
+    return departamento;
+}
+
+/**
+ * @brief Procura a urgência de um departamento. O(1).
+ * @param urgencia Apontador para o agregado.
+ * @param idDepartamento ID do departamento.
+ * @return Apontador para a urgência ou NULL se o departamento não tiver ordens.
+ */
+const UrgenciaDepartamento *procurarUrgenciaDepartamento (const AgregadoUrgencia *urgencia, int idDepartamento) {
+    int pos = procurarIndice(&urgencia->indice, idDepartamento);
+    return pos != -1 ? &urgencia->departamentos[pos] : NULL;
+}
+
+/**
+ * @brief Calcula a urgência total de um departamento.
+ * @details Cada ordem fechada é guardada com o peso multiplicado por 2^p, em que p é o período do fecho; a
+ * multiplicação por 2^-p(agora) faz com que cada uma conte peso * 2^-(p(agora) - p(fecho)), sem percorrer as ordens.
+ * @param urgencia Apontador para o agregado.
+ * @param departamento Apontador para a urgência do departamento.
+ * @param agora Instante de referência para o decaimento.
+ * @param comDecaimento 1 para aplicar o decaimento às ordens fechadas, 0 para somar todos os pesos.
+ * @return Urgência do departamento.
+ */
+double urgenciaDepartamento (const AgregadoUrgencia *urgencia, const UrgenciaDepartamento *departamento,
+                             Timestamp agora, int comDecaimento) {
+    if (!comDecaimento) {
+        return departamento->urgenciaAbertas + departamento->urgenciaFechadas;
+    }
+
+    double fechadas = departamento->fechadasPonderadas * potenciaDeDois(-periodoDecaimento(urgencia->referencia, agora));
+    if (fechadas < 0) fechadas = 0;
+    return departamento->urgenciaAbertas + fechadas;
+}
+
+/**
+ * @brief Soma ou retira uma ordem da urgência do seu departamento.
+ * @param urgencia Apontador para o agregado.
+ * @param ordem Apontador para a ordem.
+ * @param delta 1 para somar, -1 para retirar.
+ * @note As ordens fechadas sem data de fim (ficheiros antigos) contam como fechadas na referência.
+ */
+static void contabilizarUrgencia (AgregadoUrgencia *urgencia, const Ordem *ordem, int delta) {
+    UrgenciaDepartamento *departamento = urgenciaDoDepartamento(urgencia, ordem->idDepartamento);
+    if (departamento == NULL) return;
+
+    int peso = pesoPrioridade(ordem->prioridade);
+    if (ordem->estado == PENDENTE || ordem->estado == EXECUCAO) {
+        departamento->abertas += delta;
+        departamento->urgenciaAbertas += delta * peso;
+    } else if (ordem->estado == CONCLUIDA || ordem->estado == CANCELADA) {
+        Timestamp fecho = ordem->fim != SEM_DATA ? ordem->fim : urgencia->referencia;
+        departamento->fechadas += delta;
+        departamento->urgenciaFechadas += delta * peso;
+        departamento->fechadasPonderadas += delta * peso * potenciaDeDois(periodoDecaimento(urgencia->referencia, fecho));
+    }
+}
+
+/**
+ * @brief Inicializa as colunas das ordens vazias (não aloca memória).
+ * @param colunas Apontador para as colunas.
+ */
+void inicializarColunasOrdens (ColunasOrdens *colunas) {
+    memset(colunas, 0, sizeof(*colunas));
+}
+
+/**
+ * @brief Liberta a memória das colunas das ordens.
+ * @param colunas Apontador para as colunas.
+ */
+void libertarColunasOrdens (ColunasOrdens *colunas) {
+    free(colunas->estado);
+    free(colunas->prioridade);
+    free(colunas->tipo);
+    free(colunas->idDepartamento);
+    inicializarColunasOrdens(colunas);
+}
+
+/**
+ * @brief Garante que as colunas das ordens têm espaço para pelo menos minCap ordens.
+ * @details Tal como anteriorDoAtivo, as colunas crescem para a capacidade atual das ordens. Se faltar memória
+ * ficam desligadas até ao fim da sessão (uma ordem sem coluna deixaria os filtros errados).
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param minCap Capacidade mínima pretendida.
+ * @return 1 se as colunas tiverem espaço, 0 se estiverem desligadas.
+ */
+static int garantirCapacidadeColunasOrdens (Ordens *ordens, int minCap) {
+    ColunasOrdens *colunas = &ordens->colunas;
+    if (colunas->desligadas) return 0;
+    if (colunas->capacidade >= minCap) return 1;
+
+    size_t novaCap = (size_t)(ordens->capacidade > minCap ? ordens->capacidade : minCap);
+    void *tmp;
+    int sucesso = 0;
+    do {
+        if ((tmp = realloc(colunas->estado, novaCap * sizeof(uint8_t))) == NULL) break;
+        colunas->estado = tmp;
+        if ((tmp = realloc(colunas->prioridade, novaCap * sizeof(uint8_t))) == NULL) break;
+        colunas->prioridade = tmp;
+        if ((tmp = realloc(colunas->tipo, novaCap * sizeof(uint8_t))) == NULL) break;
+        colunas->tipo = tmp;
+        if ((tmp = realloc(colunas->idDepartamento, novaCap * sizeof(int32_t))) == NULL) break;
+        colunas->idDepartamento = tmp;
+        sucesso = 1;
+    } while (0);
+
+    if (!sucesso) {
+        registar_log("Erro: Falha ao expandir as colunas das ordens; os filtros passam a percorrer o array de ordens.");
+        libertarColunasOrdens(colunas);
+        colunas->desligadas = 1;
         return 0;
     }
+    colunas->capacidade = (int)novaCap;
+    return 1;
+}
+
+/**
+ * @brief Inicializa os mapas de bits das ordens vazios (não aloca memória).
+ * @param bitmaps Apontador para os mapas.
+ */
+void inicializarBitmapsOrdens (BitmapsOrdens *bitmaps) {
+    for (int e = PENDENTE; e <= CANCELADA; e++) inicializarSelecao(&bitmaps->porEstado[e]);
+    for (int p = 0; p <= ALTA; p++) inicializarSelecao(&bitmaps->porPrioridade[p]);
+    for (int t = 0; t <= CORRETIVA; t++) inicializarSelecao(&bitmaps->porTipo[t]);
+    bitmaps->carregados = 0;
+    bitmaps->desligados = 0;
+}
+
+/**
+ * @brief Liberta a memória dos mapas de bits das ordens.
+ * @param bitmaps Apontador para os mapas.
+ */
+void libertarBitmapsOrdens (BitmapsOrdens *bitmaps) {
+    for (int e = PENDENTE; e <= CANCELADA; e++) libertarSelecao(&bitmaps->porEstado[e]);
+    for (int p = 0; p <= ALTA; p++) libertarSelecao(&bitmaps->porPrioridade[p]);
+    for (int t = 0; t <= CORRETIVA; t++) libertarSelecao(&bitmaps->porTipo[t]);
+    bitmaps->carregados = 0;
+}
+
+/**
+ * @brief Devolve um dos mapas de bits pela ordem em que são gravados em ordens.bin.
+ * @param bitmaps Apontador para os mapas.
+ * @param k Número do mapa (0 a 3: estados, 4 a 6: prioridades, 7 e 8: tipos).
+ * @return Apontador para o mapa.
+ */
+static Selecao *bitmapOrdens (BitmapsOrdens *bitmaps, int k) {
+    if (k <= CANCELADA) return &bitmaps->porEstado[PENDENTE + k];
+    if (k < 7) return &bitmaps->porPrioridade[BAIXA + k - 4];
+    return &bitmaps->porTipo[PREVENTIVA + k - 7];
+}
+
+/**
+ * @brief Indica se o número de bits de cada mapa coincide com o contador correspondente (porEstado, porPrioridade, porTipo).
+ * @details Custa O(N / 64) e apanha mapas gravados antes de as ordens mudarem (uma ordem marcada em dois estados).
+ * @param ordens Apontador para a estrutura de ordens.
+ * @return 1 se todos os mapas coincidirem, caso contrário 0.
+ */
+static int bitmapsCoincidemContadores (Ordens *ordens) {
+    for (int k = 0; k < BITMAPS_ORDENS; k++) {
+        int esperado;
+        if (k <= CANCELADA) esperado = ordens->porEstado[PENDENTE + k];
+        else if (k < 7) esperado = ordens->porPrioridade[BAIXA + k - 4];
+        else esperado = ordens->porTipo[PREVENTIVA + k - 7];
+        if (contarSelecao(bitmapOrdens(&ordens->bitmaps, k)) != esperado) return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Marca (delta = 1) ou desmarca (delta = -1) uma ordem nos mapas do seu estado, prioridade e tipo. O(1).
+ * @details Se faltar memória os mapas são desligados até ao fim da sessão.
+ * @param bitmaps Apontador para os mapas.
+ * @param ordem Apontador para a ordem.
+ * @param idxOrdem Posição da ordem no array.
+ * @param delta 1 para marcar, -1 para desmarcar.
+ */
+static void contabilizarBitmaps (BitmapsOrdens *bitmaps, const Ordem *ordem, int idxOrdem, int delta) {
+    if (bitmaps->desligados) return;
+
+    int selecionado = delta > 0;
+    int sucesso = alterarSelecionado(&bitmaps->porEstado[ordem->estado], idxOrdem, selecionado);
+    if (ordem->prioridade >= BAIXA) {
+        sucesso &= alterarSelecionado(&bitmaps->porPrioridade[ordem->prioridade], idxOrdem, selecionado);
+    }
+    if (ordem->tipo_manutencao >= PREVENTIVA && ordem->tipo_manutencao <= CORRETIVA) {
+        sucesso &= alterarSelecionado(&bitmaps->porTipo[ordem->tipo_manutencao], idxOrdem, selecionado);
+    }
+    if (!sucesso) {
+        registar_log("Erro: Falha ao expandir os mapas de bits das ordens; as listagens passam a usar filtros.");
+        libertarBitmapsOrdens(bitmaps);
+        bitmaps->desligados = 1;
+    }
+}
+
+/**
+ * @brief Soma (delta = 1) ou retira (delta = -1) uma ordem de todos os contadores que dela dependem.
+ * @details É o único sítio onde os contadores são alterados: as funções que mudam o estado de uma ordem
+ * retiram-na antes da alteração e voltam a somá-la depois.
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param ativos Apontador para a estrutura de ativos (pode ser NULL).
+ * @param tecnicos Apontador para a estrutura de técnicos (pode ser NULL se a ordem não tiver técnico).
+ * @param idxOrdem Posição da ordem a contabilizar.
+ * @param delta 1 para somar, -1 para retirar.
+ * @note As ordens PENDENTE entram (delta = 1) e saem (delta = -1) da fila de pendentes e as CONCLUIDA
+ * dos histogramas de tempos de resolução (a data de fim tem de ser preenchida antes de a somar).
+ * Ao somar, a ordem é também copiada para as colunas usadas pelos filtros e marcada nos mapas de bits.
+ */
+static void contabilizarOrdem (Ordens *ordens, Ativos *ativos, Tecnicos *tecnicos, int idxOrdem, int delta) {
+    const Ordem *ordem = &ordens->ordem[idxOrdem];
+
+    if (delta > 0 && garantirCapacidadeColunasOrdens(ordens, idxOrdem + 1)) {
+        ordens->colunas.estado[idxOrdem] = (uint8_t)ordem->estado;
+        ordens->colunas.prioridade[idxOrdem] = (uint8_t)ordem->prioridade;
+        ordens->colunas.tipo[idxOrdem] = (uint8_t)ordem->tipo_manutencao;
+        ordens->colunas.idDepartamento[idxOrdem] = ordem->idDepartamento;
+    }
+
+    contabilizarBitmaps(&ordens->bitmaps, ordem, idxOrdem, delta);
+    if (ordem->estado == PENDENTE) {
+        if (delta > 0) {
+            inserirFila(&ordens->pendentes, idxOrdem, chavePendente(ordem));
+        } else {
+            removerFila(&ordens->pendentes, idxOrdem);
+        }
+    }
+    if (ordem->estado == CONCLUIDA && ordens->resolucao != NULL) {
+        contabilizarResolucao(ordens->resolucao, ordem, delta);
+    }
+    contabilizarUrgencia(&ordens->urgencia, ordem, delta);
+    ordens->porEstado[ordem->estado] += delta; /* 2 bits: sempre entre PENDENTE e CANCELADA */
+    if (ordem->prioridade >= BAIXA) {
+        ordens->porPrioridade[ordem->prioridade] += delta;
+    }
+    if (ordem->tipo_manutencao >= PREVENTIVA && ordem->tipo_manutencao <= CORRETIVA) {
+        ordens->porTipo[ordem->tipo_manutencao] += delta;
+    }
 
-    if (materiais->contador == 0) {
+    if (ativos != NULL) {
+        int idxAtivo = procurarIndice(&ativos->indice, ordem->idAtivo);
+        if (idxAtivo != -1) {
+            ativos->ativo[idxAtivo].totalOrdens += delta;
+            if (ordem->tipo_manutencao == CORRETIVA && ordem->estado != CANCELADA) {
+                somarCorretivasAtivo(ativos, idxAtivo, delta);
+            }
+        }
+    }
+
+    if (tecnicos != NULL && (ordem->estado == EXECUCAO || ordem->estado == CONCLUIDA)) {
+        int idxTec = procurarIndice(&tecnicos->indice, ordem->idTecnico);
+        if (idxTec != -1) {
+            if (ordem->estado == EXECUCAO) {
+                atualizarOrdensEmExecucao(ordens, &tecnicos->tecnico[idxTec], ordem->idOrdem, delta);
+            } else {
+                tecnicos->tecnico[idxTec].ordensConcluidas += delta;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Garante que o array anteriorDoAtivo tem espaço para pelo menos minCap ordens.
+ * @details O array é paralelo ao das ordens (não pode ficar dentro de Ordem, que é gravada tal como está
+ * em ordens.bin) e cresce para a capacidade atual das ordens.
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param minCap Capacidade mínima pretendida.
+ * @return Retorna 1 caso a alocação seja feita com sucesso, caso contrário retorna 0.
+ */
+static int garantirCapacidadeHistorico (Ordens *ordens, int minCap) {
+    if (ordens->capacidadeHistorico >= minCap) return 1;
+
+    int novaCap = ordens->capacidade > minCap ? ordens->capacidade : minCap;
+    int *tmp = realloc(ordens->anteriorDoAtivo, (size_t)novaCap * sizeof(int));
+    if (tmp == NULL) {
+        printf("Erro: sem memória para o histórico de ordens dos ativos.\n");
+        registar_log("Erro: Falha no realloc ao tentar expandir o histórico de ordens dos ativos.");
         return 0;
     }
+    ordens->anteriorDoAtivo = tmp;
+    ordens->capacidadeHistorico = novaCap;
+    return 1;
+}
+
+/**
+ * @brief Acrescenta uma ordem ao início da lista de ordens do seu ativo.
+ * @details Cada ativo guarda a posição da sua ordem mais recente (ultimaOrdem) e cada ordem a posição da
+ * anterior do mesmo ativo, pelo que o histórico de um ativo é percorrido sem ver as restantes ordens.
+ * As ordens nunca são removidas nem mudam de ativo, por isso basta ligar cada ordem uma vez.
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param ativos Apontador para a estrutura de ativos.
+ * @param idxOrdem Posição da ordem no array.
+ * @return 1 em caso de sucesso, 0 se não houver memória.
+ */
+static int ligarOrdemAtivo (Ordens *ordens, Ativos *ativos, int idxOrdem) {
+    if (!garantirCapacidadeHistorico(ordens, idxOrdem + 1)) return 0;
+
+    int idxAtivo = procurarIndice(&ativos->indice, ordens->ordem[idxOrdem].idAtivo);
+    if (idxAtivo == -1) {
+        ordens->anteriorDoAtivo[idxOrdem] = -1;
+        return 1;
+    }
+    ordens->anteriorDoAtivo[idxOrdem] = ativos->ativo[idxAtivo].ultimaOrdem;
+    ativos->ativo[idxAtivo].ultimaOrdem = idxOrdem;
+    return 1;
+}
 
-    for (int i = 0; i < materiais->contador; i++) {
-        if (materiais->material[i].OrdemAssociada == ordem->idOrdem) {
-            total += materiais->material[i].custoUnitário * (float)materiais->material[i].quantidade;
+/**
+ * @brief Recalcula todos os contadores derivados das ordens e a lista de ordens de cada ativo com uma passagem pelo array.
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param ativos Apontador para a estrutura de ativos.
+ * @param tecnicos Apontador para a estrutura de técnicos.
+ * @note O valor de contagemManutencoesCorretivas guardado nos ficheiros é substituído pela contagem das ordens.
+ */
+void reconstruirContadores (Ordens *ordens, Ativos *ativos, Tecnicos *tecnicos) {
+    memset(ordens->porEstado, 0, sizeof(ordens->porEstado));
+    memset(ordens->porPrioridade, 0, sizeof(ordens->porPrioridade));
+    memset(ordens->porTipo, 0, sizeof(ordens->porTipo));
+    for (int i = 0; i < ativos->contador; i++) {
+        ativos->ativo[i].totalOrdens = 0;
+        ativos->ativo[i].contagemManutencoesCorretivas = 0;
+        ativos->ativo[i].ultimaOrdem = -1;
+        sincronizarColunasAtivo(ativos, i);
+    }
+    for (int i = 0; i < tecnicos->contador; i++) {
+        tecnicos->tecnico[i].ordensEmExecucao = 0;
+        tecnicos->tecnico[i].ordensConcluidas = 0;
+    }
+    limparFila(&ordens->pendentes);
+    if (ordens->resolucao != NULL) {
+        TemposResolucao *resolucao = ordens->resolucao;
+        limparHistograma(&resolucao->geral);
+        for (int p = BAIXA; p <= ALTA; p++) limparHistograma(&resolucao->porPrioridade[p]);
+        for (int t = PREVENTIVA; t <= CORRETIVA; t++) limparHistograma(&resolucao->porTipo[t]);
+        limparHistogramasPorID(&resolucao->porDepartamento);
+        limparHistogramasPorID(&resolucao->porTecnico);
+    }
+    for (int i = 0; i < ordens->urgencia.contador; i++) {
+        UrgenciaDepartamento *departamento = &ordens->urgencia.departamentos[i];
+        int id = departamento->idDepartamento;
+        memset(departamento, 0, sizeof(*departamento));
+        departamento->idDepartamento = id;
+    }
+    ordens->urgencia.referencia = timestampAtual();
+    /* Os mapas de bits lidos de ordens.bin já estão certos; somar as ordens volta a marcar os mesmos bits. */
+    if (!ordens->bitmaps.carregados) {
+        for (int k = 0; k < BITMAPS_ORDENS; k++) limparSelecao(bitmapOrdens(&ordens->bitmaps, k));
+    }
+    for (int i = 0; i < ordens->contador; i++) {
+        contabilizarOrdem(ordens, ativos, tecnicos, i, 1);
+        ligarOrdemAtivo(ordens, ativos, i);
+    }
+    /* Mapas gravados que não batem certo com as ordens (ex: ficheiro gravado antes de uma reposição) são refeitos. */
+    if (ordens->bitmaps.carregados && !ordens->bitmaps.desligados && !bitmapsCoincidemContadores(ordens)) {
+        registar_log("Aviso: Os mapas de bits de ordens.bin não coincidem com as ordens e foram reconstruídos.");
+        for (int k = 0; k < BITMAPS_ORDENS; k++) limparSelecao(bitmapOrdens(&ordens->bitmaps, k));
+        for (int i = 0; i < ordens->contador; i++) {
+            contabilizarBitmaps(&ordens->bitmaps, &ordens->ordem[i], i, 1);
         }
     }
+    ordens->bitmaps.carregados = 0;
+}
 
-    return total;
+/**
+ * @brief Aloca os histogramas de tempos de resolução (vazios).
+ * @return Apontador para os histogramas ou NULL se não houver memória.
+ */
+TemposResolucao *criarTemposResolucao (void) {
+    TemposResolucao *resolucao = calloc(1, sizeof(TemposResolucao));
+    if (resolucao == NULL) {
+        registar_log("Erro: Falha ao alocar memória para os histogramas de tempos de resolução.");
+        return NULL;
+    }
+    inicializarHistogramasPorID(&resolucao->porDepartamento);
+    inicializarHistogramasPorID(&resolucao->porTecnico);
+    return resolucao;
 }
 
+/**
+ * @brief Liberta os histogramas de tempos de resolução.
+ * @param resolucao Apontador para os histogramas (pode ser NULL).
+ */
+void libertarTemposResolucao (TemposResolucao *resolucao) {
+    if (resolucao == NULL) return;
+    libertarHistogramasPorID(&resolucao->porDepartamento);
+    libertarHistogramasPorID(&resolucao->porTecnico);
+    free(resolucao);
+}
 
+#ifdef VERIFICAR_CONTADORES
 /**
- * @brief Função que gera o próximo ID a ser atribuido a uma nova ordem.
- * @details Percorre todas as ordens existentes e devolve o maior ID + 1. Se não existirem ordens,
- * devolve 10.
- * @param ordens Apontador para a estrutura Ordens.
- * @return Retorna o próximo ID disponível.
+ * @brief Compara um contador mantido com o valor esperado e regista a diferença.
+ * @param nome Nome do contador (para a mensagem).
+ * @param chave Estado, ID, etc. a que o contador se refere.
+ * @param mantido Valor mantido de forma incremental.
+ * @param esperado Valor obtido pela contagem completa.
+ * @return 1 se forem iguais, caso contrário 0.
  */
-static int gerarProximoID(Ordens *ordens) {
-    if (ordens->contador == 0) {
-        return 10;
+static int compararContador (const char *nome, int chave, int mantido, int esperado) {
+    if (mantido == esperado) return 1;
+
+    char mensagem[160];
+    snprintf(mensagem, sizeof(mensagem), "Erro: Contador %s[%d] inconsistente (mantido %d, esperado %d).",
+             nome, chave, mantido, esperado);
+    printf("%s\n", mensagem);
+    registar_log(mensagem);
+    return 0;
+}
+
+/**
+ * @brief Verifica se os contadores mantidos coincidem com uma contagem completa das ordens.
+ * @details Só existe com VERIFICAR_CONTADORES definido: conta tudo de novo em arrays temporários, sem usar
+ * contabilizarOrdem(), e compara com os contadores.
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param ativos Apontador para a estrutura de ativos.
+ * @param tecnicos Apontador para a estrutura de técnicos.
+ * @return 1 se os contadores estiverem corretos, caso contrário 0.
+ */
+int verificarContadores (const Ordens *ordens, const Ativos *ativos, const Tecnicos *tecnicos) {
+    int porEstado[CANCELADA + 1] = {0};
+    int porPrioridade[ALTA + 1] = {0};
+    int porTipo[CORRETIVA + 1] = {0};
+    int comTempoResolucao = 0;
+    int *totalOrdens = calloc((size_t)ativos->contador + 1, sizeof(int));
+    int *corretivas = calloc((size_t)ativos->contador + 1, sizeof(int));
+    int *emExecucao = calloc((size_t)tecnicos->contador + 1, sizeof(int));
+    int *concluidas = calloc((size_t)tecnicos->contador + 1, sizeof(int));
+    int *urgencia = calloc(2 * (size_t)ordens->urgencia.contador + 1, sizeof(int));
+    int correto = 1;
+
+    if (totalOrdens == NULL || corretivas == NULL || emExecucao == NULL || concluidas == NULL || urgencia == NULL) {
+        free(totalOrdens);
+        free(corretivas);
+        free(emExecucao);
+        free(concluidas);
+        free(urgencia);
+        return 1;
     }
 
-    int maxID = 0;
     for (int i = 0; i < ordens->contador; i++) {
-        if (ordens->ordem[i].idOrdem > maxID) {
-            maxID = ordens->ordem[i].idOrdem;
+        const Ordem *ordem = &ordens->ordem[i];
+        porEstado[ordem->estado]++;
+        if (ordem->prioridade >= BAIXA) porPrioridade[ordem->prioridade]++;
+        if (ordem->tipo_manutencao >= PREVENTIVA && ordem->tipo_manutencao <= CORRETIVA) porTipo[ordem->tipo_manutencao]++;
+        if (ordem->estado == CONCLUIDA && tempoResolucaoOrdem(ordem) >= 0) comTempoResolucao++;
+
+        int idxUrgencia = procurarIndice(&ordens->urgencia.indice, ordem->idDepartamento);
+        if (idxUrgencia == -1) {
+            correto &= compararContador("urgenciaDepartamento", ordem->idDepartamento, 0, 1);
+        } else {
+            int fechada = ordem->estado == CONCLUIDA || ordem->estado == CANCELADA;
+            urgencia[2 * idxUrgencia + fechada] += pesoPrioridade(ordem->prioridade);
+        }
+
+        int idxAtivo = procurarIndice(&ativos->indice, ordem->idAtivo);
+        if (idxAtivo != -1) totalOrdens[idxAtivo]++;
+        if (idxAtivo != -1 && ordem->tipo_manutencao == CORRETIVA && ordem->estado != CANCELADA) corretivas[idxAtivo]++;
+
+        int idxTec = procurarIndice(&tecnicos->indice, ordem->idTecnico);
+        if (idxTec != -1 && ordem->estado == EXECUCAO) emExecucao[idxTec]++;
+        if (idxTec != -1 && ordem->estado == CONCLUIDA) concluidas[idxTec]++;
+    }
+
+    for (int e = PENDENTE; e <= CANCELADA; e++) {
+        correto &= compararContador("porEstado", e, ordens->porEstado[e], porEstado[e]);
+    }
+    correto &= compararContador("pendentes", 0, ordens->pendentes.tamanho, porEstado[PENDENTE]);
+    int topo = topoFila(&ordens->pendentes);
+    for (int i = 0; topo != -1 && i < ordens->contador; i++) {
+        if (ordens->ordem[i].estado == PENDENTE && chavePendente(&ordens->ordem[i]) < chavePendente(&ordens->ordem[topo])) {
+            correto &= compararContador("topoPendentes", ordens->ordem[topo].idOrdem, ordens->ordem[i].idOrdem, ordens->ordem[topo].idOrdem);
+        }
+    }
+    for (int p = BAIXA; p <= ALTA; p++) {
+        correto &= compararContador("porPrioridade", p, ordens->porPrioridade[p], porPrioridade[p]);
+    }
+    if (ordens->resolucao != NULL) {
+        correto &= compararContador("resolucao", 0, ordens->resolucao->geral.total, comTempoResolucao);
+    }
+    for (int j = 0; j < ordens->urgencia.contador; j++) {
+        const UrgenciaDepartamento *departamento = &ordens->urgencia.departamentos[j];
+        correto &= compararContador("urgenciaAbertas", departamento->idDepartamento, departamento->urgenciaAbertas, urgencia[2 * j]);
+        correto &= compararContador("urgenciaFechadas", departamento->idDepartamento, departamento->urgenciaFechadas, urgencia[2 * j + 1]);
+    }
+    for (int t = PREVENTIVA; t <= CORRETIVA; t++) {
+        correto &= compararContador("porTipo", t, ordens->porTipo[t], porTipo[t]);
+    }
+    if (!ordens->bitmaps.desligados) {
+        const BitmapsOrdens *bitmaps = &ordens->bitmaps;
+        for (int e = PENDENTE; e <= CANCELADA; e++) {
+            correto &= compararContador("bitmapEstado", e, contarSelecao(&bitmaps->porEstado[e]), porEstado[e]);
+        }
+        for (int p = BAIXA; p <= ALTA; p++) {
+            correto &= compararContador("bitmapPrioridade", p, contarSelecao(&bitmaps->porPrioridade[p]), porPrioridade[p]);
+        }
+        for (int t = PREVENTIVA; t <= CORRETIVA; t++) {
+            correto &= compararContador("bitmapTipo", t, contarSelecao(&bitmaps->porTipo[t]), porTipo[t]);
+        }
+        for (int i = 0; i < ordens->contador; i++) {
+            const Ordem *ordem = &ordens->ordem[i];
+            int marcada = estaSelecionado(&bitmaps->porEstado[ordem->estado], i) &&
+                          (ordem->prioridade < BAIXA || estaSelecionado(&bitmaps->porPrioridade[ordem->prioridade], i)) &&
+                          (ordem->tipo_manutencao < PREVENTIVA || ordem->tipo_manutencao > CORRETIVA ||
+                           estaSelecionado(&bitmaps->porTipo[ordem->tipo_manutencao], i));
+            correto &= compararContador("bitmapOrdem", ordem->idOrdem, marcada, 1);
+        }
+    }
+    if (ordens->colunas.capacidade >= ordens->contador) {
+        for (int i = 0; i < ordens->contador; i++) {
+            const Ordem *ordem = &ordens->ordem[i];
+            int igual = ordens->colunas.estado[i] == ordem->estado && ordens->colunas.prioridade[i] == ordem->prioridade &&
+                        ordens->colunas.tipo[i] == ordem->tipo_manutencao &&
+                        ordens->colunas.idDepartamento[i] == ordem->idDepartamento;
+            correto &= compararContador("colunasOrdem", ordem->idOrdem, igual, 1);
+        }
+    }
+    for (int j = 0; j < ativos->contador; j++) {
+        correto &= compararContador("totalOrdens", ativos->ativo[j].id, ativos->ativo[j].totalOrdens, totalOrdens[j]);
+        correto &= compararContador("contagemManutencoesCorretivas", ativos->ativo[j].id,
+                                    ativos->ativo[j].contagemManutencoesCorretivas, corretivas[j]);
+
+        int tamanhoHistorico = 0;
+        for (int k = ativos->ativo[j].ultimaOrdem; k != -1 && tamanhoHistorico <= ordens->contador; k = ordens->anteriorDoAtivo[k]) {
+            if (ordens->ordem[k].idAtivo != ativos->ativo[j].id) break;
+            tamanhoHistorico++;
+        }
+        correto &= compararContador("historicoAtivo", ativos->ativo[j].id, tamanhoHistorico, totalOrdens[j]);
+    }
+    for (int j = 0; j < tecnicos->contador; j++) {
+        correto &= compararContador("ordensEmExecucao", tecnicos->tecnico[j].idTecnico, tecnicos->tecnico[j].ordensEmExecucao, emExecucao[j]);
+        int guardados = tecnicos->tecnico[j].ordensEmExecucao < LIMITE_ORDENS_TECNICO ? tecnicos->tecnico[j].ordensEmExecucao : LIMITE_ORDENS_TECNICO;
+        for (int k = 0; k < guardados; k++) {
+            int idxOrdem = procurarIndice(&ordens->indice, tecnicos->tecnico[j].idsEmExecucao[k]);
+            int valida = idxOrdem != -1 && ordens->ordem[idxOrdem].estado == EXECUCAO &&
+                         ordens->ordem[idxOrdem].idTecnico == tecnicos->tecnico[j].idTecnico;
+            correto &= compararContador("idsEmExecucao", tecnicos->tecnico[j].idTecnico, valida, 1);
         }
+        correto &= compararContador("ordensConcluidas", tecnicos->tecnico[j].idTecnico, tecnicos->tecnico[j].ordensConcluidas, concluidas[j]);
     }
 
-    return maxID + 1;
+    free(totalOrdens);
+    free(corretivas);
+    free(emExecucao);
+    free(concluidas);
+    free(urgencia);
+    return correto;
+}
+#endif
+
+static const char *passarIntStringPrioridade (Prioridade prioridade) {
+    switch (prioridade) {
+        case BAIXA:
+            return "Baixa";
+        case MEDIA:
+            return "Media";
+        case ALTA:
+            return "Alta";
+        default:
+            return "Desconhecido";
+    }
+}
+
+/**
+ * @brief Calcula o custo dos materiais associados a uma ordem.
+ * @details Usa o índice de materiais por ordem, pelo que não percorre a lista de materiais.
+ * @param ordem Apontador para a ordem.
+ * @param materiais Apontador para a estrutura que contém a lista de materiais.
+ * @return Custo total dos materiais da ordem.
+ */
+float calcularCustos (Ordem *ordem, Materiais *materiais) {
+    if (ordem == NULL || materiais == NULL) {
+        return 0;
+    }
+
+    return custoMateriaisOrdem(materiais, ordem->idOrdem);
+}
+
+
+/**
+ * @brief Gera um ID único e sequencial para uma nova ordem.
+ * @details Usa o contador proximoID, que é guardado no snapshot e no journal, pelo que a atribuição é O(1)
+ * e um ID nunca é reutilizado, mesmo depois de o programa ser reiniciado.
+ * @param ordens Apontador para a estrutura de ordens.
+ * @return Retorna o ID atribuído (o primeiro é PRIMEIRO_ID).
+ */
+static int gerarProximoID(Ordens *ordens) {
+    if (ordens->proximoID < PRIMEIRO_ID) {
+        ordens->proximoID = PRIMEIRO_ID;
+    }
+    return ordens->proximoID++;
 }
 
 /**
@@ -124,6 +842,21 @@ static int garantir_capacidade_ordens(Ordens *ordens, int minCap) {
     if (novaCap <= 0) novaCap = 0;
     while (novaCap < minCap) novaCap += CRESCIMENTO_5;
 
+    if (ordens->mapa.base != NULL) {
+        /* O array ainda aponta para ordens.bin mapeado: é copiado para a heap antes de crescer. */
+        Ordem *copia = malloc((size_t)novaCap * sizeof(*ordens->ordem));
+        if (copia == NULL) {
+            printf("Erro: sem memória para alocar ordens.\n");
+            registar_log("Erro: Falha ao copiar as ordens mapeadas para a heap.");
+            return 0;
+        }
+        memcpy(copia, ordens->ordem, (size_t)ordens->contador * sizeof(*ordens->ordem));
+        desmapearSnapshot(&ordens->mapa);
+        ordens->ordem = copia;
+        ordens->capacidade = novaCap;
+        return 1;
+    }
+
     void *tmp = realloc(ordens->ordem, (size_t)novaCap * sizeof(*ordens->ordem));
     if (tmp == NULL) {
         printf("Erro: sem memória para alocar ordens.\n");
@@ -139,19 +872,20 @@ static int garantir_capacidade_ordens(Ordens *ordens, int minCap) {
 /**
  * @brief Função que mostra a taxa de ocupaão de um determinado tecnico.
  * @param tecnico Apontador para a estrutura que contèm o array com as informações a analisar.
- * @param ordens Apontador para a estrutura que contèm a lista de ordens e contador.
- * @return Numero inteiro que resulta da divisão das ordens ativas de um determinado tecnico pelo
- * limite maximo, multiplicado por 100.
+ * @return Percentagem (0 a 100) que resulta da divisão das ordens ativas do tecnico pelo limite maximo.
  */
-int mostrarTaxaOcupacaoTecnico (Tecnico *tecnico, Ordens *ordens) {
-    int taxa = 0;
-    int limite_maximo = 5;
-    int ordens_ativas = 0;
-
-    ordens_ativas = numeroManutencoesTecnico(*tecnico, *ordens);
+float mostrarTaxaOcupacaoTecnico (const Tecnico *tecnico) {
+    return calcularTaxaOcupacao(numeroManutencoesTecnico(tecnico));
+}
 
-    taxa = (ordens_ativas / limite_maximo) * 100;
-    return taxa;
+/**
+ * @brief Calcula a taxa de ocupação de um técnico a partir do número de ordens em execução.
+ * @param ordensAtivas Número de ordens em execução do técnico.
+ * @return Percentagem que resulta da divisão das ordens ativas pelo limite maximo (LIMITE_ORDENS_TECNICO).
+ * @note A divisão é feita em vírgula flutuante: com 2 ordens em 5 devolve 40 e não 0.
+ */
+float calcularTaxaOcupacao (int ordensAtivas) {
+    return (float)ordensAtivas * 100.0f / LIMITE_ORDENS_TECNICO;
 }
 
 /**
@@ -159,17 +893,37 @@ int mostrarTaxaOcupacaoTecnico (Tecnico *tecnico, Ordens *ordens) {
  * @param tecnicos Estrutura com o array de técnicos e contador.
  * @note Apenas são listados os técnicos com estado ATIVO1.
  */
-void listar_tecnicos_ativos (Tecnicos *tecnicos, Ordens *ordens) {
+void listar_tecnicos_ativos (Tecnicos *tecnicos) {
     printf ("\n===== TECNICOS ATIVOS =====\n");
     for (int i=0; i < tecnicos->contador; i++) {
-        if (tecnicos->tecnico[i].estado_tecnico == ATIVO1)
-            printf ("ID: %d", tecnicos->tecnico[i].idTecnico);
+        if (tecnicos->tecnico[i].estado_tecnico != ATIVO1) continue;
+        printf ("ID: %d\n", tecnicos->tecnico[i].idTecnico);
         printf ("Nome: %s\n", tecnicos->tecnico[i].nome);
-        printf ("Especialidade: %s",passar_int_string_especialidade(tecnicos->tecnico[i].especialidade));
-        printf ("Estado: %s", passar_int_string_estado(tecnicos->tecnico[i].estado_tecnico));
-        printf("Taxa de ocupação: %d\n", mostrarTaxaOcupacaoTecnico(&tecnicos->tecnico[i], ordens));
+        printf ("Especialidade: %s\n",passar_int_string_especialidade(tecnicos->tecnico[i].especialidade));
+        printf ("Estado: %s\n", passar_int_string_estado(tecnicos->tecnico[i].estado_tecnico));
+        printf("Taxa de ocupação: %.1f%%\n", mostrarTaxaOcupacaoTecnico(&tecnicos->tecnico[i]));
+    }
+}
+/**
+ * @brief Mostra os técnicos a quem ainda pode ser atribuída uma ordem (ativos e abaixo do limite).
+ * @param tecnicos Apontador para a estrutura de técnicos.
+ * @note Usa os contadores mantidos em cada técnico, pelo que é O(T).
+ */
+static void mostrarTecnicosDisponiveis (const Tecnicos *tecnicos) {
+    printf("\n===== TÉCNICOS DISPONÍVEIS =====\n");
+    int encontrou = 0;
+    for (int i = 0; i < tecnicos->contador; i++) {
+        const Tecnico *tecnico = &tecnicos->tecnico[i];
+        if (tecnico->estado_tecnico == INATIVO1 || tecnico->ordensEmExecucao >= LIMITE_ORDENS_TECNICO) continue;
+        printf("ID: %d | %s | %s | Ocupação: %.1f%%\n", tecnico->idTecnico, tecnico->nome,
+               passar_int_string_especialidade(tecnico->especialidade), mostrarTaxaOcupacaoTecnico(tecnico));
+        encontrou = 1;
+    }
+    if (!encontrou) {
+        printf("Não existem técnicos disponíveis.\n");
     }
 }
+
 /**
  * @brief Função que procura uma ordem pelo ID.
  * @param ordens Apontador para a estrutura Ordens.
@@ -179,10 +933,9 @@ void listar_tecnicos_ativos (Tecnicos *tecnicos, Ordens *ordens) {
  * @note Esta função só aceita ordens com estado PENDENTE ou EXECUCAO.
  */
 int procurar_ordens_id (Ordens *ordens, int idProcurado) {
-    for (int i = 0; i<ordens->contador; i++) {
-        if (ordens->ordem[i].idOrdem == idProcurado && (ordens->ordem[i].estado == PENDENTE || ordens->ordem[i].estado == EXECUCAO)) {
-            return i;
-        }
+    int idx = procurarIndice(&ordens->indice, idProcurado);
+    if (idx != -1 && (ordens->ordem[idx].estado == PENDENTE || ordens->ordem[idx].estado == EXECUCAO)) {
+        return idx;
     }
     return -1;
 }
@@ -223,26 +976,122 @@ static const char *passar_int_string_tipo_manutencao(TipoManutencao tipo) {
     }
 }
 
+/**
+ * @brief Mostra os dados de uma ordem na listagem por estado.
+ * @param ordem Apontador para a ordem.
+ * @param materiais Apontador para a estrutura de materiais (custos da ordem).
+ */
+static void mostrarOrdemEstado (Ordem *ordem, Materiais *materiais) {
+    printf("ID ordem: %d\n", ordem->idOrdem);
+    printf("ID Ativo: %d\n", ordem->idAtivo);
+    printf("ID Departamento: %d\n", ordem->idDepartamento);
+    printf("ID tecnico: %d\n", ordem->idTecnico);
+    printf("Prioridade: %s\n", passarIntStringPrioridade(ordem->prioridade));
+    printf("Tipo manutenção: %s\n", passar_int_string_tipo_manutencao(ordem->tipo_manutencao));
+    printf("Custos associados: %f\n", calcularCustos(ordem, materiais));
+}
+
+/**
+ * @brief Seleciona as ordens que verificam todos os critérios, comparando as colunas com SIMD.
+ * @details Cada critério é um filtro de igualdade sobre uma coluna (filtrarIgualU8/filtrarIgualI32) que é
+ * intersetado com o mapa, pelo que não há um ramo por ordem e os critérios seguintes só leem as palavras
+ * que ainda têm ordens selecionadas. Se as colunas estiverem desligadas, o array de ordens é percorrido.
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param filtro Critérios (FILTRO_QUALQUER para ignorar um critério).
+ * @param selecao Mapa de seleção a criar (libertar com libertarSelecao()).
+ * @return Número de ordens selecionadas ou -1 se não houver memória.
+ */
+int selecionarOrdens (const Ordens *ordens, const FiltroOrdens *filtro, Selecao *selecao) {
+    if (!criarSelecao(selecao, ordens->contador)) return -1;
+
+    const ColunasOrdens *colunas = &ordens->colunas;
+    if (colunas->capacidade >= ordens->contador) {
+        if (filtro->estado != FILTRO_QUALQUER) filtrarIgualU8(selecao, colunas->estado, (uint8_t)filtro->estado);
+        if (filtro->prioridade != FILTRO_QUALQUER) filtrarIgualU8(selecao, colunas->prioridade, (uint8_t)filtro->prioridade);
+        if (filtro->tipo != FILTRO_QUALQUER) filtrarIgualU8(selecao, colunas->tipo, (uint8_t)filtro->tipo);
+        if (filtro->idDepartamento != FILTRO_QUALQUER) filtrarIgualI32(selecao, colunas->idDepartamento, filtro->idDepartamento);
+        return contarSelecao(selecao);
+    }
+
+    for (int i = 0; i < ordens->contador; i++) {
+        const Ordem *ordem = &ordens->ordem[i];
+        int aceite = (filtro->estado == FILTRO_QUALQUER || (int)ordem->estado == filtro->estado) &&
+                     (filtro->prioridade == FILTRO_QUALQUER || (int)ordem->prioridade == filtro->prioridade) &&
+                     (filtro->tipo == FILTRO_QUALQUER || (int)ordem->tipo_manutencao == filtro->tipo) &&
+                     (filtro->idDepartamento == FILTRO_QUALQUER || ordem->idDepartamento == filtro->idDepartamento);
+        if (!aceite) {
+            selecao->palavras[i / SELECAO_BITS_PALAVRA] &= ~((uint64_t)1 << (i % SELECAO_BITS_PALAVRA));
+        }
+    }
+    return contarSelecao(selecao);
+}
+
+/**
+ * @brief Pede ao utilizador os critérios (estado, prioridade, tipo e departamento) e lista as ordens que os verificam.
+ * @details Os critérios são combinados (ex: ALTA e PENDENTE do departamento X) num único mapa de seleção,
+ * calculado por selecionarOrdens(), e só as ordens selecionadas são visitadas.
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param materiais Apontador para a estrutura de materiais (custos de cada ordem).
+ */
+void pesquisarOrdens (Ordens *ordens, Materiais *materiais) {
+    printf("\n===== PESQUISAR MANUTENÇÕES =====\n");
+    if (ordens->contador == 0) {
+        printf("Não existem ordens registadas.\n");
+        return;
+    }
+
+    FiltroOrdens filtro;
+    int escolha = obterIntIntervalado(0, 4, "Estado:\n0 - Qualquer\n1 - Pendente\n2 - Em execução\n3 - Concluída\n4 - Cancelada\n");
+    filtro.estado = escolha == 0 ? FILTRO_QUALQUER : PENDENTE + escolha - 1;
+    escolha = obterIntIntervalado(0, 3, "Prioridade:\n0 - Qualquer\n1 - Baixa\n2 - Média\n3 - Alta\n");
+    filtro.prioridade = escolha == 0 ? FILTRO_QUALQUER : escolha;
+    escolha = obterIntIntervalado(0, 2, "Tipo de manutenção:\n0 - Qualquer\n1 - Preventiva\n2 - Corretiva\n");
+    filtro.tipo = escolha == 0 ? FILTRO_QUALQUER : escolha;
+    escolha = obterIntIntervalado(0, 999999, "Indique o ID do departamento (0 para qualquer):\n");
+    filtro.idDepartamento = escolha == 0 ? FILTRO_QUALQUER : escolha;
+
+    Selecao selecao;
+    int total = selecionarOrdens(ordens, &filtro, &selecao);
+    if (total == -1) {
+        printf("Erro: sem memória para pesquisar as ordens.\n");
+        return;
+    }
+
+    printf("Ordens encontradas: %d\n", total);
+    for (int i = proximoSelecionado(&selecao, 0); i != -1; i = proximoSelecionado(&selecao, i + 1)) {
+        printf("Estado: %s\n", passar_int_string_estado_tecnicos(ordens->ordem[i].estado));
+        mostrarOrdemEstado(&ordens->ordem[i], materiais);
+    }
+    libertarSelecao(&selecao);
+}
+
+/**
+ * @brief Devolve o mapa de bits mantido para um valor ou, se os mapas estiverem desligados, seleciona as ordens com o filtro.
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param bitmap Mapa mantido para o valor pretendido.
+ * @param filtro Critério equivalente ao mapa.
+ * @param temporaria Mapa onde é feita a seleção (libertar com libertarSelecao(), mesmo que não seja usado).
+ * @return Mapa a percorrer ou NULL se não houver memória.
+ */
+static const Selecao *ordensComValor (const Ordens *ordens, const Selecao *bitmap, const FiltroOrdens *filtro, Selecao *temporaria) {
+    inicializarSelecao(temporaria);
+    if (!ordens->bitmaps.desligados) return bitmap;
+    return selecionarOrdens(ordens, filtro, temporaria) != -1 ? temporaria : NULL;
+}
+
 /**
  * @brief Função que lista as ordens/manutenções de acordo com o estado selecionado.
  * @param ordens Apontador para estrutura que contém a lista de ordens e contador.
  * @param estado Estado que deseja listar.
  * @param materiais Estrutura que contém a lista de materiais.
+ * @note O total vem dos contadores mantidos em Ordens; se for 0 a lista não chega a ser percorrida.
+ * As ordens são percorridas no mapa de bits mantido para o valor (ordens->bitmaps).
+ * As ordens pendentes vêm da fila de pendentes, pela ordem em que devem ser tratadas.
  */
 void listarOrdensEstado (Ordens *ordens, EstadoOrdem estado, Materiais materiais) {
     switch (estado) {
         case PENDENTE:
             printf("\n===== ORDENS PENDENTES =====\n");
-            for (int i = 0; i < ordens->contador; i++) {
-                if (ordens->ordem[i].estado == estado) {
-                    printf("ID ordem: %d\n", ordens->ordem[i].idOrdem);
-                    printf("ID Ativo: %d\n", ordens->ordem[i].idAtivo);
-                    printf("ID Departamento: %d\n", ordens->ordem[i].idDepartamento);
-                    printf("Prioridade: %s\n", passarIntStringPrioridade(ordens->ordem[i].prioridade));
-                    printf("Tipo manutenção: %s\n", passar_int_string_tipo_manutencao(ordens->ordem[i].tipo_manutencao));
-                }
-            }
-
             break;
         case EXECUCAO:
             printf("\n===== ORDENS EM EXECUÇÃO =====\n");
@@ -252,30 +1101,39 @@ void listarOrdensEstado (Ordens *ordens, EstadoOrdem estado, Materiais materiais
             break;
         case CANCELADA:
             printf("\n===== ORDENS CANCELADAS =====\n");
-            for (int i = 0; i < ordens->contador; i++) {
-                if (ordens->ordem[i].estado == estado) {
-                    printf("ID ordem: %d\n", ordens->ordem[i].idOrdem);
-                    printf("ID Ativo: %d\n", ordens->ordem[i].idAtivo);
-                    printf("ID Departamento: %d\n", ordens->ordem[i].idDepartamento);
-                    printf("Prioridade: %s\n", passarIntStringPrioridade(ordens->ordem[i].prioridade));
-                    printf("Tipo manutenção: %s\n", passar_int_string_tipo_manutencao(ordens->ordem[i].tipo_manutencao));
-                }
-            }
             break;
         default:
             return;
     }
-    for (int i = 0; i < ordens->contador; i++) {
-        if (ordens->ordem[i].estado == estado) {
-            printf("ID ordem: %d\n", ordens->ordem[i].idOrdem);
-            printf("ID Ativo: %d\n", ordens->ordem[i].idAtivo);
-            printf("ID Departamento: %d\n", ordens->ordem[i].idDepartamento);
-            printf("ID tecnico: %d\n", ordens->ordem[i].idTecnico);
-            printf("Prioridade: %s\n", passarIntStringPrioridade(ordens->ordem[i].prioridade));
-            printf("Tipo manutenção: %s\n", passar_int_string_tipo_manutencao(ordens->ordem[i].tipo_manutencao));
-            printf("Custos associados: %f\n", calcularCustos(&ordens->ordem[i], &materiais));
+    printf("Total: %d\n", ordens->porEstado[estado]);
+    if (ordens->porEstado[estado] == 0) {
+        return;
+    }
+
+    if (estado == PENDENTE && ordens->pendentes.tamanho > 0) {
+        printf("Próxima ordem a tratar: %d\n", ordens->ordem[proximaOrdemPendente(ordens)].idOrdem);
+        int *posicoes = malloc((size_t)ordens->pendentes.tamanho * sizeof(int));
+        if (posicoes != NULL && ordenarFila(&ordens->pendentes, posicoes) != -1) {
+            for (int k = 0; k < ordens->pendentes.tamanho; k++) {
+                mostrarOrdemEstado(&ordens->ordem[posicoes[k]], &materiais);
+            }
+            free(posicoes);
+            return;
         }
+        free(posicoes);
+    }
+
+    FiltroOrdens filtro = { estado, FILTRO_QUALQUER, FILTRO_QUALQUER, FILTRO_QUALQUER };
+    Selecao temporaria;
+    const Selecao *selecao = ordensComValor(ordens, &ordens->bitmaps.porEstado[estado], &filtro, &temporaria);
+    if (selecao == NULL) {
+        printf("Erro: sem memória para listar as ordens.\n");
+        return;
+    }
+    for (int i = proximoSelecionado(selecao, 0); i != -1; i = proximoSelecionado(selecao, i + 1)) {
+        mostrarOrdemEstado(&ordens->ordem[i], &materiais);
     }
+    libertarSelecao(&temporaria);
 }
 
 /**
@@ -283,6 +1141,8 @@ void listarOrdensEstado (Ordens *ordens, EstadoOrdem estado, Materiais materiais
  * @param ordens Apontador para a estrutura que contém a lista de ordens e contador.
  * @param prioridade Tipo de prioridade que deseja listar.
  * @param materiais Estrutura que contém a lista de materiais e contador.
+ * @note O total vem dos contadores mantidos em Ordens; se for 0 a lista não chega a ser percorrida.
+ * As ordens são percorridas no mapa de bits mantido para o valor (ordens->bitmaps).
  */
 void listarOrdensPrioridade (Ordens *ordens, Prioridade prioridade, Materiais materiais) {
     switch (prioridade) {
@@ -298,16 +1158,26 @@ void listarOrdensPrioridade (Ordens *ordens, Prioridade prioridade, Materiais ma
         default:
             return;
     }
-    for (int i = 0; i < ordens->contador; i++) {
-        if (ordens->ordem[i].prioridade == prioridade) {
-            printf("ID ordem: %d\n", ordens->ordem[i].idOrdem);
-            printf("ID Ativo: %d\n", ordens->ordem[i].idAtivo);
-            printf("ID Departamento: %d\n", ordens->ordem[i].idDepartamento);
-            printf("Prioridade: %s\n", passarIntStringPrioridade(ordens->ordem[i].prioridade));
-            printf("Tipo manutenção: %s\n", passar_int_string_tipo_manutencao(ordens->ordem[i].tipo_manutencao));
-            printf("Custos associados: %f\n", calcularCustos(&ordens->ordem[i], &materiais));
-        }
+    printf("Total: %d\n", ordens->porPrioridade[prioridade]);
+    if (ordens->porPrioridade[prioridade] == 0) {
+        return;
+    }
+    FiltroOrdens filtro = { FILTRO_QUALQUER, prioridade, FILTRO_QUALQUER, FILTRO_QUALQUER };
+    Selecao temporaria;
+    const Selecao *selecao = ordensComValor(ordens, &ordens->bitmaps.porPrioridade[prioridade], &filtro, &temporaria);
+    if (selecao == NULL) {
+        printf("Erro: sem memória para listar as ordens.\n");
+        return;
+    }
+    for (int i = proximoSelecionado(selecao, 0); i != -1; i = proximoSelecionado(selecao, i + 1)) {
+        printf("ID ordem: %d\n", ordens->ordem[i].idOrdem);
+        printf("ID Ativo: %d\n", ordens->ordem[i].idAtivo);
+        printf("ID Departamento: %d\n", ordens->ordem[i].idDepartamento);
+        printf("Prioridade: %s\n", passarIntStringPrioridade(ordens->ordem[i].prioridade));
+        printf("Tipo manutenção: %s\n", passar_int_string_tipo_manutencao(ordens->ordem[i].tipo_manutencao));
+        printf("Custos associados: %f\n", calcularCustos(&ordens->ordem[i], &materiais));
     }
+    libertarSelecao(&temporaria);
 }
 
 /**
@@ -315,6 +1185,8 @@ void listarOrdensPrioridade (Ordens *ordens, Prioridade prioridade, Materiais ma
  * @param ordens Apontador para a estrutura que contém a lista de ordens e contador.
  * @param tipo Tipo de manutenção que deseja listar.
  * @param materiais Estrutura que contém a lista de materiais e contador.
+ * @note O total vem dos contadores mantidos em Ordens; se for 0 a lista não chega a ser percorrida.
+ * As ordens são percorridas no mapa de bits mantido para o valor (ordens->bitmaps).
  */
 void listarOrdensTipo (Ordens *ordens, TipoManutencao tipo, Materiais materiais) {
     switch (tipo) {
@@ -327,15 +1199,25 @@ void listarOrdensTipo (Ordens *ordens, TipoManutencao tipo, Materiais materiais)
         default:
             return;
     }
-    for (int i = 0; i < ordens->contador; i++) {
-        if (ordens->ordem[i].tipo_manutencao == tipo) {
-            printf("ID ordem: %d\n", ordens->ordem[i].idOrdem);
-            printf("ID Ativo: %d\n", ordens->ordem[i].idAtivo);
-            printf("ID Departamento: %d\n", ordens->ordem[i].idDepartamento);
-            printf("Prioridade: %s\n", passarIntStringPrioridade(ordens->ordem[i].prioridade));
-            printf("Tipo manutenção: %s\n", passar_int_string_tipo_manutencao(ordens->ordem[i].tipo_manutencao));
-        }
+    printf("Total: %d\n", ordens->porTipo[tipo]);
+    if (ordens->porTipo[tipo] == 0) {
+        return;
+    }
+    FiltroOrdens filtro = { FILTRO_QUALQUER, FILTRO_QUALQUER, tipo, FILTRO_QUALQUER };
+    Selecao temporaria;
+    const Selecao *selecao = ordensComValor(ordens, &ordens->bitmaps.porTipo[tipo], &filtro, &temporaria);
+    if (selecao == NULL) {
+        printf("Erro: sem memória para listar as ordens.\n");
+        return;
+    }
+    for (int i = proximoSelecionado(selecao, 0); i != -1; i = proximoSelecionado(selecao, i + 1)) {
+        printf("ID ordem: %d\n", ordens->ordem[i].idOrdem);
+        printf("ID Ativo: %d\n", ordens->ordem[i].idAtivo);
+        printf("ID Departamento: %d\n", ordens->ordem[i].idDepartamento);
+        printf("Prioridade: %s\n", passarIntStringPrioridade(ordens->ordem[i].prioridade));
+        printf("Tipo manutenção: %s\n", passar_int_string_tipo_manutencao(ordens->ordem[i].tipo_manutencao));
     }
+    libertarSelecao(&temporaria);
 }
 
 
@@ -358,26 +1240,43 @@ static const char *passar_int_string_prioridade_manutencao(Prioridade prioridade
 }
 
 /**
- * @brief Função que lista todas as ordens pendentes.
+ * @brief Devolve a próxima ordem pendente a tratar (maior prioridade e, em empate, a mais antiga).
+ * @param ordens Apontador para a estrutura de ordens.
+ * @return Posição da ordem no array ou -1 se não houver ordens pendentes.
+ * @note É o topo da fila de pendentes, pelo que não percorre as ordens.
+ */
+int proximaOrdemPendente (const Ordens *ordens) {
+    return topoFila(&ordens->pendentes);
+}
+
+/**
+ * @brief Função que lista todas as ordens pendentes, da próxima a tratar para a última.
  * @param ordens Estrutura com o array de ordens e contador.
- * @note A listagem é feita via printf. Caso não existam ordens pendentes é apresentada uma mensagem.
+ * @note A listagem é feita via printf a partir da fila de pendentes (só visita as ordens pendentes).
+ * Caso não existam ordens pendentes é apresentada uma mensagem.
  */
 void listar_ordens_pendentes (Ordens ordens) {
-    int contador = 0;
-    for (int i = 0; i < ordens.contador ; i++) {
-        if (ordens.ordem[i].estado == PENDENTE) {
-            printf ("ID: %d\n", ordens.ordem[i].idOrdem);
-            printf ("ID do Ativo: %d\n", ordens.ordem[i].idAtivo);
-            printf ("ID do Departamento Associado: %d\n", ordens.ordem[i].idDepartamento);
-            printf ("Tipo de manutenção: %s\n", passar_int_string_tipo_manutencao(ordens.ordem[i].tipo_manutencao));
-            printf ("Prioridade: %s\n", passar_int_string_prioridade_manutencao(ordens.ordem[i].prioridade));
-            contador++;
-        }
+    if (ordens.pendentes.tamanho == 0) {
+        puts ("Não existem ocorrências pendentes.");
+        return;
     }
 
-    if (contador == 0) {
-        puts ("Não existem ocorrências pendentes.");
+    int *posicoes = malloc((size_t)ordens.pendentes.tamanho * sizeof(int));
+    if (posicoes == NULL || ordenarFila(&ordens.pendentes, posicoes) == -1) {
+        printf("Erro: sem memória para listar as ordens pendentes.\n");
+        free(posicoes);
+        return;
+    }
+
+    for (int k = 0; k < ordens.pendentes.tamanho; k++) {
+        const Ordem *ordem = &ordens.ordem[posicoes[k]];
+        printf ("ID: %d\n", ordem->idOrdem);
+        printf ("ID do Ativo: %d\n", ordem->idAtivo);
+        printf ("ID do Departamento Associado: %d\n", ordem->idDepartamento);
+        printf ("Tipo de manutenção: %s\n", passar_int_string_tipo_manutencao(ordem->tipo_manutencao));
+        printf ("Prioridade: %s\n", passar_int_string_prioridade_manutencao(ordem->prioridade));
     }
+    free(posicoes);
 }
 
 /**
@@ -408,6 +1307,52 @@ void listar_ordens (Ordens ordens) {
     }
 }
 
+/**
+ * @brief Função que mostra o histórico de manutenções de um ativo, da mais recente para a mais antiga.
+ * @details Percorre apenas as ordens do ativo (lista ultimaOrdem/anteriorDoAtivo), pelo que o tempo
+ * depende do número de ordens do ativo e não do total de ordens.
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param ativos Apontador para a estrutura de ativos.
+ * @param materiais Apontador para a estrutura de materiais (custos de cada ordem).
+ */
+void listarHistoricoAtivo (Ordens *ordens, Ativos *ativos, Materiais *materiais) {
+    printf("\n===== HISTÓRICO DE MANUTENÇÕES DO ATIVO =====\n");
+    if (ativos->contador == 0) {
+        printf("Não existem ativos registados.\n");
+        return;
+    }
+
+    int idProcurado = obterIntIntervalado(0, 999999, "Indique o ID do ativo que deseja consultar.\n");
+    int idxAtivo = procurar_ativo_id(ativos, idProcurado);
+    if (idxAtivo == -1) {
+        printf("O ID introduzido é inválido.\n");
+        return;
+    }
+
+    const Ativo *ativo = &ativos->ativo[idxAtivo];
+    printf("Ativo: %s (ID %d)\n", ativo->designacao ? ativo->designacao : "(sem designação)", ativo->id);
+    printf("Total de ordens: %d | Corretivas: %d\n", ativo->totalOrdens, ativo->contagemManutencoesCorretivas);
+
+    char data[TAMANHO_DATA_TEXTO];
+    for (int i = ativo->ultimaOrdem; i != -1; i = ordens->anteriorDoAtivo[i]) {
+        const Ordem *ordem = &ordens->ordem[i];
+        printf("\nID ordem: %d\n", ordem->idOrdem);
+        printf("Estado: %s\n", passar_int_string_estado_tecnicos(ordem->estado));
+        printf("Tipo manutenção: %s\n", passar_int_string_tipo_manutencao(ordem->tipo_manutencao));
+        printf("Prioridade: %s\n", passarIntStringPrioridade(ordem->prioridade));
+        if (ordem->idTecnico != 0) {
+            printf("ID tecnico: %d\n", ordem->idTecnico);
+        }
+        if (ordem->inicio != SEM_DATA) {
+            printf("Início: %s\n", formatarDataHora(ordem->inicio, data, sizeof(data)));
+        }
+        if (ordem->fim != SEM_DATA) {
+            printf("Fim: %s\n", formatarDataHora(ordem->fim, data, sizeof(data)));
+        }
+        printf("Custos associados: %f\n", custoMateriaisOrdem(materiais, ordem->idOrdem));
+    }
+}
+
 /**
  * @brief Função que cria uma nova ordem/manutenção e associa um ativo.
  * @param ativos Apontador para a estrutura de ativos.
@@ -420,7 +1365,8 @@ void listar_ordens (Ordens ordens) {
 void criar_ordem (Ativos *ativos, Ordens *ordens, Departamentos departamentos) {
     if (ativos == NULL || ordens == NULL) return;
 
-    if (!garantir_capacidade_ordens(ordens, ordens->contador + 1)) {
+    if (!garantir_capacidade_ordens(ordens, ordens->contador + 1) ||
+        !garantirCapacidadeHistorico(ordens, ordens->contador + 1)) {
         pausar_ecra();
         return;
     }
@@ -446,24 +1392,54 @@ void criar_ordem (Ativos *ativos, Ordens *ordens, Departamentos departamentos) {
     } while (idEncontrado == -1);
 
     int idx = ordens->contador;
+    memset(&ordens->ordem[idx], 0, sizeof(Ordem));
     ordens->ordem[idx].idOrdem = gerarProximoID(ordens);
+    inserirIndice(&ordens->indice, ordens->ordem[idx].idOrdem, idx);
     ordens->ordem[idx].idAtivo = ativos->ativo[idEncontrado].id;
     ordens->ordem[idx].idDepartamento = ativos->ativo[idEncontrado].idDepartamentoAssociado;
+    ordens->ordem[idx].idTecnico = 0;
+    ordens->ordem[idx].inicio = SEM_DATA;
+    ordens->ordem[idx].fim = SEM_DATA;
     ordens->ordem[idx].estado = PENDENTE;
     ordens->ordem[idx].prioridade = obterIntIntervalado(1, 3, "Introduza a prioridade da ordem:\n1 - Baixa\n2 - Média\n3 - Alta\n");
     ordens->ordem[idx].tipo_manutencao = obterIntIntervalado(1, 2, "Introduza o tipo de manutenção que vai realizar:\n1 - Preventiva\n2 - Corretiva\n");
 
-    ativos->ativo[idEncontrado].estado = EM_MANUTENCAO;
+    definirEstadoAtivo(ativos, idEncontrado, EM_MANUTENCAO);
     ativos->ativosDisponiveis--;
 
     ordens->contador++;
     ordens->ordensAtivas++;
+    contabilizarOrdem(ordens, ativos, NULL, idx, 1);
+    ligarOrdemAtivo(ordens, ativos, idx);
+    journalOrdem(ordens, idx);
+    journalAtivo(ativos, idEncontrado);
 
     printf("Registo realizado com sucesso.\n");
     registar_log("Info: Foi criada uma nova ordem/manutenção e um ativo foi enviado para manutenção.");
     pausar_ecra();
 }
 
+/**
+ * @brief Passa uma ordem PENDENTE para EXECUCAO com o técnico indicado.
+ * @details Atualiza os contadores, regista a data/hora de início e escreve a ordem no journal.
+ * Usada na gestão manual (gerir_ordem) e na distribuição automática de ordens.
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param tecnicos Apontador para a estrutura de técnicos.
+ * @param ativos Apontador para a estrutura de ativos.
+ * @param idxOrdem Posição da ordem no array.
+ * @param idTecnico ID do técnico atribuído.
+ */
+void iniciarExecucaoOrdem (Ordens *ordens, Tecnicos *tecnicos, Ativos *ativos, int idxOrdem, int idTecnico) {
+    contabilizarOrdem(ordens, ativos, tecnicos, idxOrdem, -1);
+    ordens->ordem[idxOrdem].idTecnico = idTecnico;
+    ordens->ordem[idxOrdem].estado = EXECUCAO;
+    contabilizarOrdem(ordens, ativos, tecnicos, idxOrdem, 1);
+
+    ordens->ordem[idxOrdem].inicio = timestampAtual();
+
+    journalOrdem(ordens, idxOrdem);
+}
+
 /**
  * @brief Função que permite gerir uma ordem, dependendo do seu estado.
  * @details Caso a ordem esteja PENDENTE permite alocar um técnico e adicionar materiais.
@@ -493,6 +1469,7 @@ void gerir_ordem (Ordens *ordens, Tecnicos *tecnicos, Ativos *ativos, Materiais
     maxIdTecnicos = obterMaiorIDTecnicos(*tecnicos);
     switch (ordens->ordem[idEncontrado].estado) {
         case PENDENTE:
+        mostrarTecnicosDisponiveis(tecnicos);
         do {
             ordens->ordem[idEncontrado].idTecnico = obterIntIntervalado(
                     0, maxIdTecnicos,
@@ -508,9 +1485,9 @@ void gerir_ordem (Ordens *ordens, Tecnicos *tecnicos, Ativos *ativos, Materiais
                 printf("O técnico que selecionou está inativo, tente novamente.\n");
                 continue;
             }
-            int manutAtivas = numeroManutencoesTecnico(tecnicos->tecnico[idxTec], *ordens);
-            if (manutAtivas >= 5) {
-                printf("O técnico que selecionou já tem 5 manutenções ativas, selecione outro.\n");
+            int manutAtivas = numeroManutencoesTecnico(&tecnicos->tecnico[idxTec]);
+            if (manutAtivas >= LIMITE_ORDENS_TECNICO) {
+                printf("O técnico que selecionou já tem %d manutenções ativas, selecione outro.\n", LIMITE_ORDENS_TECNICO);
                 continue;
             }
 
@@ -521,26 +1498,7 @@ void gerir_ordem (Ordens *ordens, Tecnicos *tecnicos, Ativos *ativos, Materiais
             adicionar_materiais(materiais, ordens->ordem[idEncontrado].idOrdem);
             sair = obterIntIntervalado(1, 2, "Deseja adicionar outro material? (1) Sim (2) Não\n");
         }while (sair == 2);
-        ordens->ordem[idEncontrado].estado = EXECUCAO;
-        {
-            time_t agora = time(NULL);
-            struct tm *tmLocal = localtime(&agora);
-            if (tmLocal != NULL) {
-                ordens->ordem[idEncontrado].diaInicio = tmLocal->tm_mday;
-                ordens->ordem[idEncontrado].mesInicio = tmLocal->tm_mon + 1;
-                ordens->ordem[idEncontrado].anoInicio = tmLocal->tm_year + 1900;
-                ordens->ordem[idEncontrado].horaInicio = tmLocal->tm_hour;
-                ordens->ordem[idEncontrado].minInicio = tmLocal->tm_min;
-                ordens->ordem[idEncontrado].segInicio = tmLocal->tm_sec;
-            } else {
-                ordens->ordem[idEncontrado].diaInicio = 1;
-                ordens->ordem[idEncontrado].mesInicio = 1;
-                ordens->ordem[idEncontrado].anoInicio = 1970;
-                ordens->ordem[idEncontrado].horaInicio = 0;
-                ordens->ordem[idEncontrado].minInicio = 0;
-                ordens->ordem[idEncontrado].segInicio = 0;
-            }
-        }
+        iniciarExecucaoOrdem(ordens, tecnicos, ativos, idEncontrado, ordens->ordem[idEncontrado].idTecnico);
 
         printf ("Manutenção começada com sucesso.\n");
         registar_log("Info: Uma manutenção passou para o estado EM EXECUÇÃO.");
@@ -551,31 +1509,18 @@ void gerir_ordem (Ordens *ordens, Tecnicos *tecnicos, Ativos *ativos, Materiais
         escolha = obterIntIntervalado(1,2, "Indique a operação que deseja realizar:\n1 - Cancelar Manutenção\n2 - Concluir execução\n");
         switch (escolha) {
             case 1: {
+                contabilizarOrdem(ordens, ativos, tecnicos, idEncontrado, -1);
                 ordens->ordem[idEncontrado].estado = CANCELADA;
-                {
-                    time_t agora = time(NULL);
-                    struct tm *tmLocal = localtime(&agora);
-                    if (tmLocal != NULL) {
-                        ordens->ordem[idEncontrado].diaFim = tmLocal->tm_mday;
-                        ordens->ordem[idEncontrado].mesFim = tmLocal->tm_mon + 1;
-                        ordens->ordem[idEncontrado].anoFim = tmLocal->tm_year + 1900;
-                        ordens->ordem[idEncontrado].horaFim = tmLocal->tm_hour;
-                        ordens->ordem[idEncontrado].minFim = tmLocal->tm_min;
-                        ordens->ordem[idEncontrado].segFim = tmLocal->tm_sec;
-                    } else {
-                        ordens->ordem[idEncontrado].diaFim = 1;
-                        ordens->ordem[idEncontrado].mesFim = 1;
-                        ordens->ordem[idEncontrado].anoFim = 1970;
-                        ordens->ordem[idEncontrado].horaFim = 0;
-                        ordens->ordem[idEncontrado].minFim = 0;
-                        ordens->ordem[idEncontrado].segFim = 0;
-                    }
-                }
+                ordens->ordem[idEncontrado].fim = timestampAtual();
+                contabilizarOrdem(ordens, ativos, tecnicos, idEncontrado, 1);
+
+                journalOrdem(ordens, idEncontrado);
 
                 int idxAtivo = procurar_ativo_id(ativos, ordens->ordem[idEncontrado].idAtivo);
                 if (idxAtivo != -1) {
-                    ativos->ativo[idxAtivo].estado = OPERACIONAL;
+                    definirEstadoAtivo(ativos, idxAtivo, OPERACIONAL);
                     ativos->ativosDisponiveis++;
+                    journalAtivo(ativos, idxAtivo);
                 }
 
                 printf ("A manutenção foi cancelada com sucesso");
@@ -585,36 +1530,24 @@ void gerir_ordem (Ordens *ordens, Tecnicos *tecnicos, Ativos *ativos, Materiais
             }
 
             case 2: {
+                contabilizarOrdem(ordens, ativos, tecnicos, idEncontrado, -1);
                 ordens->ordem[idEncontrado].estado = CONCLUIDA;
-                {
-                    time_t agora = time(NULL);
-                    struct tm *tmLocal = localtime(&agora);
-                    if (tmLocal != NULL) {
-                        ordens->ordem[idEncontrado].diaFim = tmLocal->tm_mday;
-                        ordens->ordem[idEncontrado].mesFim = tmLocal->tm_mon + 1;
-                        ordens->ordem[idEncontrado].anoFim = tmLocal->tm_year + 1900;
-                        ordens->ordem[idEncontrado].horaFim = tmLocal->tm_hour;
-                        ordens->ordem[idEncontrado].minFim = tmLocal->tm_min;
-                        ordens->ordem[idEncontrado].segFim = tmLocal->tm_sec;
-                    } else {
-                        ordens->ordem[idEncontrado].diaFim = 1;
-                        ordens->ordem[idEncontrado].mesFim = 1;
-                        ordens->ordem[idEncontrado].anoFim = 1970;
-                        ordens->ordem[idEncontrado].horaFim = 0;
-                        ordens->ordem[idEncontrado].minFim = 0;
-                        ordens->ordem[idEncontrado].segFim = 0;
-                    }
-                }
+                ordens->ordem[idEncontrado].fim = timestampAtual();
+                contabilizarOrdem(ordens, ativos, tecnicos, idEncontrado, 1);
+
+                journalOrdem(ordens, idEncontrado);
 
                 int idxTec = procurar_tecnico_id(*tecnicos, ordens->ordem[idEncontrado].idTecnico);
                 if (idxTec != -1) {
                     tecnicos->tecnico[idxTec].estado_tecnico = ATIVO1;
+                    journalTecnico(tecnicos, idxTec);
                 }
 
                 int idxAtivo = procurar_ativo_id(ativos, ordens->ordem[idEncontrado].idAtivo);
                 if (idxAtivo != -1) {
-                    ativos->ativo[idxAtivo].estado = OPERACIONAL;
+                    definirEstadoAtivo(ativos, idxAtivo, OPERACIONAL);
                     ativos->ativosDisponiveis++;
+                    journalAtivo(ativos, idxAtivo);
                 }
 
                 printf("A manutenção foi concluida com sucesso.\n");
@@ -644,106 +1577,388 @@ void gerir_ordem (Ordens *ordens, Tecnicos *tecnicos, Ativos *ativos, Materiais
     }
 }
 
+/**
+ * @brief Junta os mapas de bits das ordens num único bloco para gravar em ordens.bin.
+ * @param bitmaps Apontador para os mapas.
+ * @param palavrasPorMapa Palavras de cada mapa no bloco (ceil(contador / 64)); as que faltam ficam a 0.
+ * @return Bloco alocado com BITMAPS_ORDENS * palavrasPorMapa palavras ou NULL se não houver memória.
+ */
+static uint64_t *serializarBitmapsOrdens (BitmapsOrdens *bitmaps, int palavrasPorMapa) {
+    uint64_t *bloco = calloc((size_t)BITMAPS_ORDENS * palavrasPorMapa + 1, sizeof(uint64_t));
+    if (bloco == NULL) return NULL;
+
+    for (int k = 0; k < BITMAPS_ORDENS; k++) {
+        const Selecao *mapa = bitmapOrdens(bitmaps, k);
+        int copiar = mapa->numPalavras < palavrasPorMapa ? mapa->numPalavras : palavrasPorMapa;
+        if (copiar > 0) memcpy(&bloco[(size_t)k * palavrasPorMapa], mapa->palavras, (size_t)copiar * sizeof(uint64_t));
+    }
+    return bloco;
+}
+
 /**
  * @brief Função que guarda as ordens num ficheiro binário.
+ * @details Como a estrutura Ordem só tem campos de tamanho fixo e não tem padding implícito, o array é escrito tal como está
+ * em memória na secção 0, precedida por um CabecalhoSnapshot. A secção 1 guarda os mapas de bits por estado,
+ * prioridade e tipo (BITMAPS_ORDENS mapas seguidos, com ceil(contador / 64) palavras cada) e reservado[0] o
+ * número de ordens que os mapas descrevem; se não houver memória para os juntar, o ficheiro é gravado só
+ * com a secção 0 e os mapas são reconstruídos ao carregar.
  * @param ordens Apontador para a estrutura de ordens.
+ * @return 1 se o ficheiro foi gravado com sucesso, caso contrário 0.
  * @warning Escreve no ficheiro "ordens.bin". Caso o ficheiro não possa ser aberto, a função termina.
  */
-void guardarOrdens (Ordens *ordens) {
-    FILE *fp = fopen("ordens.bin", "wb");
+int guardarOrdens (Ordens *ordens) {
+    FILE *fp = abrirSnapshotEscrita("ordens.bin");
 
     if (fp == NULL) {
         printf ("Erro ao abrir ficheiro de ordens para escrita.\n");
         registar_log("Erro: Não foi possível abrir ordens.bin para escrita.");
-        return;
+        return 0;
     }
 
-    fwrite (&ordens->contador, sizeof(int), 1, fp);
-    fwrite(&ordens->ordensAtivas, sizeof(int), 1, fp);
-
-    for (int i = 0; i < ordens->contador; i++) {
-        fwrite (&ordens->ordem[i].idTecnico, sizeof(int), 1, fp);
-        fwrite (&ordens->ordem[i].idOrdem, sizeof(int), 1, fp);
-        fwrite (&ordens->ordem[i].idDepartamento, sizeof(int), 1, fp);
-        fwrite (&ordens->ordem[i].idAtivo, sizeof(int), 1, fp);
-        fwrite (&ordens->ordem[i].tipo_manutencao, sizeof(TipoManutencao), 1, fp);
-        fwrite (&ordens->ordem[i].prioridade, sizeof(Prioridade), 1, fp);
-        fwrite (&ordens->ordem[i].estado, sizeof(EstadoOrdem), 1, fp);
-
-        fwrite(&ordens->ordem[i].diaInicio, sizeof(int), 1, fp);
-        fwrite(&ordens->ordem[i].mesInicio, sizeof(int), 1, fp);
-        fwrite(&ordens->ordem[i].anoInicio, sizeof(int), 1, fp);
-        fwrite(&ordens->ordem[i].horaInicio, sizeof(int), 1, fp);
-        fwrite(&ordens->ordem[i].minInicio, sizeof(int), 1, fp);
-        fwrite(&ordens->ordem[i].segInicio, sizeof(int), 1, fp);
-        fwrite(&ordens->ordem[i].diaFim, sizeof(int), 1, fp);
-        fwrite(&ordens->ordem[i].mesFim, sizeof(int), 1, fp);
-        fwrite(&ordens->ordem[i].anoFim, sizeof(int), 1, fp);
-        fwrite(&ordens->ordem[i].horaFim, sizeof(int), 1, fp);
-        fwrite(&ordens->ordem[i].minFim, sizeof(int), 1, fp);
-        fwrite(&ordens->ordem[i].segFim, sizeof(int), 1, fp);
+    CabecalhoSnapshot cab;
+    inicializarCabecalhoSnapshot(&cab, ordens->contador, ordens->ordensAtivas, sizeof(Ordem));
+    cab.proximoID = ordens->proximoID;
+    cab.seccoes[0].tamanho = (uint64_t)ordens->contador * sizeof(Ordem);
+    int palavrasPorMapa = (ordens->contador + SELECAO_BITS_PALAVRA - 1) / SELECAO_BITS_PALAVRA;
+    uint64_t *bitmaps = ordens->bitmaps.desligados ? NULL : serializarBitmapsOrdens(&ordens->bitmaps, palavrasPorMapa);
+    cab.numSeccoes = bitmaps != NULL ? 2 : 1;
+    cab.seccoes[1].tamanho = bitmaps != NULL ? (uint64_t)BITMAPS_ORDENS * palavrasPorMapa * sizeof(uint64_t) : 0;
+    cab.reservado[0] = bitmaps != NULL ? ordens->contador : 0;
+    const void *blocos[] = { ordens->ordem, bitmaps };
+
+    int sucesso = escreverSnapshot(fp, &cab, blocos);
+    free(bitmaps);
+    if (!fecharSnapshotEscrita(fp, "ordens.bin", sucesso)) {
+        printf ("Erro ao escrever o ficheiro de ordens.\n");
+        registar_log("Erro: Falha na escrita de ordens.bin.");
+        sucesso = 0;
     }
-    fclose (fp);
+    return sucesso;
 }
 
 /**
- * @brief Função que carrega as ordens a partir de um ficheiro binário.
+ * @brief Função que carrega as ordens a partir do formato antigo (sem cabeçalho, um fread por campo).
  * @param ordens Apontador para a estrutura de ordens.
- * @note Caso o ficheiro "ordens.bin" não exista, a função termina sem alterar nada.
- * @warning A função utiliza malloc para alocar memória para o array de ordens.
+ * @param fp Ficheiro aberto e posicionado no início.
+ * @note Os campos são lidos pela mesma ordem em que o formato antigo os escrevia.
  */
-void carregarOrdens (Ordens *ordens) {
-
-    FILE *fp = fopen ("ordens.bin", "rb");
-
-    if (fp == NULL) return;
-
+static void carregarOrdensLegado (Ordens *ordens, FILE *fp) {
     fread (&ordens->contador, sizeof(int), 1, fp);
     ordens->capacidade = ordens->contador;
 
     ordens->ordem = malloc(ordens->capacidade * sizeof(Ordem));
     if (ordens->ordem == NULL && ordens->contador > 0) {
         registar_log("Erro: Falha ao alocar memória ao carregar ordens (malloc devolveu NULL).");
-        fclose(fp);
+        ordens->contador = 0;
+        ordens->capacidade = 0;
         return;
     }
 
     fread (&ordens->ordensAtivas, sizeof(int), 1, fp);
 
     for (int i = 0; i < ordens->contador; i++) {
-        fread(&ordens->ordem[i].tipo_manutencao, sizeof(TipoManutencao), 1, fp);
         fread(&ordens->ordem[i].idTecnico, sizeof(int), 1, fp);
         fread(&ordens->ordem[i].idOrdem, sizeof(int), 1, fp);
         fread(&ordens->ordem[i].idDepartamento, sizeof(int), 1, fp);
         fread(&ordens->ordem[i].idAtivo, sizeof(int), 1, fp);
-        fread(&ordens->ordem[i].prioridade, sizeof(Prioridade), 1, fp);
-        fread(&ordens->ordem[i].estado, sizeof(EstadoOrdem), 1, fp);
-        if (fread(&ordens->ordem[i].diaInicio, sizeof(int), 1, fp) == 1) {
-            fread(&ordens->ordem[i].mesInicio, sizeof(int), 1, fp);
-            fread(&ordens->ordem[i].anoInicio, sizeof(int), 1, fp);
-            fread(&ordens->ordem[i].horaInicio, sizeof(int), 1, fp);
-            fread(&ordens->ordem[i].minInicio, sizeof(int), 1, fp);
-            fread(&ordens->ordem[i].segInicio, sizeof(int), 1, fp);
-            fread(&ordens->ordem[i].diaFim, sizeof(int), 1, fp);
-            fread(&ordens->ordem[i].mesFim, sizeof(int), 1, fp);
-            fread(&ordens->ordem[i].anoFim, sizeof(int), 1, fp);
-            fread(&ordens->ordem[i].horaFim, sizeof(int), 1, fp);
-            fread(&ordens->ordem[i].minFim, sizeof(int), 1, fp);
-            fread(&ordens->ordem[i].segFim, sizeof(int), 1, fp);
+        int enums[3] = {0};
+        fread(enums, sizeof(int), 3, fp);
+        ordens->ordem[i].tipo_manutencao = enums[0];
+        ordens->ordem[i].prioridade = enums[1];
+        ordens->ordem[i].estado = enums[2];
+        ordens->ordem[i].reservado = 0;
+        ordens->ordem[i].reservado2 = 0;
+        int campos[12] = {0};
+        fread(campos, sizeof(int), 12, fp);
+        ordens->ordem[i].inicio = timestampDeCampos(campos[2], campos[1], campos[0], campos[3], campos[4], campos[5]);
+        ordens->ordem[i].fim = timestampDeCampos(campos[8], campos[7], campos[6], campos[9], campos[10], campos[11]);
+    }
+}
+
+/**
+ * @brief Verifica se o cabeçalho corresponde à versão atual dos registos de ordens.
+ * @details O formato é escolhido pela versão; o tamanho do registo só serve para confirmar.
+ * @param cab Cabeçalho lido do ficheiro.
+ * @return 1 se for suportado, caso contrário 0.
+ */
+static int snapshotOrdensValido (const CabecalhoSnapshot *cab) {
+    return cab->versao >= SNAPSHOT_VERSAO_ORDEM_COMPACTA &&
+           cab->numSeccoes >= 1 && cab->tamanhoRegisto == sizeof(Ordem) &&
+           cab->seccoes[0].tamanho == (uint64_t)cab->contador * sizeof(Ordem);
+}
+
+/**
+ * @brief Registo de uma ordem no formato de 48 bytes do snapshot (um int por enum, datas depois dos IDs).
+ * @note Só é usado para ler e converter ficheiros antigos; a gravação seguinte usa o formato de Ordem.
+ */
+typedef struct {
+    int32_t idOrdem;
+    int32_t idAtivo;
+    int32_t idDepartamento;
+    int32_t idTecnico;
+    int32_t estado;
+    int32_t prioridade;
+    int32_t tipo_manutencao;
+    int32_t padding;
+    int64_t inicio;
+    int64_t fim;
+}OrdemLarga;
+
+/**
+ * @brief Registo de uma ordem no formato mais antigo do snapshot (datas em 12 campos int separados).
+ * @note Só é usado para ler e converter ficheiros antigos; a gravação seguinte usa o formato de Ordem.
+ */
+typedef struct {
+    int32_t idOrdem;
+    int32_t idAtivo;
+    int32_t idDepartamento;
+    int32_t idTecnico;
+    int32_t estado;
+    int32_t prioridade;
+    int32_t tipo_manutencao;
+    int32_t diaInicio, mesInicio, anoInicio, horaInicio, minInicio, segInicio;
+    int32_t diaFim, mesFim, anoFim, horaFim, minFim, segFim;
+}OrdemCampos;
+
+/**
+ * @brief Indica o formato anterior dos registos de ordens descrito pelo cabeçalho.
+ * @details Os ficheiros anteriores a SNAPSHOT_VERSAO_TIMESTAMPS usam OrdemCampos e os anteriores a
+ * SNAPSHOT_VERSAO_ORDEM_COMPACTA usam OrdemLarga; o tamanho do registo só serve para confirmar que o
+ * ficheiro corresponde à versão.
+ * @param cab Cabeçalho lido do ficheiro.
+ * @return Tamanho do registo anterior (sizeof(OrdemLarga) ou sizeof(OrdemCampos)) ou 0 se não for um formato anterior.
+ */
+static size_t snapshotOrdensFormatoAnterior (const CabecalhoSnapshot *cab) {
+    size_t tamanho;
+    if (cab->numSeccoes < 1) return 0;
+    if (cab->versao < SNAPSHOT_VERSAO_TIMESTAMPS) {
+        tamanho = sizeof(OrdemCampos);
+    } else if (cab->versao < SNAPSHOT_VERSAO_ORDEM_COMPACTA) {
+        tamanho = sizeof(OrdemLarga);
+    } else {
+        return 0;
+    }
+    if (cab->tamanhoRegisto != tamanho || cab->seccoes[0].tamanho != (uint64_t)cab->contador * tamanho) return 0;
+    return tamanho;
+}
+
+/**
+ * @brief Converte registos num formato anterior para o array de ordens.
+ * @param destino Array de ordens com espaço para contador elementos.
+ * @param registos Registos lidos do ficheiro.
+ * @param tamanhoRegisto Formato dos registos (sizeof(OrdemLarga) ou sizeof(OrdemCampos)).
+ * @param contador Número de registos.
+ */
+static void converterOrdensAnteriores (Ordem *destino, const void *registos, size_t tamanhoRegisto, int contador) {
+    memset(destino, 0, (size_t)contador * sizeof(Ordem));
+    for (int i = 0; i < contador; i++) {
+        if (tamanhoRegisto == sizeof(OrdemLarga)) {
+            const OrdemLarga *r = &((const OrdemLarga *)registos)[i];
+            destino[i].idOrdem = r->idOrdem;
+            destino[i].idAtivo = r->idAtivo;
+            destino[i].idDepartamento = r->idDepartamento;
+            destino[i].idTecnico = r->idTecnico;
+            destino[i].estado = r->estado;
+            destino[i].prioridade = r->prioridade;
+            destino[i].tipo_manutencao = r->tipo_manutencao;
+            destino[i].inicio = r->inicio;
+            destino[i].fim = r->fim;
         } else {
-            ordens->ordem[i].diaInicio = 0;
-            ordens->ordem[i].mesInicio = 0;
-            ordens->ordem[i].anoInicio = 0;
-            ordens->ordem[i].horaInicio = 0;
-            ordens->ordem[i].minInicio = 0;
-            ordens->ordem[i].segInicio = 0;
-            ordens->ordem[i].diaFim = 0;
-            ordens->ordem[i].mesFim = 0;
-            ordens->ordem[i].anoFim = 0;
-            ordens->ordem[i].horaFim = 0;
-            ordens->ordem[i].minFim = 0;
-            ordens->ordem[i].segFim = 0;
+            const OrdemCampos *r = &((const OrdemCampos *)registos)[i];
+            destino[i].idOrdem = r->idOrdem;
+            destino[i].idAtivo = r->idAtivo;
+            destino[i].idDepartamento = r->idDepartamento;
+            destino[i].idTecnico = r->idTecnico;
+            destino[i].estado = r->estado;
+            destino[i].prioridade = r->prioridade;
+            destino[i].tipo_manutencao = r->tipo_manutencao;
+            destino[i].inicio = timestampDeCampos(r->anoInicio, r->mesInicio, r->diaInicio, r->horaInicio, r->minInicio, r->segInicio);
+            destino[i].fim = timestampDeCampos(r->anoFim, r->mesFim, r->diaFim, r->horaFim, r->minFim, r->segFim);
         }
     }
+}
+
+/**
+ * @brief Indica se o cabeçalho tem a secção dos mapas de bits com o tamanho esperado para as ordens gravadas.
+ * @details Os mapas só são aceites se reservado[0] indicar que foram feitos para o mesmo número de ordens.
+ * @param cab Cabeçalho lido do ficheiro.
+ * @return 1 se a secção 1 tiver os mapas de bits, caso contrário 0.
+ */
+static int snapshotOrdensTemBitmaps (const CabecalhoSnapshot *cab) {
+    uint64_t palavrasPorMapa = ((uint64_t)cab->contador + SELECAO_BITS_PALAVRA - 1) / SELECAO_BITS_PALAVRA;
+    return cab->numSeccoes >= 2 && cab->reservado[0] == cab->contador &&
+           cab->seccoes[1].tamanho == BITMAPS_ORDENS * palavrasPorMapa * sizeof(uint64_t);
+}
+
+/**
+ * @brief Copia os mapas de bits gravados em ordens.bin para as ordens.
+ * @details Se algum mapa não puder ser copiado, ficam todos vazios e são reconstruídos por reconstruirContadores().
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param bloco Conteúdo da secção 1 (BITMAPS_ORDENS mapas seguidos).
+ * @param contador Número de ordens gravadas.
+ */
+static void carregarBitmapsOrdens (Ordens *ordens, const uint64_t *bloco, int contador) {
+    int palavrasPorMapa = (contador + SELECAO_BITS_PALAVRA - 1) / SELECAO_BITS_PALAVRA;
+
+    for (int k = 0; k < BITMAPS_ORDENS; k++) {
+        if (!copiarPalavrasSelecao(bitmapOrdens(&ordens->bitmaps, k), &bloco[(size_t)k * palavrasPorMapa], contador)) {
+            for (int j = 0; j < BITMAPS_ORDENS; j++) limparSelecao(bitmapOrdens(&ordens->bitmaps, j));
+            return;
+        }
+    }
+    ordens->bitmaps.carregados = 1;
+}
+
+/**
+ * @brief Função que carrega as ordens mapeando ordens.bin em memória.
+ * @details O array de ordens passa a apontar diretamente para a secção mapeada, sem cópia.
+ * As páginas alteradas (ex: em gerir_ordem) são copiadas pelo sistema operativo (MAP_PRIVATE)
+ * e o array só é copiado para a heap quando precisa de crescer (garantir_capacidade_ordens).
+ * @param ordens Apontador para a estrutura de ordens.
+ * @return 1 se as ordens foram carregadas, 0 se deve ser usada a leitura normal.
+ */
+static int carregarOrdensMapeado (Ordens *ordens) {
+    CabecalhoSnapshot cab;
+    MapaSnapshot mapa;
+
+    if (!mapearSnapshot("ordens.bin", &mapa, &cab)) return 0;
+
+    if (!snapshotOrdensValido(&cab) || cab.contador == 0) {
+        desmapearSnapshot(&mapa);
+        return 0;
+    }
+
+    ordens->ordem = seccaoMapeada(&mapa, &cab, 0);
+    if (snapshotOrdensTemBitmaps(&cab)) {
+        carregarBitmapsOrdens(ordens, seccaoMapeada(&mapa, &cab, 1), cab.contador);
+    }
+    ordens->contador = cab.contador;
+    ordens->ordensAtivas = cab.contadorAuxiliar;
+    ordens->capacidade = cab.contador;
+    if (cab.proximoID > ordens->proximoID) {
+        ordens->proximoID = cab.proximoID;
+    }
+    ordens->mapa = mapa;
+    return 1;
+}
+
+/**
+ * @brief Função que lê ordens.bin no formato disponível (mapeado, versionado ou antigo).
+ * @param ordens Apontador para a estrutura de ordens.
+ */
+static void lerFicheiroOrdens (Ordens *ordens) {
+    if (carregarOrdensMapeado(ordens)) return;
+
+    FILE *fp = fopen ("ordens.bin", "rb");
+
+    if (fp == NULL) return;
+
+    CabecalhoSnapshot cab;
+    if (!lerCabecalhoSnapshot(fp, &cab)) {
+        carregarOrdensLegado(ordens, fp);
+        fclose(fp);
+        return;
+    }
+
+    size_t formatoAnterior = snapshotOrdensFormatoAnterior(&cab);
+    if (!snapshotOrdensValido(&cab) && !formatoAnterior) {
+        registar_log("Erro: ordens.bin tem um formato/versão não suportado.");
+        fclose(fp);
+        return;
+    }
+
+    ordens->ordem = malloc(((size_t)cab.contador + 1) * sizeof(Ordem));
+    void *registos = formatoAnterior ? malloc((size_t)cab.seccoes[0].tamanho + 1) : NULL;
+    if (ordens->ordem == NULL || (formatoAnterior && registos == NULL)) {
+        registar_log("Erro: Falha ao alocar memória ao carregar ordens (malloc devolveu NULL).");
+        free(ordens->ordem);
+        ordens->ordem = NULL;
+        free(registos);
+        fclose(fp);
+        return;
+    }
+
+    if (!lerSeccaoSnapshot(fp, &cab, 0, formatoAnterior ? registos : (void *)ordens->ordem)) {
+        registar_log("Erro: ordens.bin está truncado ou corrompido.");
+        free(ordens->ordem);
+        ordens->ordem = NULL;
+        free(registos);
+        fclose(fp);
+        return;
+    }
+
+    if (formatoAnterior) {
+        converterOrdensAnteriores(ordens->ordem, registos, formatoAnterior, cab.contador);
+        free(registos);
+        registar_log("Info: ordens.bin convertido do formato anterior para registos de 40 bytes.");
+    } else if (snapshotOrdensTemBitmaps(&cab)) {
+        uint64_t *bloco = malloc((size_t)cab.seccoes[1].tamanho + 1);
+        if (bloco != NULL && lerSeccaoSnapshot(fp, &cab, 1, bloco)) {
+            carregarBitmapsOrdens(ordens, bloco, cab.contador);
+        }
+        free(bloco);
+    }
+
+    ordens->contador = cab.contador;
+    ordens->ordensAtivas = cab.contadorAuxiliar;
+    ordens->capacidade = cab.contador;
+    if (cab.proximoID > ordens->proximoID) {
+        ordens->proximoID = cab.proximoID;
+    }
     fclose (fp);
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Função que reconstrói o índice de IDs a partir do array de ordens.
+ * @details Garante também que proximoID é maior do que todos os IDs carregados (ficheiros antigos não o guardam).
+ * @param ordens Apontador para a estrutura de ordens.
+ */
+static void indexarOrdens (Ordens *ordens) {
+    if (!limparIndice(&ordens->indice, ordens->contador)) return;
+    for (int i = 0; i < ordens->contador; i++) {
+        inserirIndice(&ordens->indice, ordens->ordem[i].idOrdem, i);
+        if (ordens->ordem[i].idOrdem >= ordens->proximoID) {
+            ordens->proximoID = ordens->ordem[i].idOrdem + 1;
+        }
+    }
+}
+
+/**
+ * @brief Função que carrega as ordens a partir de um ficheiro binário.
+ * @details Sempre que possível o ficheiro é mapeado em memória (carregarOrdensMapeado). Caso contrário,
+ * no formato versionado todo o array é lido com um único fread e ficheiros sem cabeçalho são
+ * entregues ao leitor do formato antigo.
+ * @param ordens Apontador para a estrutura de ordens.
+ * @note Caso o ficheiro "ordens.bin" não exista, a função termina sem alterar nada.
+ * @warning A função utiliza malloc para alocar memória para o array de ordens.
+ */
+void carregarOrdens (Ordens *ordens) {
+    lerFicheiroOrdens(ordens);
+    indexarOrdens(ordens);
+}
+
+/**
+ * @brief Repõe uma ordem registada no journal (cria-a ou substitui a existente com o mesmo ID).
+ * @param ordens Apontador para a estrutura de ordens.
+ * @param ordem Ordem lida do journal.
+ * @param ordensAtivas Contador de ordens ativas no momento do registo.
+ * @param proximoID Próximo ID a atribuir no momento do registo.
+ */
+void reporOrdem (Ordens *ordens, const Ordem *ordem, int ordensAtivas, int proximoID) {
+    int idx = procurarIndice(&ordens->indice, ordem->idOrdem);
+
+    if (idx == -1) {
+        if (!garantir_capacidade_ordens(ordens, ordens->contador + 1)) return;
+        idx = ordens->contador++;
+        inserirIndice(&ordens->indice, ordem->idOrdem, idx);
+    }
+    ordens->ordem[idx] = *ordem;
+    ordens->bitmaps.carregados = 0;
+    ordens->ordensAtivas = ordensAtivas;
+    if (proximoID > ordens->proximoID) {
+        ordens->proximoID = proximoID;
+    }
+    if (ordem->idOrdem >= ordens->proximoID) {
+        ordens->proximoID = ordem->idOrdem + 1;
+    }
+}
@@ -0,0 +1,277 @@
+/**
+ * @file prefixo.c
+ * @brief Ficheiro com o índice de prefixos usado na pesquisa inteligente de ativos.
+ * @details As chaves são guardadas em minúsculas num array ordenado. Procurar um prefixo são duas
+ * procuras binárias (início e fim do intervalo), e as entradas encontradas já saem por ordem lexicográfica.
+ * A normalização é a mesma do strncasecmp (apenas letras ASCII). As chaves são copiadas para uma arena
+ * de blocos, pelo que indexar N textos faz poucas alocações em vez de uma por chave.
+ * @author Francisco Alves
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "../include/prefixo.h"
+#include "../include/logs.h"
+
+/**
+ * @brief Compara uma chave do índice (já em minúsculas) com um texto, convertendo o texto para minúsculas.
+ * @param chave Chave guardada no índice.
+ * @param texto Texto a comparar.
+ * @param n Número máximo de caracteres a comparar.
+ * @return Valor negativo, zero ou positivo, como o strncmp.
+ */
+static int compararChave(const char *chave, const char *texto, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        int a = (unsigned char)chave[i];
+        int b = tolower((unsigned char)texto[i]);
+        if (a != b) return a - b;
+        if (a == '\0') return 0;
+    }
+    return 0;
+}
+
+/**
+ * @brief Compara uma entrada com o par (texto, posicao) pela ordem do índice.
+ * @param entrada Entrada do índice.
+ * @param texto Texto a comparar.
+ * @param posicao Posição usada para desempatar chaves iguais.
+ * @return Valor negativo, zero ou positivo.
+ */
+static int compararEntrada(const EntradaPrefixo *entrada, const char *texto, int posicao) {
+    int cmp = compararChave(entrada->chave, texto, (size_t)-1);
+    if (cmp != 0) return cmp;
+    return (entrada->posicao > posicao) - (entrada->posicao < posicao);
+}
+
+/**
+ * @brief Função de comparação do qsort (ordena por chave e depois por posição).
+ */
+static int compararEntradasQsort(const void *a, const void *b) {
+    const EntradaPrefixo *x = a;
+    const EntradaPrefixo *y = b;
+    int cmp = strcmp(x->chave, y->chave);
+    if (cmp != 0) return cmp;
+    return (x->posicao > y->posicao) - (x->posicao < y->posicao);
+}
+
+/**
+ * @brief Devolve a primeira posição do array cuja entrada não é menor do que (texto, posicao).
+ * @param indice Apontador para o índice.
+ * @param texto Texto a procurar.
+ * @param posicao Posição usada para desempatar chaves iguais.
+ * @return Posição de inserção (entre 0 e contador).
+ */
+static int limiteInferior(const IndicePrefixos *indice, const char *texto, int posicao) {
+    int esq = 0, dir = indice->contador;
+    while (esq < dir) {
+        int meio = esq + (dir - esq) / 2;
+        if (compararEntrada(&indice->entradas[meio], texto, posicao) < 0) {
+            esq = meio + 1;
+        } else {
+            dir = meio;
+        }
+    }
+    return esq;
+}
+
+/**
+ * @brief Copia um texto em minúsculas para a arena do índice, alocando um bloco novo se o atual não chegar.
+ * @param indice Apontador para o índice.
+ * @param texto Texto a copiar.
+ * @return Chave dentro da arena ou NULL se não houver memória.
+ */
+static const char *copiarMinusculas(IndicePrefixos *indice, const char *texto) {
+    size_t tam = strlen(texto) + 1;
+    BlocoChaves *bloco = indice->blocos;
+
+    if (bloco == NULL || bloco->usado + tam > bloco->capacidade) {
+        size_t capacidade = tam > PREFIXOS_TAMANHO_BLOCO ? tam : PREFIXOS_TAMANHO_BLOCO;
+        BlocoChaves *novo = malloc(sizeof(BlocoChaves) + capacidade);
+        if (novo == NULL) {
+            registar_log("Erro: Falha ao alocar memória para as chaves do índice de prefixos.");
+            return NULL;
+        }
+        novo->anterior = bloco;
+        novo->usado = 0;
+        novo->capacidade = capacidade;
+        indice->blocos = novo;
+        bloco = novo;
+    }
+
+    char *chave = bloco->dados + bloco->usado;
+    for (size_t i = 0; i < tam; i++) {
+        chave[i] = (char)tolower((unsigned char)texto[i]);
+    }
+    bloco->usado += tam;
+    return chave;
+}
+
+/**
+ * @brief Garante espaço no array para pelo menos minCap entradas (a capacidade duplica).
+ * @param indice Apontador para o índice.
+ * @param minCap Número mínimo de entradas.
+ * @return 1 em caso de sucesso, 0 se a alocação falhar.
+ */
+static int garantirCapacidadePrefixos(IndicePrefixos *indice, int minCap) {
+    if (minCap <= indice->capacidade) return 1;
+
+    int novaCap = indice->capacidade > 0 ? indice->capacidade : PREFIXOS_CAPACIDADE_INICIAL;
+    while (novaCap < minCap) novaCap *= 2;
+    void *tmp = realloc(indice->entradas, (size_t)novaCap * sizeof(*indice->entradas));
+    if (tmp == NULL) {
+        registar_log("Erro: Falha ao expandir o índice de prefixos.");
+        return 0;
+    }
+    indice->entradas = tmp;
+    indice->capacidade = novaCap;
+    return 1;
+}
+
+/**
+ * @brief Inicializa um índice de prefixos vazio (não aloca memória).
+ * @param indice Apontador para o índice.
+ */
+void inicializarIndicePrefixos(IndicePrefixos *indice) {
+    indice->entradas = NULL;
+    indice->contador = 0;
+    indice->capacidade = 0;
+    indice->blocos = NULL;
+}
+
+/**
+ * @brief Garante espaço para um número de entradas (para carregamentos em bloco).
+ * @param indice Apontador para o índice.
+ * @param total Número total de entradas previsto.
+ * @return 1 em caso de sucesso, 0 se não houver memória.
+ */
+int reservarIndicePrefixos(IndicePrefixos *indice, int total) {
+    return garantirCapacidadePrefixos(indice, total);
+}
+
+/**
+ * @brief Insere um texto no índice, mantendo a ordenação.
+ * @details A posição é encontrada por procura binária e as entradas seguintes são deslocadas com um memmove.
+ * @param indice Apontador para o índice.
+ * @param texto Texto a indexar (é guardada uma cópia em minúsculas).
+ * @param posicao Posição do registo no array.
+ * @return 1 em caso de sucesso, 0 se não houver memória.
+ */
+int inserirIndicePrefixos(IndicePrefixos *indice, const char *texto, int posicao) {
+    if (texto == NULL || !garantirCapacidadePrefixos(indice, indice->contador + 1)) return 0;
+
+    const char *chave = copiarMinusculas(indice, texto);
+    if (chave == NULL) return 0;
+
+    int i = limiteInferior(indice, texto, posicao);
+    memmove(&indice->entradas[i + 1], &indice->entradas[i], (size_t)(indice->contador - i) * sizeof(*indice->entradas));
+    indice->entradas[i].chave = chave;
+    indice->entradas[i].posicao = posicao;
+    indice->contador++;
+    return 1;
+}
+
+/**
+ * @brief Remove do índice a entrada correspondente a (texto, posicao).
+ * @param indice Apontador para o índice.
+ * @param texto Texto com que a entrada foi inserida.
+ * @param posicao Posição do registo no array.
+ * @return 1 se a entrada foi removida, 0 se não existia.
+ */
+int removerIndicePrefixos(IndicePrefixos *indice, const char *texto, int posicao) {
+    if (texto == NULL) return 0;
+
+    int i = limiteInferior(indice, texto, posicao);
+    if (i >= indice->contador || compararEntrada(&indice->entradas[i], texto, posicao) != 0) return 0;
+
+    memmove(&indice->entradas[i], &indice->entradas[i + 1], (size_t)(indice->contador - i - 1) * sizeof(*indice->entradas));
+    indice->contador--;
+    return 1;
+}
+
+/**
+ * @brief Acrescenta uma entrada no fim do índice sem a ordenar (para carregamentos em bloco).
+ * @param indice Apontador para o índice.
+ * @param texto Texto a indexar.
+ * @param posicao Posição do registo no array.
+ * @return 1 em caso de sucesso, 0 se não houver memória.
+ */
+int acrescentarIndicePrefixos(IndicePrefixos *indice, const char *texto, int posicao) {
+    if (texto == NULL || !garantirCapacidadePrefixos(indice, indice->contador + 1)) return 0;
+
+    const char *chave = copiarMinusculas(indice, texto);
+    if (chave == NULL) return 0;
+
+    indice->entradas[indice->contador].chave = chave;
+    indice->entradas[indice->contador].posicao = posicao;
+    indice->contador++;
+    return 1;
+}
+
+/**
+ * @brief Ordena as entradas acrescentadas com acrescentarIndicePrefixos().
+ * @param indice Apontador para o índice.
+ */
+void ordenarIndicePrefixos(IndicePrefixos *indice) {
+    if (indice->contador > 1) {
+        qsort(indice->entradas, (size_t)indice->contador, sizeof(*indice->entradas), compararEntradasQsort);
+    }
+}
+
+/**
+ * @brief Procura as entradas cuja chave começa por um prefixo.
+ * @details O início do intervalo é a primeira chave >= prefixo; o fim é a primeira chave cujos
+ * primeiros caracteres já são maiores do que o prefixo. Ambos são obtidos por procura binária.
+ * @param indice Apontador para o índice.
+ * @param prefixo Prefixo a procurar.
+ * @param inicio Devolve a posição da primeira entrada encontrada em indice->entradas.
+ * @return Número de entradas encontradas (consecutivas e por ordem lexicográfica).
+ */
+int procurarIndicePrefixos(const IndicePrefixos *indice, const char *prefixo, int *inicio) {
+    size_t tam = strlen(prefixo);
+    int esq = 0, dir = indice->contador;
+
+    while (esq < dir) {
+        int meio = esq + (dir - esq) / 2;
+        if (compararChave(indice->entradas[meio].chave, prefixo, tam) < 0) {
+            esq = meio + 1;
+        } else {
+            dir = meio;
+        }
+    }
+    *inicio = esq;
+
+    dir = indice->contador;
+    while (esq < dir) {
+        int meio = esq + (dir - esq) / 2;
+        if (compararChave(indice->entradas[meio].chave, prefixo, tam) == 0) {
+            esq = meio + 1;
+        } else {
+            dir = meio;
+        }
+    }
+    return esq - *inicio;
+}
+
+/**
+ * @brief Remove todas as entradas e liberta as chaves, mantendo a memória do array.
+ * @param indice Apontador para o índice.
+ */
+void limparIndicePrefixos(IndicePrefixos *indice) {
+    while (indice->blocos != NULL) {
+        BlocoChaves *anterior = indice->blocos->anterior;
+        free(indice->blocos);
+        indice->blocos = anterior;
+    }
+    indice->contador = 0;
+}
+
+/**
+ * @brief Liberta a memória do índice e das chaves.
+ * @param indice Apontador para o índice.
+ */
+void libertarIndicePrefixos(IndicePrefixos *indice) {
+    limparIndicePrefixos(indice);
+    free(indice->entradas);
+    inicializarIndicePrefixos(indice);
+}
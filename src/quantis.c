@@ -0,0 +1,185 @@
+/**
+ * @file quantis.c
+ * @brief Ficheiro com os histogramas logarítmicos usados para estimar percentis de durações.
+ * @details Cada potência de 2 [2^e, 2^(e+1)) é dividida em HISTOGRAMA_SUBDIVISOES baldes iguais, pelo que a
+ * largura de um balde é proporcional ao valor e o percentil estimado (centro do balde) tem um erro relativo
+ * limitado, seja a duração de minutos ou de meses. Registar e retirar uma duração custa O(1) e calcular
+ * um percentil percorre os HISTOGRAMA_BALDES baldes, sem depender do número de durações registadas.
+ * @author Francisco Alves
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "../include/quantis.h"
+#include "../include/logs.h"
+
+#define HISTOGRAMAS_CAPACIDADE_INICIAL 8
+
+/**
+ * @brief Devolve a posição do bit mais significativo de um valor (floor(log2(valor))).
+ * @param valor Valor maior do que 0.
+ * @return Expoente.
+ */
+static int expoenteDe(uint64_t valor) {
+    return 63 - __builtin_clzll(valor);
+}
+
+/**
+ * @brief Calcula o balde de uma duração.
+ * @param segundos Duração (>= 0).
+ * @return Índice do balde (as durações acima do limite ficam no último balde).
+ */
+static int baldeDe(int64_t segundos) {
+    if (segundos <= 0) return 0;
+
+    int e = expoenteDe((uint64_t)segundos);
+    if (e >= HISTOGRAMA_EXPOENTES) return HISTOGRAMA_BALDES - 1;
+
+    /* Os 4 bits mais significativos são 1sss: sss é a subdivisão dentro da potência de 2. */
+    int sub = (int)(((uint64_t)segundos * HISTOGRAMA_SUBDIVISOES) >> e) - HISTOGRAMA_SUBDIVISOES;
+    return 1 + e * HISTOGRAMA_SUBDIVISOES + sub;
+}
+
+/**
+ * @brief Devolve o valor representativo de um balde (o centro; nos baldes com um único inteiro, esse inteiro).
+ * @param balde Índice do balde.
+ * @return Duração em segundos.
+ */
+static int64_t valorDoBalde(int balde) {
+    if (balde == 0) return 0;
+
+    int e = (balde - 1) / HISTOGRAMA_SUBDIVISOES;
+    int sub = (balde - 1) % HISTOGRAMA_SUBDIVISOES;
+    int64_t inicio = ((int64_t)(HISTOGRAMA_SUBDIVISOES + sub) << e) / HISTOGRAMA_SUBDIVISOES;
+    int64_t largura = ((int64_t)1 << e) / HISTOGRAMA_SUBDIVISOES;
+    return inicio + largura / 2;
+}
+
+/**
+ * @brief Esvazia um histograma.
+ * @param histograma Apontador para o histograma.
+ */
+void limparHistograma(HistogramaTempos *histograma) {
+    memset(histograma->baldes, 0, sizeof(histograma->baldes));
+    histograma->total = 0;
+}
+
+/**
+ * @brief Soma (delta = 1) ou retira (delta = -1) uma duração do histograma. O(1).
+ * @param histograma Apontador para o histograma.
+ * @param segundos Duração em segundos (valores negativos são ignorados).
+ * @param delta 1 para somar, -1 para retirar.
+ */
+void registarTempo(HistogramaTempos *histograma, int64_t segundos, int delta) {
+    if (segundos < 0) return;
+
+    int balde = baldeDe(segundos);
+    if (delta < 0 && histograma->baldes[balde] == 0) return;
+
+    histograma->baldes[balde] += (uint32_t)delta;
+    histograma->total += delta;
+}
+
+/**
+ * @brief Estima o percentil q das durações registadas.
+ * @details Procura o primeiro balde em que a contagem acumulada atinge ceil(q * total) e devolve o seu centro.
+ * @param histograma Apontador para o histograma.
+ * @param q Percentil pretendido, entre 0 e 1 (ex: 0.9 para p90).
+ * @return Duração estimada em segundos ou -1 se o histograma estiver vazio.
+ */
+int64_t quantilHistograma(const HistogramaTempos *histograma, double q) {
+    if (histograma->total <= 0) return -1;
+
+    int64_t alvo = (int64_t)(q * histograma->total);
+    if ((double)alvo < q * histograma->total) alvo++;
+    if (alvo < 1) alvo = 1;
+    if (alvo > histograma->total) alvo = histograma->total;
+
+    int64_t acumulado = 0;
+    for (int i = 0; i < HISTOGRAMA_BALDES; i++) {
+        acumulado += histograma->baldes[i];
+        if (acumulado >= alvo) return valorDoBalde(i);
+    }
+    return valorDoBalde(HISTOGRAMA_BALDES - 1);
+}
+
+/**
+ * @brief Inicializa um conjunto vazio (não aloca memória).
+ * @param grupo Apontador para o conjunto.
+ */
+void inicializarHistogramasPorID(HistogramasPorID *grupo) {
+    grupo->histogramas = NULL;
+    grupo->ids = NULL;
+    grupo->contador = 0;
+    grupo->capacidade = 0;
+    inicializarIndice(&grupo->indice);
+}
+
+/**
+ * @brief Devolve o histograma de um ID, criando-o se ainda não existir.
+ * @param grupo Apontador para o conjunto.
+ * @param id ID pretendido.
+ * @return Apontador para o histograma ou NULL se não houver memória.
+ * @note O apontador deixa de ser válido quando for criado outro histograma.
+ */
+HistogramaTempos *histogramaDoID(HistogramasPorID *grupo, int id) {
+    int pos = procurarIndice(&grupo->indice, id);
+    if (pos != -1) return &grupo->histogramas[pos];
+
+    if (grupo->contador >= grupo->capacidade) {
+        int novaCap = grupo->capacidade > 0 ? grupo->capacidade * 2 : HISTOGRAMAS_CAPACIDADE_INICIAL;
+        HistogramaTempos *histogramas = realloc(grupo->histogramas, (size_t)novaCap * sizeof(HistogramaTempos));
+        if (histogramas == NULL) {
+            registar_log("Erro: Falha ao expandir os histogramas de tempos de resolução.");
+            return NULL;
+        }
+        grupo->histogramas = histogramas;
+
+        int *ids = realloc(grupo->ids, (size_t)novaCap * sizeof(int));
+        if (ids == NULL) {
+            registar_log("Erro: Falha ao expandir os histogramas de tempos de resolução.");
+            return NULL;
+        }
+        grupo->ids = ids;
+        grupo->capacidade = novaCap;
+    }
+
+    if (!inserirIndice(&grupo->indice, id, grupo->contador)) return NULL;
+
+    pos = grupo->contador++;
+    grupo->ids[pos] = id;
+    limparHistograma(&grupo->histogramas[pos]);
+    return &grupo->histogramas[pos];
+}
+
+/**
+ * @brief Procura o histograma de um ID sem o criar.
+ * @param grupo Apontador para o conjunto.
+ * @param id ID pretendido.
+ * @return Apontador para o histograma ou NULL se o ID não existir.
+ */
+const HistogramaTempos *procurarHistogramaDoID(const HistogramasPorID *grupo, int id) {
+    int pos = procurarIndice(&grupo->indice, id);
+    return pos != -1 ? &grupo->histogramas[pos] : NULL;
+}
+
+/**
+ * @brief Esvazia todos os histogramas do conjunto, mantendo os IDs e a memória.
+ * @param grupo Apontador para o conjunto.
+ */
+void limparHistogramasPorID(HistogramasPorID *grupo) {
+    for (int i = 0; i < grupo->contador; i++) {
+        limparHistograma(&grupo->histogramas[i]);
+    }
+}
+
+/**
+ * @brief Liberta a memória do conjunto.
+ * @param grupo Apontador para o conjunto.
+ */
+void libertarHistogramasPorID(HistogramasPorID *grupo) {
+    free(grupo->histogramas);
+    free(grupo->ids);
+    libertarIndice(&grupo->indice);
+    inicializarHistogramasPorID(grupo);
+}
@@ -0,0 +1,78 @@
+/**
+ * @file ranking.c
+ * @brief Ficheiro com a seleção dos k melhores elementos (top-k).
+ * @details Os k melhores elementos vistos até ao momento ficam num min-heap cujo topo é o pior deles; cada novo
+ * elemento só entra se for melhor do que o topo. No fim o heap é ordenado no próprio array (heapsort).
+ * @author Francisco Alves
+ */
+
+#include "../include/ranking.h"
+
+/**
+ * @brief Indica se a entrada a fica à frente da entrada b no ranking.
+ * @param a Primeira entrada.
+ * @param b Segunda entrada.
+ * @return 1 se a for melhor, caso contrário 0.
+ */
+static int melhorQue(const EntradaRanking *a, const EntradaRanking *b) {
+    if (a->valor != b->valor) return a->valor > b->valor;
+    return a->posicao < b->posicao;
+}
+
+/**
+ * @brief Desce uma entrada no min-heap (o topo é a pior entrada).
+ * @param heap Array do heap.
+ * @param tamanho Número de entradas do heap.
+ * @param i Posição inicial da entrada.
+ */
+static void descerHeap(EntradaRanking *heap, int tamanho, int i) {
+    EntradaRanking entrada = heap[i];
+    while (1) {
+        int filho = 2 * i + 1;
+        if (filho >= tamanho) break;
+        if (filho + 1 < tamanho && melhorQue(&heap[filho], &heap[filho + 1])) {
+            filho++;
+        }
+        if (!melhorQue(&entrada, &heap[filho])) break;
+        heap[i] = heap[filho];
+        i = filho;
+    }
+    heap[i] = entrada;
+}
+
+/**
+ * @brief Seleciona os k melhores elementos e devolve-os ordenados do melhor para o pior. O(n log k).
+ * @param entradas Elementos a classificar (não são alterados).
+ * @param n Número de elementos.
+ * @param k Número de elementos pretendidos.
+ * @param destino Array com espaço para k elementos.
+ * @return Número de elementos escritos em destino (min(n, k)).
+ */
+int selecionarTopK(const EntradaRanking *entradas, int n, int k, EntradaRanking *destino) {
+    if (n <= 0 || k <= 0) return 0;
+
+    int tamanho = 0;
+    for (int i = 0; i < n; i++) {
+        if (tamanho < k) {
+            destino[tamanho++] = entradas[i];
+            if (tamanho == k) {
+                for (int j = k / 2 - 1; j >= 0; j--) descerHeap(destino, k, j);
+            }
+        } else if (melhorQue(&entradas[i], &destino[0])) {
+            destino[0] = entradas[i];
+            descerHeap(destino, k, 0);
+        }
+    }
+    if (tamanho < k) {
+        for (int j = tamanho / 2 - 1; j >= 0; j--) descerHeap(destino, tamanho, j);
+    }
+
+    /* Heapsort: o pior vai para o fim, pelo que o array fica do melhor para o pior. */
+    for (int fim = tamanho - 1; fim > 0; fim--) {
+        EntradaRanking pior = destino[0];
+        destino[0] = destino[fim];
+        destino[fim] = pior;
+        descerHeap(destino, fim, 0);
+    }
+    return tamanho;
+}
@@ -5,137 +5,395 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "../include/ativos.h"
 #include "../include/departamentos.h"
 #include "../include/ordem.h"
 #include "../include/materiais.h"
-#include <time.h>
+#include "../include/relatorios.h"
+#include "../include/logs.h"
+#include "../include/dicionario.h"
+#include "../include/ranking.h"
+#include <stdint.h>
 
 /**
- * @brief Conta quantos ativos existem num determinado estado.
- * @param ativos Estrutura que contém a lista de ativos.
- * @param estado_ativo Estado que pretende contar.
- * @return Retorna o número de ativos com o estado indicado.
+ * @brief Calcula as contagens e totais do relatório de ativos a partir das colunas de ativos.
+ * @details Cada ciclo lê uma única coluna contígua (1 byte por ativo no estado e na categoria), pelo que
+ * os registos Ativo completos nunca passam pela cache. Os resultados são iguais aos da passagem pelo array.
+ * @param colunas Colunas de ativos (ligadas).
+ * @param contador Número de ativos.
+ * @param resumo Apontador para o resumo já inicializado.
  */
-int contadorPorEstado (Ativos ativos, EstadoAtivo estado_ativo) {
-    int contador = 0;
-    for (int i = 0; i<ativos.contador; i++) {
-        if (ativos.ativo[i].estado == estado_ativo) {
-            contador++;
+static void agregarColunasAtivos (const ColunasAtivos *colunas, int contador, ResumoAtivos *resumo) {
+    int porEstado[UINT8_MAX + 1] = {0};
+    int porCategoria[UINT8_MAX + 1] = {0};
+
+    for (int i = 0; i < contador; i++) porEstado[colunas->estado[i]]++;
+    for (int i = 0; i < contador; i++) porCategoria[colunas->categoria[i]]++;
+    for (int e = OPERACIONAL; e <= INATIVO2; e++) resumo->porEstado[e] = porEstado[e];
+    for (int c = VIATURA; c <= OUTRO; c++) resumo->porCategoria[c] = porCategoria[c];
+
+    int maior = 0;
+    for (int i = 0; i < contador; i++) {
+        if (colunas->corretivas[i] > maior) {
+            maior = colunas->corretivas[i];
+            resumo->idxMaisCorretivas = i;
+        }
+    }
+    for (int i = 0; i < contador; i++) resumo->custoTotal += colunas->custo[i];
+    for (int i = 0; i < contador; i++) resumo->custoManutencaoTotal += colunas->custoAcumulado[i];
+}
+
+/**
+ * @brief Calcula todas as contagens e totais do relatório de ativos numa única passagem.
+ * @details Se as colunas de ativos estiverem ligadas, a agregação lê apenas as colunas necessárias
+ * (agregarColunasAtivos). Caso contrário, numa só passagem pelo array são contados os ativos por estado e
+ * por categoria, somados os custos e encontrado o ativo com mais manutenções corretivas (o primeiro, em caso de empate).
+ * @param ativos Apontador para a estrutura que contém a lista de ativos.
+ * @param resumo Apontador para o resumo a preencher.
+ */
+void agregarAtivos (const Ativos *ativos, ResumoAtivos *resumo) {
+    memset(resumo, 0, sizeof(*resumo));
+    resumo->total = ativos->contador;
+    resumo->disponiveis = ativos->ativosDisponiveis;
+    resumo->idxMaisCorretivas = -1;
+
+    const ColunasAtivos *colunas = colunasAtivos(ativos);
+    if (colunas != NULL) {
+        agregarColunasAtivos(colunas, ativos->contador, resumo);
+        return;
+    }
+
+    int maior = 0;
+    for (int i = 0; i < ativos->contador; i++) {
+        const Ativo *ativo = &ativos->ativo[i];
+
+        if (ativo->estado >= OPERACIONAL && ativo->estado <= INATIVO2) {
+            resumo->porEstado[ativo->estado]++;
+        }
+        if (ativo->categoria >= VIATURA && ativo->categoria <= OUTRO) {
+            resumo->porCategoria[ativo->categoria]++;
         }
+        if (ativo->contagemManutencoesCorretivas > maior) {
+            maior = ativo->contagemManutencoesCorretivas;
+            resumo->idxMaisCorretivas = i;
+        }
+        resumo->custoTotal += ativo->custo;
+        resumo->custoManutencaoTotal += ativo->custoTotalAcumulado;
     }
-    return contador;
 }
 
+/**
+ * @brief Ordena os departamentos pela urgência mantida em ordens->urgencia, sem percorrer as ordens.
+ * @details A urgência de cada departamento (peso das prioridades: BAIXA=1, MEDIA=3, ALTA=5) é obtida em O(1)
+ * pelo ID e os departamentos com ordens são ordenados com selecionarTopK(), em O(D log D).
+ * @param departamentos Apontador para a estrutura que contém a lista de departamentos.
+ * @param ordens Apontador para a estrutura que contém a lista de ordens (e o agregado de urgência).
+ * @param comDecaimento 1 para ordenar pela urgência com decaimento das ordens fechadas, 0 para a soma de todos os pesos.
+ * @param resumo Apontador para o resumo a preencher.
+ * @return 1 em caso de sucesso, 0 se não houver memória.
+ */
+int agregarDepartamentos (const Departamentos *departamentos, const Ordens *ordens, int comDecaimento, ResumoDepartamentos *resumo) {
+    resumo->total = departamentos->contador;
+    resumo->ativos = departamentos->departamentosAtivos;
+    resumo->idxMaisUrgente = -1;
+    resumo->numRanking = 0;
+    resumo->ranking = malloc(((size_t)departamentos->contador + 1) * sizeof(EntradaRanking));
+    EntradaRanking *entradas = malloc(((size_t)departamentos->contador + 1) * sizeof(EntradaRanking));
+    if (resumo->ranking == NULL || entradas == NULL) {
+        registar_log("Erro: Falha ao alocar memória para o relatório de departamentos.");
+        free(resumo->ranking);
+        free(entradas);
+        resumo->ranking = NULL;
+        return 0;
+    }
+
+    Timestamp agora = timestampAtual();
+    int n = 0;
+    for (int i = 0; i < departamentos->contador; i++) {
+        const UrgenciaDepartamento *urgencia = procurarUrgenciaDepartamento(&ordens->urgencia,
+                                                                            departamentos->departamento[i].idDepartamento);
+        if (urgencia == NULL || urgencia->abertas + urgencia->fechadas == 0) continue;
+        entradas[n].valor = urgenciaDepartamento(&ordens->urgencia, urgencia, agora, comDecaimento);
+        entradas[n].posicao = i;
+        n++;
+    }
 
+    resumo->numRanking = selecionarTopK(entradas, n, n, resumo->ranking);
+    if (resumo->numRanking > 0 && resumo->ranking[0].valor > 0) {
+        resumo->idxMaisUrgente = resumo->ranking[0].posicao;
+    }
+    free(entradas);
+    return 1;
+}
 
 /**
- * @brief Função que exibe o ranking de desempenho dos técnicos de acordo com o número de ordens concluídas.
- * @param tecnicos Estrutura que contém a lista de tecnicos e contador.
- * @param ordens Estrutura que contém a lista de ordens e contador.
+ * @brief Liberta a memória de um resumo de departamentos.
+ * @param resumo Apontador para o resumo.
  */
-void mostrarRankingDesempenho(Tecnicos tecnicos, Ordens ordens) {
-    typedef struct {
-        int id;
-        char nome[50];
-        int totalConcluidas;
-    } AuxRanking;
-
-    AuxRanking ranking[tecnicos.contador];
-
-    for (int i = 0; i < tecnicos.contador; i++) {
-        ranking[i].id = tecnicos.tecnico[i].idTecnico;
-        strcpy(ranking[i].nome, tecnicos.tecnico[i].nome);
-
-        int concluidas = 0;
-        for (int j = 0; j < ordens.contador; j++) {
-            if (ordens.ordem[j].idTecnico == ranking[i].id &&
-                strcmp(passar_int_string_estado_tecnicos(ordens.ordem[j].estado), "Concluída") == 0) {
-                concluidas++;
-                }
+void libertarResumoDepartamentos (ResumoDepartamentos *resumo) {
+    free(resumo->ranking);
+    resumo->ranking = NULL;
+    resumo->numRanking = 0;
+}
+
+/**
+ * @brief Calcula os totais do relatório de técnicos numa única passagem pelos técnicos.
+ * @details As ordens em execução e concluídas de cada técnico são contadores mantidos pelas funções
+ * que alteram as ordens, pelo que as ordens não são percorridas.
+ * @param tecnicos Apontador para a estrutura que contém a lista de técnicos.
+ * @param resumo Apontador para o resumo a preencher.
+ */
+void agregarTecnicos (const Tecnicos *tecnicos, ResumoTecnicos *resumo) {
+    memset(resumo, 0, sizeof(*resumo));
+    resumo->total = tecnicos->contador;
+
+    for (int i = 0; i < tecnicos->contador; i++) {
+        const Tecnico *tecnico = &tecnicos->tecnico[i];
+
+        if (tecnico->estado_tecnico >= ATIVO1 && tecnico->estado_tecnico <= INATIVO1) {
+            resumo->porEstado[tecnico->estado_tecnico]++;
+        }
+        if (tecnico->especialidade >= TECNICO_TI && tecnico->especialidade <= OUTROS) {
+            resumo->porEspecialidade[tecnico->especialidade]++;
         }
-        ranking[i].totalConcluidas = concluidas;
-    }
-    for (int i = 0; i < ordens.contador - 1; i++) {
-        for (int j = 0; j < ordens.contador - i - 1; j++) {
-            if (ranking[j].totalConcluidas < ranking[j + 1].totalConcluidas) {
-                AuxRanking temp = ranking[j];
-                ranking[j] = ranking[j + 1];
-                ranking[j + 1] = temp;
+        resumo->emExecucao += tecnico->ordensEmExecucao;
+        resumo->concluidas += tecnico->ordensConcluidas;
+    }
+}
+
+/**
+ * @brief Calcula o ranking de técnicos segundo uma métrica, para depois mostrar uma ou mais páginas.
+ * @details O valor da métrica vem dos contadores mantidos (ordens concluídas de cada técnico e histogramas de
+ * tempos de resolução); só o custo de materiais precisa de uma passagem pelas ordens, com o custo de cada ordem
+ * obtido em O(1). Os limite melhores técnicos são selecionados com selecionarTopK(), em O(n log k), sem ordenar
+ * todos quando só é preciso a primeira página. Mudar de página não volta a fazer nenhum destes passos.
+ * @param tecnicos Apontador para a estrutura com a lista de técnicos.
+ * @param ordens Apontador para a estrutura de ordens (pode ser NULL em RANKING_CONCLUIDAS).
+ * @param materiais Apontador para a estrutura de materiais (pode ser NULL se a métrica não for RANKING_CUSTO_MATERIAIS).
+ * @param metrica Métrica usada para ordenar.
+ * @param limite Número de técnicos a ordenar (0 ordena todos).
+ * @param ranking Apontador para o resultado (libertar com libertarRankingTecnicos()).
+ * @return 1 em caso de sucesso, 0 se a métrica não estiver disponível ou não houver memória.
+ */
+int calcularRankingTecnicos(const Tecnicos *tecnicos, const Ordens *ordens, const Materiais *materiais,
+                            MetricaRanking metrica, int limite, RankingTecnicos *ranking) {
+    ranking->metrica = metrica;
+    ranking->ordenados = NULL;
+    ranking->numOrdenados = 0;
+    ranking->classificados = 0;
+
+    if ((metrica == RANKING_TEMPO_MEDIANO && (ordens == NULL || ordens->resolucao == NULL)) ||
+        (metrica == RANKING_CUSTO_MATERIAIS && (ordens == NULL || materiais == NULL)) || limite < 0) {
+        printf("Erro: ranking indisponível.\n");
+        return 0;
+    }
+
+    int n = tecnicos->contador;
+    EntradaRanking *entradas = malloc(((size_t)n + 1) * sizeof(EntradaRanking));
+    double *custos = (metrica == RANKING_CUSTO_MATERIAIS) ? calloc((size_t)n + 1, sizeof(double)) : NULL;
+    if (entradas == NULL || (metrica == RANKING_CUSTO_MATERIAIS && custos == NULL)) {
+        printf("Erro: sem memória para o ranking.\n");
+        registar_log("Erro: Falha ao alocar memória para o ranking de técnicos.");
+        free(entradas);
+        free(custos);
+        return 0;
+    }
+
+    if (metrica == RANKING_CUSTO_MATERIAIS) {
+        for (int i = 0; i < ordens->contador; i++) {
+            if (ordens->ordem[i].estado != CONCLUIDA) continue;
+            int idxTec = procurarIndice(&tecnicos->indice, ordens->ordem[i].idTecnico);
+            if (idxTec != -1) custos[idxTec] += custoMateriaisOrdem(materiais, ordens->ordem[i].idOrdem);
+        }
+    }
+
+    int classificados = 0;
+    for (int i = 0; i < n; i++) {
+        const Tecnico *tecnico = &tecnicos->tecnico[i];
+        double valor;
+        switch (metrica) {
+            case RANKING_TEMPO_MEDIANO: {
+                const HistogramaTempos *histograma = procurarHistogramaDoID(&ordens->resolucao->porTecnico, tecnico->idTecnico);
+                if (histograma == NULL || histograma->total == 0) continue;
+                valor = -(double)quantilHistograma(histograma, 0.5);
+                break;
             }
+            case RANKING_CUSTO_MATERIAIS:
+                valor = custos[i];
+                break;
+            case RANKING_CONCLUIDAS:
+            default:
+                valor = tecnico->ordensConcluidas;
+                break;
         }
+        entradas[classificados].valor = valor;
+        entradas[classificados].posicao = i;
+        classificados++;
+    }
+    free(custos);
+
+    int k = (limite == 0 || limite > classificados) ? classificados : limite;
+    ranking->ordenados = malloc(((size_t)k + 1) * sizeof(EntradaRanking));
+    if (ranking->ordenados == NULL) {
+        printf("Erro: sem memória para o ranking.\n");
+        registar_log("Erro: Falha ao alocar memória para o ranking de técnicos.");
+        free(entradas);
+        return 0;
     }
-    printf("\n===== RANKING DE DESEMPENHO =====\n");
+    ranking->numOrdenados = selecionarTopK(entradas, classificados, k, ranking->ordenados);
+    ranking->classificados = classificados;
+    free(entradas);
+    return 1;
+}
 
-    for (int i = 0; i < tecnicos.contador; i++) {
-        printf("%d. %s - %d ordens concluidas\n",
-               i + 1,
-               ranking[i].nome,
-               ranking[i].totalConcluidas);
+/**
+ * @brief Mostra uma página de um ranking já calculado, sem voltar a percorrer técnicos nem ordens.
+ * @param ranking Ranking devolvido por calcularRankingTecnicos().
+ * @param tecnicos Apontador para a estrutura com a lista de técnicos (a mesma usada no cálculo).
+ * @param pagina Página a mostrar (a primeira é 0); só são mostradas as entradas já ordenadas.
+ * @param tamanhoPagina Número de técnicos por página.
+ */
+void mostrarPaginaRankingTecnicos(const RankingTecnicos *ranking, const Tecnicos *tecnicos, int pagina, int tamanhoPagina) {
+    MetricaRanking metrica = ranking->metrica;
+    int inicio = pagina * tamanhoPagina;
+    int fim = (inicio + tamanhoPagina < ranking->numOrdenados) ? inicio + tamanhoPagina : ranking->numOrdenados;
+    int paginas = (ranking->classificados + tamanhoPagina - 1) / tamanhoPagina;
+
+    printf("\n===== RANKING DE DESEMPENHO (%s) =====\n",
+           metrica == RANKING_TEMPO_MEDIANO ? "menor tempo mediano de resolução" :
+           metrica == RANKING_CUSTO_MATERIAIS ? "maior custo de materiais" : "ordens concluídas");
+
+    char duracao[TAMANHO_DATA_TEXTO];
+    for (int r = inicio; r < fim; r++) {
+        const EntradaRanking *entrada = &ranking->ordenados[r];
+        const Tecnico *tecnico = &tecnicos->tecnico[entrada->posicao];
+        switch (metrica) {
+            case RANKING_TEMPO_MEDIANO:
+                printf("%d. %s - mediana %s (%d ordens concluidas)\n", r + 1, tecnico->nome,
+                       formatarDuracao((int64_t)-entrada->valor, duracao, sizeof(duracao)), tecnico->ordensConcluidas);
+                break;
+            case RANKING_CUSTO_MATERIAIS:
+                printf("%d. %s - %.2f euros em materiais\n", r + 1, tecnico->nome, entrada->valor);
+                break;
+            case RANKING_CONCLUIDAS:
+            default:
+                printf("%d. %s - %d ordens concluidas\n", r + 1, tecnico->nome, tecnico->ordensConcluidas);
+                break;
+        }
+    }
+    if (ranking->classificados == 0) {
+        printf("Não existem técnicos com dados para esta métrica.\n");
+    } else {
+        printf("Página %d de %d\n", pagina + 1, paginas);
     }
 }
 
-void listarTecnciosOcupados (Tecnicos *tecnicos, Ordens *ordens) {
-    printf ("\n===== TECNICOS OCUPADOS =====\n");
-    for (int i=0; i < tecnicos->contador; i++) {
-        if (tecnicos->tecnico[i].estado_tecnico == OCUPADO)
-            printf ("ID: %d", tecnicos->tecnico[i].idTecnico);
-        printf ("Nome: %s\n", tecnicos->tecnico[i].nome);
-        printf ("Especialidade: %s\n",passar_int_string_especialidade(tecnicos->tecnico[i].especialidade));
-        printf ("Estado: %s\n", passar_int_string_estado(tecnicos->tecnico[i].estado_tecnico));
-        printf("Taxa ocupação: %d", mostrarTaxaOcupacaoTecnico(&tecnicos->tecnico[i], ordens));
+/**
+ * @brief Liberta a memória de um ranking de técnicos.
+ * @param ranking Apontador para o ranking.
+ */
+void libertarRankingTecnicos(RankingTecnicos *ranking) {
+    free(ranking->ordenados);
+    ranking->ordenados = NULL;
+    ranking->numOrdenados = 0;
+    ranking->classificados = 0;
+}
+
+/**
+ * @brief Mostra uma página do ranking de técnicos segundo uma métrica (calcula só as entradas até essa página).
+ * @param tecnicos Apontador para a estrutura com a lista de técnicos.
+ * @param ordens Apontador para a estrutura de ordens (pode ser NULL em RANKING_CONCLUIDAS).
+ * @param materiais Apontador para a estrutura de materiais (pode ser NULL se a métrica não for RANKING_CUSTO_MATERIAIS).
+ * @param metrica Métrica usada para ordenar.
+ * @param pagina Página a mostrar (a primeira é 0).
+ * @param tamanhoPagina Número de técnicos por página.
+ * @return Número de técnicos classificados (para calcular o número de páginas) ou -1 em caso de erro.
+ */
+int mostrarRankingTecnicos(const Tecnicos *tecnicos, const Ordens *ordens, const Materiais *materiais,
+                           MetricaRanking metrica, int pagina, int tamanhoPagina) {
+    if (pagina < 0 || tamanhoPagina <= 0) {
+        printf("Erro: ranking indisponível.\n");
+        return -1;
     }
+
+    RankingTecnicos ranking;
+    if (!calcularRankingTecnicos(tecnicos, ordens, materiais, metrica, (pagina + 1) * tamanhoPagina, &ranking)) return -1;
+
+    mostrarPaginaRankingTecnicos(&ranking, tecnicos, pagina, tamanhoPagina);
+    int classificados = ranking.classificados;
+    libertarRankingTecnicos(&ranking);
+    return classificados;
 }
 
-void listarTecnicosEspecialidade (Tecnicos *tecnicos, Especialidade especialidade, Ordens *ordens) {
-    printf("\n===== TECNICOS POR ESPECIALIDADE =====\n");
-    for (int i = 0; i < tecnicos->contador; i++) {
-        if (tecnicos->tecnico[i].especialidade == especialidade) {
-            printf("Nome: %s\n", tecnicos->tecnico[i].nome);
-            printf("Especialidade: %s\n", passar_int_string_especialidade(tecnicos->tecnico[i].especialidade));
-            printf("Estado: %s\n", passar_int_string_estado(tecnicos->tecnico[i].estado_tecnico));
-            printf("Taxa de ocupação: %d", mostrarTaxaOcupacaoTecnico(&tecnicos->tecnico[i], ordens));
+/**
+ * @brief Mostra os dados de um técnico numa listagem do relatório.
+ * @param tecnico Apontador para o técnico.
+ */
+static void mostrarTecnicoRelatorio (const Tecnico *tecnico) {
+    printf ("ID: %d\n", tecnico->idTecnico);
+    printf ("Nome: %s\n", tecnico->nome);
+    printf ("Especialidade: %s\n", passar_int_string_especialidade(tecnico->especialidade));
+    printf ("Estado: %s\n", passar_int_string_estado(tecnico->estado_tecnico));
+    printf ("Taxa de ocupação: %.1f%%\n", mostrarTaxaOcupacaoTecnico(tecnico));
+    if (tecnico->ordensEmExecucao > 0) {
+        int guardados = tecnico->ordensEmExecucao < LIMITE_ORDENS_TECNICO ? tecnico->ordensEmExecucao : LIMITE_ORDENS_TECNICO;
+        printf ("Ordens em execução:");
+        for (int k = 0; k < guardados; k++) {
+            printf (" %d", tecnico->idsEmExecucao[k]);
         }
+        printf ("\n");
     }
 }
 
 /**
- * @brief Função que lista apenas os técnicos ativos.
- * @param tecnicos Estrutura com o array de técnicos e contador.
- * @note Apenas são listados os técnicos com estado ATIVO1.
+ * @brief Função que lista os técnicos ocupados.
+ * @param tecnicos Apontador para a estrutura com o array de técnicos e contador.
+ * @param resumo Resumo com o número de técnicos por estado e especialidade.
  */
-static void listar_tecnicos_ativos_relatorio (Tecnicos *tecnicos, Ordens *ordens) {
-    printf ("\n===== TECNICOS ATIVOS =====\n");
+static void listarTecnciosOcupados (const Tecnicos *tecnicos, const ResumoTecnicos *resumo) {
+    printf ("\n===== TECNICOS OCUPADOS (%d) =====\n", resumo->porEstado[OCUPADO]);
     for (int i=0; i < tecnicos->contador; i++) {
-        if (tecnicos->tecnico[i].estado_tecnico == ATIVO1)
-            printf ("ID: %d", tecnicos->tecnico[i].idTecnico);
-        printf ("Nome: %s\n", tecnicos->tecnico[i].nome);
-        printf ("Especialidade: %s",passar_int_string_especialidade(tecnicos->tecnico[i].especialidade));
-        printf ("Estado: %s\n", passar_int_string_estado(tecnicos->tecnico[i].estado_tecnico));
-        printf("Taxa de ocupação: %d\n", mostrarTaxaOcupacaoTecnico(&tecnicos->tecnico[i], ordens));
+        if (tecnicos->tecnico[i].estado_tecnico == OCUPADO) {
+            mostrarTecnicoRelatorio(&tecnicos->tecnico[i]);
+        }
     }
 }
 
 /**
- * @brief Conta quantos ativos existem numa determinada categoria.
- * @param ativos Estrutura que contém a lista de ativos.
- * @param categoria_ativo Categoria que pretende contar.
- * @return Retorna o número de ativos na categoria indicada.
+ * @brief Função que lista os técnicos de uma especialidade.
+ * @param tecnicos Apontador para a estrutura com o array de técnicos e contador.
+ * @param especialidade Especialidade a listar.
+ * @param resumo Resumo com o número de técnicos por estado e especialidade.
  */
-int contadorPorCategoria (Ativos ativos, CategoriaAtivo categoria_ativo) {
-    int contador = 0;
-    for (int i = 0; i<ativos.contador; i++) {
-        if (ativos.ativo[i].categoria == categoria_ativo) {
-            contador++;
+static void listarTecnicosEspecialidade (const Tecnicos *tecnicos, Especialidade especialidade, const ResumoTecnicos *resumo) {
+    printf("\n===== TECNICOS POR ESPECIALIDADE (%s: %d) =====\n", passar_int_string_especialidade(especialidade), resumo->porEspecialidade[especialidade]);
+    for (int i = 0; i < tecnicos->contador; i++) {
+        if (tecnicos->tecnico[i].especialidade == especialidade) {
+            mostrarTecnicoRelatorio(&tecnicos->tecnico[i]);
+        }
+    }
+}
+
+/**
+ * @brief Função que lista apenas os técnicos ativos.
+ * @param tecnicos Apontador para a estrutura com o array de técnicos e contador.
+ * @note Apenas são listados os técnicos com estado ATIVO1.
+ * @param resumo Resumo com o número de técnicos por estado e especialidade.
+ */
+static void listar_tecnicos_ativos_relatorio (const Tecnicos *tecnicos, const ResumoTecnicos *resumo) {
+    printf ("\n===== TECNICOS ATIVOS (%d) =====\n", resumo->porEstado[ATIVO1]);
+    for (int i=0; i < tecnicos->contador; i++) {
+        if (tecnicos->tecnico[i].estado_tecnico == ATIVO1) {
+            mostrarTecnicoRelatorio(&tecnicos->tecnico[i]);
         }
     }
-    return contador;
 }
 
 /**
  * @brief Calcula o tempo médio de resolução das ordens concluídas.
- * @details A função calcula a diferença (em segundos) entre a data/hora de início e fim de cada
+ * @details A função calcula a diferença (em segundos) entre o início e o fim de cada
  * ordem concluída e devolve a média.
  * @param ordens Apontador para a estrutura que contém as ordens.
  * @return Retorna o tempo médio (em segundos). Caso não existam ordens concluídas retorna 0.
@@ -149,137 +407,118 @@ float tempoMedioResolucaoOrdens (Ordens *ordens) {
         return 0;
     }
 
-    float soma = 0;
+    /* As datas são segundos desde 1970: a duração é uma subtração, somada em inteiro para não perder precisão. */
+    int64_t soma = 0;
     int total = 0;
 
     for (int i = 0; i < ordens->contador; i++) {
-        if (ordens->ordem[i].estado == CONCLUIDA) {
-            if (ordens->ordem[i].anoInicio == 0 || ordens->ordem[i].anoFim == 0) {
-                continue;
-            }
-
-            struct tm inicio = {
-                .tm_mday = ordens->ordem[i].diaInicio,
-                .tm_mon = ordens->ordem[i].mesInicio - 1,
-                .tm_year = ordens->ordem[i].anoInicio - 1900,
-                .tm_hour = ordens->ordem[i].horaInicio,
-                .tm_min = ordens->ordem[i].minInicio,
-                .tm_sec = ordens->ordem[i].segInicio
-        };
-
-            struct tm fim = {
-                .tm_mday = ordens->ordem[i].diaFim,
-                .tm_mon = ordens->ordem[i].mesFim - 1,
-                .tm_year = ordens->ordem[i].anoFim - 1900,
-                .tm_hour = ordens->ordem[i].horaFim,
-                .tm_min = ordens->ordem[i].minFim,
-                .tm_sec = ordens->ordem[i].segFim
-        };
-
-            time_t tInicio = mktime(&inicio);
-            time_t tFim = mktime(&fim);
-
-            if (tInicio == (time_t)-1 || tFim == (time_t)-1) {
-                continue;
-            }
-
-            float diferenca = (float)difftime(tFim, tInicio);
-            if (diferenca < 0) {
-                continue;
-            }
+        const Ordem *ordem = &ordens->ordem[i];
+        if (ordem->estado != CONCLUIDA || ordem->inicio == SEM_DATA || ordem->fim == SEM_DATA) {
+            continue;
+        }
 
-            soma += diferenca;
-            total++;
+        int64_t diferenca = ordem->fim - ordem->inicio;
+        if (diferenca < 0) {
+            continue;
         }
+
+        soma += diferenca;
+        total++;
     }
 
     if (total == 0) {
         return 0;
     }
 
-    return soma / (float)total;
-}
-
-
-int procurarIndiceMaisCorretivas (Ativos ativos) {
-    int maior = 0;
-    int indice =0;
-    for (int i = 0; i < ativos.contador; i++) {
-        if (ativos.ativo[i].contagemManutencoesCorretivas > maior) {
-            maior = ativos.ativo[i].contagemManutencoesCorretivas;
-            indice = i;
-        }
-    }
-    return indice;
+    return (float)((double)soma / total);
 }
 
-char *departamentosMaisUrgentes (Departamentos *departamentos, Ordens *ordens) {
-    int indice_maior = 0;
-    int total = 0;
-
-    if (ordens->contador == 0) {
-        return "n/a";
-    }
-    for (int i = 0; i<departamentos->contador; i++) {
-        int soma = 0;
-        for (int j = 0; j < ordens->contador; j++) {
-            if (departamentos->departamento[i].idDepartamento == ordens->ordem[j].idDepartamento) {
-                switch (ordens->ordem[j].prioridade) {
-                    case BAIXA: {
-                        soma += 1;
-                        break;
-                    }
-                    case MEDIA: {
-                        soma += 3;
-                        break;
-                    }
-                    case ALTA: {
-                        soma += 5;
-                        break;
-                    }
-                }
-                }
-            }
-        if (soma > total) {
-            total = soma;
-            indice_maior = i;
-        }
-    }
-    return departamentos->departamento[indice_maior].nomeDepartamento;
-}
 
+/**
+ * @brief Mostra o relatório geral de ativos.
+ * @details Todas as contagens vêm de agregarAtivos(), que percorre o array de ativos uma única vez.
+ * @param ativos Apontador para a estrutura que contém a lista de ativos.
+ */
 void mostrarRelatorioAtivos(Ativos *ativos) {
+    ResumoAtivos resumo;
+    agregarAtivos(ativos, &resumo);
+
     printf("\n==== RELATÓRIO DE ATIVOS ====\n");
-    printf("Numero total de ativos: %d\n", ativos->contador);
-    printf("Numero de ativos no sistema (não inclui os ativos previamente abatidos): %d\n", ativos->ativosDisponiveis);
-    printf("Número de ativos operacionais: %d\t\tNumero de viaturas: %d\t\t Numero de ferramentas: %d\n", contadorPorEstado(*ativos,OPERACIONAL), contadorPorCategoria(*ativos, VIATURA), contadorPorCategoria(*ativos, FERRAMENTA));
-    printf("Numero de ativos em manutenção: %d\t\tNumero de itens de informática: %d\t\tOutros tipos de ativos: %d\n", contadorPorEstado(*ativos, EM_MANUTENCAO), contadorPorCategoria(*ativos, INFORMATICA), contadorPorCategoria(*ativos,OUTRO));
-    printf("Numero de ativos abatidos: %d\t\tNumero de itens de mobiliário: %d\n", contadorPorEstado(*ativos, ABATIDO), contadorPorCategoria(*ativos, MOBILIARIO));
-    if (ativos->ativo[procurarIndiceMaisCorretivas(*ativos)].contagemManutencoesCorretivas == 0) {
+    printf("Numero total de ativos: %d\n", resumo.total);
+    printf("Numero de ativos no sistema (não inclui os ativos previamente abatidos): %d\n", resumo.disponiveis);
+    printf("Número de ativos operacionais: %d\t\tNumero de viaturas: %d\t\t Numero de ferramentas: %d\n", resumo.porEstado[OPERACIONAL], resumo.porCategoria[VIATURA], resumo.porCategoria[FERRAMENTA]);
+    printf("Numero de ativos em manutenção: %d\t\tNumero de itens de informática: %d\t\tOutros tipos de ativos: %d\n", resumo.porEstado[EM_MANUTENCAO], resumo.porCategoria[INFORMATICA], resumo.porCategoria[OUTRO]);
+    printf("Numero de ativos abatidos: %d\t\tNumero de itens de mobiliário: %d\n", resumo.porEstado[ABATIDO], resumo.porCategoria[MOBILIARIO]);
+    printf("Valor total dos ativos: %.2f euros\t\tCusto acumulado em manutenções: %.2f euros\n", resumo.custoTotal, resumo.custoManutencaoTotal);
+    if (resumo.idxMaisCorretivas == -1) {
         printf("Ativo com mais manutenções Corretivas: n/a Nº de correções: n/a\n");
+    } else {
+        const Ativo *ativo = &ativos->ativo[resumo.idxMaisCorretivas];
+        printf("Ativo com mais manutenções Corretivas: %s Nº de correções: %d\n", ativo->designacao, ativo->contagemManutencoesCorretivas);
     }
-    if (ativos->ativo[procurarIndiceMaisCorretivas(*ativos)].contagemManutencoesCorretivas > 0)
-    printf("Ativo com mais manutenções Corretivas: %s Nº de correções: %d\n", ativos->ativo[procurarIndiceMaisCorretivas(*ativos)].designacao, ativos->ativo[procurarIndiceMaisCorretivas(*ativos)].contagemManutencoesCorretivas);
 }
 
+/**
+ * @brief Mostra o relatório geral de departamentos.
+ * @details A urgência de cada departamento vem do agregado ordens->urgencia, mantido por contabilizarOrdem(),
+ * e é lida por agregarDepartamentos() sem percorrer as ordens.
+ * @param departamentos Apontador para a estrutura que contém a lista de departamentos.
+ * @param ativos Apontador para a estrutura que contém a lista de ativos.
+ * @param ordens Apontador para a estrutura que contém a lista de ordens.
+ */
 void mostrarRelatorioDepartamentos (Departamentos *departamentos, Ativos *ativos, Ordens *ordens) {
+    ResumoDepartamentos resumo;
+    if (!agregarDepartamentos(departamentos, ordens, 0, &resumo)) {
+        printf("Erro: sem memória para gerar o relatório.\n");
+        return;
+    }
+
     printf("\n==== RELATÓRIO DE DEPARTAMENTOS ====\n");
-    printf("Numero total de departamentos: %d\n", departamentos->contador);
-    printf("Numero de departamentos ativos: %d\n", departamentos->departamentosAtivos);
-    printf("Numero de departamentos inativos: %d\n", (departamentos->contador - departamentos->departamentosAtivos));
+    printf("Numero total de departamentos: %d\n", resumo.total);
+    printf("Numero de departamentos ativos: %d\n", resumo.ativos);
+    printf("Numero de departamentos inativos: %d\n", (resumo.total - resumo.ativos));
     listar_ativos_por_departamento(*departamentos, *ativos);
-    printf("Departamento com mais pedidos de manutenção urgentes: %s\n", departamentosMaisUrgentes(departamentos, ordens));
+    printf("Departamento com mais pedidos de manutenção urgentes: %s\n",
+           resumo.idxMaisUrgente == -1 ? "n/a" : departamentos->departamento[resumo.idxMaisUrgente].nomeDepartamento);
+
+    if (resumo.numRanking > 0) {
+        Timestamp agora = timestampAtual();
+        printf("\n===== URGÊNCIA POR DEPARTAMENTO (BAIXA=1, MEDIA=3, ALTA=5) =====\n");
+        printf("%-4s %-25s %9s %16s %16s %15s\n", "Pos", "Departamento", "Urgência", "Abertas (urg.)", "Fechadas (urg.)", "Com decaimento");
+        for (int r = 0; r < resumo.numRanking; r++) {
+            const Departamento *d = &departamentos->departamento[resumo.ranking[r].posicao];
+            const UrgenciaDepartamento *u = procurarUrgenciaDepartamento(&ordens->urgencia, d->idDepartamento);
+            printf("%-4d %-25.25s %9.0f %8d (%5d) %8d (%5d) %15.1f\n", r + 1, d->nomeDepartamento, resumo.ranking[r].valor,
+                   u->abertas, u->urgenciaAbertas, u->fechadas, u->urgenciaFechadas,
+                   urgenciaDepartamento(&ordens->urgencia, u, agora, 1));
+        }
+        printf("(Com decaimento: o peso das ordens fechadas passa a metade a cada %d dias.)\n", URGENCIA_MEIA_VIDA / 86400);
+    }
+
+    libertarResumoDepartamentos(&resumo);
 }
 
-void mostrarRelatorioTecnicos (Tecnicos *tecnicos, Ordens *ordens) {
-    listar_tecnicos_ativos_relatorio(tecnicos, ordens);
-    listarTecnciosOcupados(tecnicos, ordens);
-    listarTecnicosEspecialidade(tecnicos, TECNICO_TI, ordens);
-    listarTecnicosEspecialidade(tecnicos, MECANICO, ordens);
-    listarTecnicosEspecialidade(tecnicos, ELETRICISTA, ordens);
-    listarTecnicosEspecialidade(tecnicos, MANUTENCAO_GERAL, ordens);
-    listarTecnicosEspecialidade(tecnicos, OUTROS, ordens);
-    mostrarRankingDesempenho(*tecnicos, *ordens);
+/**
+ * @brief Mostra o relatório geral de técnicos.
+ * @details Os totais são calculados por agregarTecnicos() e os valores de cada técnico (ordens em execução
+ * e concluídas) vêm dos contadores mantidos, pelo que o relatório não percorre as ordens.
+ * @param tecnicos Apontador para a estrutura que contém a lista de técnicos.
+ */
+void mostrarRelatorioTecnicos (Tecnicos *tecnicos) {
+    ResumoTecnicos resumo;
+    agregarTecnicos(tecnicos, &resumo);
+
+    printf("\n==== RELATÓRIO DE TÉCNICOS ====\n");
+    printf("Numero total de técnicos: %d\n", resumo.total);
+    printf("Ordens em execução: %d\t\tOrdens concluídas: %d\n", resumo.emExecucao, resumo.concluidas);
+    listar_tecnicos_ativos_relatorio(tecnicos, &resumo);
+    listarTecnciosOcupados(tecnicos, &resumo);
+    listarTecnicosEspecialidade(tecnicos, TECNICO_TI, &resumo);
+    listarTecnicosEspecialidade(tecnicos, MECANICO, &resumo);
+    listarTecnicosEspecialidade(tecnicos, ELETRICISTA, &resumo);
+    listarTecnicosEspecialidade(tecnicos, MANUTENCAO_GERAL, &resumo);
+    listarTecnicosEspecialidade(tecnicos, OUTROS, &resumo);
+    mostrarRankingTecnicos(tecnicos, NULL, NULL, RANKING_CONCLUIDAS, 0, RANKING_TAMANHO_PAGINA);
 }
 
 void mostrarRelatorioOrdens (Ordens *ordens, Materiais materiais) {
@@ -293,11 +532,19 @@ void mostrarRelatorioOrdens (Ordens *ordens, Materiais materiais) {
     listarOrdensTipo(ordens, PREVENTIVA, materiais);
     listarOrdensTipo(ordens, CORRETIVA, materiais);
     printf("Tempo médio de resolução: %f", tempoMedioResolucaoOrdens(ordens));
+    if (ordens->resolucao != NULL && ordens->resolucao->geral.total > 0) {
+        char p50[TAMANHO_DATA_TEXTO], p90[TAMANHO_DATA_TEXTO], p99[TAMANHO_DATA_TEXTO];
+        const HistogramaTempos *geral = &ordens->resolucao->geral;
+        printf("\nTempo de resolução p50: %s | p90: %s | p99: %s",
+               formatarDuracao(quantilHistograma(geral, 0.50), p50, sizeof(p50)),
+               formatarDuracao(quantilHistograma(geral, 0.90), p90, sizeof(p90)),
+               formatarDuracao(quantilHistograma(geral, 0.99), p99, sizeof(p99)));
+    }
 }
 
 /**
  * @brief Mostra um alerta com os ativos que têm muitas ocorrências associadas.
- * @details Percorre os ativos e conta quantas ordens estão associadas a cada um.
+ * @details Percorre os ativos e usa o número de ordens associadas a cada um (contador mantido em Ativo).
  * Se um ativo tiver 5 ou mais ocorrências, é apresentado como "instável".
  * @param ativos Estrutura com a lista de ativos.
  * @param ordens Estrutura com a lista de ordens.
@@ -318,19 +565,14 @@ void relatorioAtivosInstaveis(Ativos ativos, Ordens ordens) {
     }
 
     for (int i = 0; i < ativos.contador; i++) {
-        int contagem = 0;
-
-        for (int j = 0; j < ordens.contador; j++) {
-            if (ordens.ordem[j].idAtivo == ativos.ativo[i].id) {
-                contagem++;
-            }
-        }
+        int contagem = ativos.ativo[i].totalOrdens;
 
         if (contagem >= 5) {
-            printf("%s (ID %d) - %d ocorrências registadas!\n",
+            printf("%s (ID %d) - %d ocorrências registadas (%d corretivas)!\n",
                    ativos.ativo[i].designacao ? ativos.ativo[i].designacao : "(sem designação)",
                    ativos.ativo[i].id,
-                   contagem);
+                   contagem,
+                   ativos.ativo[i].contagemManutencoesCorretivas);
             encontrou = 1;
         }
     }
@@ -340,70 +582,177 @@ void relatorioAtivosInstaveis(Ativos ativos, Ordens ordens) {
     }
 }
 
+/**
+ * @brief Local e número de incidências, usado para ordenar o relatório por local.
+ */
+typedef struct {
+    const char *local;
+    int contagem;
+}IncidenciasLocal;
+
+/**
+ * @brief Compara dois locais por número de incidências (decrescente) e, em caso de empate, por nome.
+ * @param a Apontador para o primeiro IncidenciasLocal.
+ * @param b Apontador para o segundo IncidenciasLocal.
+ * @return Valor negativo, zero ou positivo, como em qsort().
+ */
+static int compararIncidenciasLocal(const void *a, const void *b) {
+    const IncidenciasLocal *la = a;
+    const IncidenciasLocal *lb = b;
+
+    if (la->contagem != lb->contagem) {
+        return (la->contagem < lb->contagem) ? 1 : -1;
+    }
+    return strcmp(la->local, lb->local);
+}
+
 /**
  * @brief Mostra uma análise de incidências agrupada por local.
- * @details Para cada ativo, conta quantas ordens existem e soma o total no local do ativo.
- * No fim apresenta o número de ordens por local.
- * @param ativos Estrutura com a lista de ativos.
- * @param ordens Estrutura com a lista de ordens.
+ * @details Usa o número de ordens de cada ativo (contador mantido em Ativo) e o ID que o pool de strings
+ * dos ativos já atribuiu a cada local (idStringPool(), uma procura na tabela de hash do pool); as ordens são
+ * somadas num array indexado por esse ID. No fim os locais são ordenados por número de incidências.
+ * Custo O(A + S + L log L), em que S é o número de strings do pool, sem arrays na stack.
+ * @param ativos Apontador para a estrutura com a lista de ativos.
+ * @param ordens Apontador para a estrutura com a lista de ordens.
+ * @param limite Número máximo de locais a mostrar (0 mostra todos).
  */
-void relatorioProblemasPorLocal(Ativos ativos, Ordens ordens) {
+void relatorioProblemasPorLocal(const Ativos *ativos, const Ordens *ordens, int limite) {
     printf("\n===== ANÁLISE DE INCIDÊNCIAS POR LOCAL =====\n");
 
-    if (ativos.contador == 0 || ativos.ativo == NULL) {
+    if (ativos->contador == 0 || ativos->ativo == NULL) {
         printf("Não existem ativos registados.\n");
         return;
     }
 
-    if (ordens.contador == 0 || ordens.ordem == NULL) {
+    if (ordens->contador == 0 || ordens->ordem == NULL) {
         printf("Não existem ordens registadas.\n");
         return;
     }
-    const char *locais[ativos.contador];
-    int contagens[ativos.contador];
-    int totalLocais = 0;
-
-    for (int i = 0; i < ativos.contador; i++) {
-        int contagemAtivo = 0;
 
-        for (int j = 0; j < ordens.contador; j++) {
-            if (ordens.ordem[j].idAtivo == ativos.ativo[i].id) {
-                contagemAtivo++;
-            }
-        }
+    /* um contador por string do pool dos ativos; a última posição junta os ativos sem local */
+    int numIDs = numStringsPool(&ativos->strings);
+    int *contagens = calloc((size_t)numIDs + 1, sizeof(int));
+    if (contagens == NULL) {
+        printf("Erro ao alocar memória para o relatório.\n");
+        registar_log("Erro: Falha ao alocar memória para o relatório de incidências por local.");
+        return;
+    }
 
-        if (contagemAtivo == 0) {
-            continue;
-        }
+    for (int i = 0; i < ativos->contador; i++) {
+        const char *local = ativos->ativo[i].localizacao;
+        int id = (local == NULL || local[0] == '\0') ? -1 : idStringPool(&ativos->strings, local);
+        contagens[id != -1 ? id : numIDs] += ativos->ativo[i].totalOrdens;
+    }
 
-        const char *local = ativos.ativo[i].localizacao;
-        if (local == NULL || local[0] == '\0') {
-            local = "(sem local)";
-        }
+    int totalLocais = 0;
+    for (int id = 0; id <= numIDs; id++) {
+        if (contagens[id] > 0) totalLocais++;
+    }
 
-        int indice = -1;
-        for (int k = 0; k < totalLocais; k++) {
-            if (strcmp(locais[k], local) == 0) {
-                indice = k;
-                break;
-            }
-        }
+    IncidenciasLocal *locais = malloc(((size_t)totalLocais + 1) * sizeof(IncidenciasLocal));
+    if (locais == NULL) {
+        printf("Erro ao alocar memória para o relatório.\n");
+        registar_log("Erro: Falha ao alocar memória para o relatório de incidências por local.");
+        free(contagens);
+        return;
+    }
 
-        if (indice == -1) {
-            locais[totalLocais] = local;
-            contagens[totalLocais] = contagemAtivo;
-            totalLocais++;
-        } else {
-            contagens[indice] += contagemAtivo;
-        }
+    int n = 0;
+    for (int id = 0; id <= numIDs; id++) {
+        if (contagens[id] == 0) continue;
+        locais[n].local = id < numIDs ? stringPool(&ativos->strings, id) : "(sem local)";
+        locais[n].contagem = contagens[id];
+        n++;
     }
+    free(contagens);
 
     if (totalLocais == 0) {
         printf("Não existem incidências associadas a nenhum local.\n");
+        free(locais);
+        return;
+    }
+
+    qsort(locais, (size_t)totalLocais, sizeof(IncidenciasLocal), compararIncidenciasLocal);
+
+    int mostrar = (limite > 0 && limite < totalLocais) ? limite : totalLocais;
+    for (int i = 0; i < mostrar; i++) {
+        printf("Local: %s - %d ordens\n", locais[i].local, locais[i].contagem);
+    }
+    if (mostrar < totalLocais) {
+        printf("... e mais %d locais\n", totalLocais - mostrar);
+    }
+
+    free(locais);
+}
+
+/**
+ * @brief Mostra uma linha do relatório de tempos de resolução.
+ * @param grupo Nome do grupo.
+ * @param histograma Histograma do grupo.
+ */
+static void mostrarLinhaTempos(const char *grupo, const HistogramaTempos *histograma) {
+    char p50[TAMANHO_DATA_TEXTO], p90[TAMANHO_DATA_TEXTO], p99[TAMANHO_DATA_TEXTO];
+    printf("%-30.30s %7d %16s %16s %16s\n", grupo, histograma->total,
+           formatarDuracao(quantilHistograma(histograma, 0.50), p50, sizeof(p50)),
+           formatarDuracao(quantilHistograma(histograma, 0.90), p90, sizeof(p90)),
+           formatarDuracao(quantilHistograma(histograma, 0.99), p99, sizeof(p99)));
+}
+
+/**
+ * @brief Mostra os percentis p50/p90/p99 do tempo de resolução das ordens concluídas: no geral, por prioridade,
+ * por tipo de manutenção, por departamento e por técnico.
+ * @details Os histogramas são mantidos por contabilizarOrdem() sempre que uma ordem é concluída, pelo que o
+ * relatório não percorre as ordens: cada linha custa HISTOGRAMA_BALDES passos.
+ * Os percentis são aproximados (centro do balde, erro relativo até 1/16).
+ * @param ordens Apontador para a estrutura com a lista de ordens (e os histogramas mantidos).
+ * @param departamentos Apontador para a estrutura com a lista de departamentos.
+ * @param tecnicos Apontador para a estrutura com a lista de técnicos.
+ */
+void relatorioTemposResolucao(const Ordens *ordens, const Departamentos *departamentos, const Tecnicos *tecnicos) {
+    static const char *nomesPrioridade[ALTA + 1] = { [BAIXA] = "Baixa", [MEDIA] = "Media", [ALTA] = "Alta" };
+    static const char *nomesTipo[CORRETIVA + 1] = { [PREVENTIVA] = "Preventiva", [CORRETIVA] = "Corretiva" };
+
+    printf("\n===== TEMPOS DE RESOLUÇÃO (p50 / p90 / p99) =====\n");
+
+    const TemposResolucao *resolucao = ordens->resolucao;
+    if (resolucao == NULL) {
+        printf("Erro: os tempos de resolução não estão disponíveis (sem memória).\n");
+        return;
+    }
+    if (resolucao->geral.total == 0) {
+        printf("Não existem ordens concluídas com datas de início e fim.\n");
         return;
     }
 
-    for (int i = 0; i < totalLocais; i++) {
-        printf("Local: %s - %d ordens\n", locais[i], contagens[i]);
+    printf("%-30s %7s %16s %16s %16s\n", "Grupo", "Ordens", "p50", "p90", "p99");
+    mostrarLinhaTempos("Geral", &resolucao->geral);
+
+    printf("\n-- Por prioridade --\n");
+    for (int p = ALTA; p >= BAIXA; p--) {
+        if (resolucao->porPrioridade[p].total > 0) mostrarLinhaTempos(nomesPrioridade[p], &resolucao->porPrioridade[p]);
+    }
+
+    printf("\n-- Por tipo de manutenção --\n");
+    for (int t = PREVENTIVA; t <= CORRETIVA; t++) {
+        if (resolucao->porTipo[t].total > 0) mostrarLinhaTempos(nomesTipo[t], &resolucao->porTipo[t]);
+    }
+
+    char grupo[64];
+    printf("\n-- Por departamento --\n");
+    for (int i = 0; i < departamentos->contador; i++) {
+        const Departamento *d = &departamentos->departamento[i];
+        const HistogramaTempos *histograma = procurarHistogramaDoID(&resolucao->porDepartamento, d->idDepartamento);
+        if (histograma == NULL || histograma->total == 0) continue;
+        snprintf(grupo, sizeof(grupo), "%s (ID %d)", d->nomeDepartamento ? d->nomeDepartamento : "?", d->idDepartamento);
+        mostrarLinhaTempos(grupo, histograma);
+    }
+
+    printf("\n-- Por técnico --\n");
+    for (int i = 0; i < tecnicos->contador; i++) {
+        const Tecnico *t = &tecnicos->tecnico[i];
+        const HistogramaTempos *histograma = procurarHistogramaDoID(&resolucao->porTecnico, t->idTecnico);
+        if (histograma == NULL || histograma->total == 0) continue;
+        snprintf(grupo, sizeof(grupo), "%s (ID %d)", t->nome ? t->nome : "?", t->idTecnico);
+        mostrarLinhaTempos(grupo, histograma);
     }
 }
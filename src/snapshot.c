@@ -0,0 +1,418 @@
+/**
+ * @file snapshot.c
+ * @brief Ficheiro com as funções de leitura/escrita do formato versionado dos ficheiros binários.
+ * @author Francisco Alves
+ */
+
+#define _POSIX_C_SOURCE 200809L /* fileno, fsync */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/snapshot.h"
+#include "../include/logs.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define SNAPSHOT_MMAP
+#endif
+
+#ifdef _WIN32
+#include <io.h>
+#endif
+
+#define ALINHAMENTO_SECCAO 8
+#define SUFIXO_TEMPORARIO ".tmp"
+
+/**
+ * @brief Prepara um cabeçalho vazio com o magic e a versão atuais.
+ * @param cab Apontador para o cabeçalho a inicializar.
+ * @param contador Número de registos.
+ * @param contadorAuxiliar Contador extra da entidade.
+ * @param tamanhoRegisto Tamanho de cada registo fixo.
+ */
+void inicializarCabecalhoSnapshot(CabecalhoSnapshot *cab, int contador, int contadorAuxiliar, size_t tamanhoRegisto) {
+    memset(cab, 0, sizeof(*cab));
+    memcpy(cab->magic, SNAPSHOT_MAGIC, sizeof(cab->magic));
+    cab->versao = SNAPSHOT_VERSAO;
+    cab->contador = contador;
+    cab->contadorAuxiliar = contadorAuxiliar;
+    cab->tamanhoRegisto = (uint32_t)tamanhoRegisto;
+}
+
+/**
+ * @brief Escreve o cabeçalho seguido de todas as secções.
+ * @details Os offsets são calculados a partir do tamanho de cada secção e alinhados a 8 bytes,
+ * para que cada secção possa ser lida (ou mapeada) diretamente como um array.
+ * @param fp Ficheiro aberto em modo de escrita binária.
+ * @param cab Cabeçalho com numSeccoes e o tamanho de cada secção preenchidos.
+ * @param blocos Array com o apontador para os dados de cada secção.
+ * @return 1 em caso de sucesso, 0 caso a escrita falhe.
+ */
+int escreverSnapshot(FILE *fp, CabecalhoSnapshot *cab, const void *const *blocos) {
+    static const char zeros[ALINHAMENTO_SECCAO] = {0};
+    uint64_t offset = sizeof(*cab);
+
+    if (cab->numSeccoes > SNAPSHOT_MAX_SECCOES) return 0;
+
+    for (uint32_t s = 0; s < cab->numSeccoes; s++) {
+        offset = (offset + ALINHAMENTO_SECCAO - 1) & ~(uint64_t)(ALINHAMENTO_SECCAO - 1);
+        cab->seccoes[s].offset = offset;
+        offset += cab->seccoes[s].tamanho;
+    }
+
+    if (fwrite(cab, sizeof(*cab), 1, fp) != 1) return 0;
+
+    uint64_t posicao = sizeof(*cab);
+    for (uint32_t s = 0; s < cab->numSeccoes; s++) {
+        size_t enchimento = (size_t)(cab->seccoes[s].offset - posicao);
+        if (enchimento > 0 && fwrite(zeros, 1, enchimento, fp) != enchimento) return 0;
+        if (cab->seccoes[s].tamanho > 0 &&
+            fwrite(blocos[s], 1, (size_t)cab->seccoes[s].tamanho, fp) != cab->seccoes[s].tamanho) {
+            return 0;
+        }
+        posicao = cab->seccoes[s].offset + cab->seccoes[s].tamanho;
+    }
+    return 1;
+}
+
+/**
+ * @brief Monta o nome do ficheiro temporário ("<ficheiro>.tmp").
+ * @param ficheiro Nome do ficheiro final.
+ * @return String alocada com o nome temporário ou NULL se a alocação falhar.
+ */
+static char *nomeTemporario(const char *ficheiro) {
+    size_t len = strlen(ficheiro);
+    char *nome = malloc(len + sizeof(SUFIXO_TEMPORARIO));
+    if (nome != NULL) {
+        memcpy(nome, ficheiro, len);
+        memcpy(nome + len, SUFIXO_TEMPORARIO, sizeof(SUFIXO_TEMPORARIO));
+    }
+    return nome;
+}
+
+/**
+ * @brief Garante que o conteúdo de um ficheiro chegou ao disco (fflush seguido de fsync).
+ * @details Sem isto, depois de uma falha de energia ou do sistema operativo o ficheiro pode ficar
+ * vazio ou incompleto mesmo que todas as escritas tenham corrido bem.
+ * @param fp Ficheiro aberto em modo de escrita.
+ * @return 1 se os dados ficaram no disco, caso contrário 0.
+ */
+int sincronizarFicheiro(FILE *fp) {
+    if (fflush(fp) != 0) return 0;
+#ifdef _WIN32
+    return _commit(_fileno(fp)) == 0;
+#elif defined(SNAPSHOT_MMAP)
+    return fsync(fileno(fp)) == 0;
+#else
+    return 1;
+#endif
+}
+
+/**
+ * @brief Garante que as entradas da pasta de um ficheiro (criação, rename) chegaram ao disco.
+ * @details Só é necessário em sistemas POSIX; no Windows não é possível abrir uma pasta desta forma.
+ * @param ficheiro Nome do ficheiro cuja pasta vai ser sincronizada.
+ * @return 1 se a pasta foi sincronizada (ou não for necessário), caso contrário 0.
+ */
+int sincronizarDiretorio(const char *ficheiro) {
+#ifdef SNAPSHOT_MMAP
+    const char *barra = strrchr(ficheiro, '/');
+    char *pasta;
+    if (barra == NULL) {
+        pasta = malloc(2);
+        if (pasta != NULL) memcpy(pasta, ".", 2);
+    } else {
+        size_t len = barra == ficheiro ? 1 : (size_t)(barra - ficheiro);
+        pasta = malloc(len + 1);
+        if (pasta != NULL) {
+            memcpy(pasta, ficheiro, len);
+            pasta[len] = '\0';
+        }
+    }
+    if (pasta == NULL) return 0;
+
+    int fd = open(pasta, O_RDONLY);
+    free(pasta);
+    if (fd == -1) return 0;
+    int ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+#else
+    (void)ficheiro;
+    return 1;
+#endif
+}
+
+/**
+ * @brief Abre um ficheiro temporário onde o snapshot será escrito.
+ * @param ficheiro Nome do ficheiro final (ex: "ativos.bin").
+ * @return Ficheiro aberto em modo de escrita binária ou NULL em caso de erro.
+ */
+FILE *abrirSnapshotEscrita(const char *ficheiro) {
+    char *nome = nomeTemporario(ficheiro);
+    if (nome == NULL) return NULL;
+
+    FILE *fp = fopen(nome, "wb");
+    free(nome);
+    return fp;
+}
+
+/**
+ * @brief Fecha o ficheiro temporário e substitui o ficheiro final caso a escrita tenha corrido bem.
+ * @details A substituição é feita com rename(), por isso um mapeamento do ficheiro antigo
+ * continua a apontar para os dados antigos até ser desfeito. O ficheiro temporário é sincronizado
+ * antes do rename() e a pasta depois dele, para que após uma falha de energia o ficheiro final seja
+ * o antigo ou o novo completo (nunca um ficheiro vazio ou parcial).
+ * @param fp Ficheiro devolvido por abrirSnapshotEscrita().
+ * @param ficheiro Nome do ficheiro final.
+ * @param sucesso 1 se a escrita foi bem sucedida, 0 para descartar o ficheiro temporário.
+ * @return 1 se o ficheiro final foi substituído, 0 caso contrário.
+ */
+int fecharSnapshotEscrita(FILE *fp, const char *ficheiro, int sucesso) {
+    char *nome = nomeTemporario(ficheiro);
+
+    if (sucesso && !sincronizarFicheiro(fp)) {
+        registar_log("Erro: Não foi possível sincronizar o snapshot com o disco.");
+        sucesso = 0;
+    }
+    if (fclose(fp) != 0) sucesso = 0;
+    if (nome == NULL) return 0;
+
+    if (!sucesso) {
+        remove(nome);
+        free(nome);
+        return 0;
+    }
+
+#ifdef _WIN32
+    remove(ficheiro);
+#endif
+    int ok = rename(nome, ficheiro) == 0;
+    if (!ok) {
+        registar_log("Erro: Não foi possível substituir o snapshot pelo ficheiro temporário.");
+        remove(nome);
+    } else if (!sincronizarDiretorio(ficheiro)) {
+        registar_log("Erro: Não foi possível sincronizar a pasta do snapshot com o disco.");
+        ok = 0;
+    }
+    free(nome);
+    return ok;
+}
+
+/**
+ * @brief Lê e valida o cabeçalho de um snapshot.
+ * @details Os ficheiros antigos começam diretamente pelo contador de registos, pelo que
+ * se o magic não coincidir o ficheiro é reposicionado no início e tratado como antigo.
+ * @param fp Ficheiro aberto em modo de leitura binária.
+ * @param cab Apontador onde o cabeçalho será guardado.
+ * @return 1 se o ficheiro estiver no formato versionado, 0 se for um ficheiro antigo.
+ */
+int lerCabecalhoSnapshot(FILE *fp, CabecalhoSnapshot *cab) {
+    if (fread(cab, sizeof(*cab), 1, fp) == 1 &&
+        memcmp(cab->magic, SNAPSHOT_MAGIC, sizeof(cab->magic)) == 0) {
+        if (cab->numSeccoes > SNAPSHOT_MAX_SECCOES || cab->contador < 0) {
+            registar_log("Erro: Cabeçalho de snapshot inválido (número de secções ou contador corrompido).");
+            cab->numSeccoes = 0;
+            cab->contador = 0;
+        } else if (cab->versao > SNAPSHOT_VERSAO) {
+            registar_log("Erro: Snapshot gravado por uma versão mais recente do programa.");
+            cab->numSeccoes = 0;
+            cab->contador = 0;
+        }
+        return 1;
+    }
+    rewind(fp);
+    return 0;
+}
+
+/**
+ * @brief Lê uma secção completa com uma única leitura.
+ * @param fp Ficheiro aberto em modo de leitura binária.
+ * @param cab Cabeçalho já validado.
+ * @param seccao Índice da secção.
+ * @param destino Buffer com pelo menos cab->seccoes[seccao].tamanho bytes.
+ * @return 1 em caso de sucesso, 0 caso contrário.
+ */
+int lerSeccaoSnapshot(FILE *fp, const CabecalhoSnapshot *cab, int seccao, void *destino) {
+    if (seccao < 0 || (uint32_t)seccao >= cab->numSeccoes) return 0;
+
+    size_t tamanho = (size_t)cab->seccoes[seccao].tamanho;
+    if (tamanho == 0) return 1;
+
+    if (fseek(fp, (long)cab->seccoes[seccao].offset, SEEK_SET) != 0) return 0;
+    return fread(destino, 1, tamanho, fp) == tamanho;
+}
+
+/**
+ * @brief Mapeia um snapshot em memória e valida o cabeçalho e a tabela de secções.
+ * @details O ficheiro é mapeado com MAP_PRIVATE: as páginas são lidas diretamente do ficheiro e
+ * só são copiadas (pelo sistema operativo) quando algum registo é alterado.
+ * @param ficheiro Nome do ficheiro.
+ * @param mapa Apontador onde o mapeamento será guardado.
+ * @param cab Apontador onde o cabeçalho será copiado.
+ * @return 1 se o ficheiro foi mapeado, 0 caso deva ser usada a leitura normal.
+ */
+int mapearSnapshot(const char *ficheiro, MapaSnapshot *mapa, CabecalhoSnapshot *cab) {
+    mapa->base = NULL;
+    mapa->tamanho = 0;
+
+#ifdef SNAPSHOT_MMAP
+    int fd = open(ficheiro, O_RDONLY);
+    if (fd < 0) return 0;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(*cab)) {
+        close(fd);
+        return 0;
+    }
+
+    size_t tamanho = (size_t)st.st_size;
+    void *base = mmap(NULL, tamanho, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return 0;
+
+    memcpy(cab, base, sizeof(*cab));
+    if (memcmp(cab->magic, SNAPSHOT_MAGIC, sizeof(cab->magic)) != 0 || cab->versao > SNAPSHOT_VERSAO ||
+        cab->numSeccoes > SNAPSHOT_MAX_SECCOES || cab->contador < 0) {
+        munmap(base, tamanho);
+        return 0;
+    }
+
+    for (uint32_t s = 0; s < cab->numSeccoes; s++) {
+        if (cab->seccoes[s].offset > tamanho || cab->seccoes[s].tamanho > tamanho - cab->seccoes[s].offset) {
+            munmap(base, tamanho);
+            return 0;
+        }
+    }
+
+    mapa->base = base;
+    mapa->tamanho = tamanho;
+    return 1;
+#else
+    (void)ficheiro;
+    (void)cab;
+    return 0;
+#endif
+}
+
+/**
+ * @brief Devolve o início de uma secção de um snapshot mapeado.
+ * @param mapa Mapeamento válido.
+ * @param cab Cabeçalho do snapshot.
+ * @param seccao Índice da secção.
+ * @return Apontador para os dados da secção ou NULL se a secção não existir.
+ */
+void *seccaoMapeada(const MapaSnapshot *mapa, const CabecalhoSnapshot *cab, int seccao) {
+    if (mapa->base == NULL || seccao < 0 || (uint32_t)seccao >= cab->numSeccoes) return NULL;
+    return (char *)mapa->base + cab->seccoes[seccao].offset;
+}
+
+/**
+ * @brief Desfaz o mapeamento de um snapshot.
+ * @param mapa Apontador para o mapeamento.
+ */
+void desmapearSnapshot(MapaSnapshot *mapa) {
+#ifdef SNAPSHOT_MMAP
+    if (mapa->base != NULL) {
+        munmap(mapa->base, mapa->tamanho);
+    }
+#endif
+    mapa->base = NULL;
+    mapa->tamanho = 0;
+}
+
+/**
+ * @brief Faz com que cada string de um pool seja escrita no heap uma única vez (strings iguais partilham o offset).
+ * @details Guarda o offset de cada ID do pool, pelo que adicionarStringHeap() só copia a primeira ocorrência
+ * de cada string (ex: a mesma localização em muitos ativos).
+ * @param heap Apontador para o heap (ainda vazio).
+ * @param pool Pool de onde vêm todas as strings que vão ser acrescentadas.
+ */
+void deduplicarHeapStrings(HeapStrings *heap, const PoolStrings *pool) {
+    int numIDs = numStringsPool(pool);
+    heap->offsetsPool = malloc(((size_t)numIDs + 1) * sizeof(uint32_t));
+    if (heap->offsetsPool == NULL) {
+        registar_log("Aviso: Sem memória para deduplicar o heap de strings; as strings repetidas são escritas várias vezes.");
+        heap->numOffsetsPool = 0;
+        return;
+    }
+    for (int id = 0; id < numIDs; id++) {
+        heap->offsetsPool[id] = SNAPSHOT_STRING_NULA;
+    }
+    heap->pool = pool;
+    heap->numOffsetsPool = numIDs;
+}
+
+/**
+ * @brief Acrescenta uma string ao heap de strings, expandindo-o quando necessário.
+ * @details Se o heap for deduplicado (deduplicarHeapStrings()), uma string já escrita devolve o offset anterior.
+ * O ID de cada string é procurado no dicionário do pool (idStringPool()); strings que não estejam no pool são
+ * sempre copiadas.
+ * @param heap Apontador para o heap.
+ * @param str String a acrescentar (pode ser NULL).
+ * @return Offset da string no heap, SNAPSHOT_STRING_NULA se str for NULL ou se a alocação falhar.
+ */
+uint32_t adicionarStringHeap(HeapStrings *heap, const char *str) {
+    if (str == NULL) return SNAPSHOT_STRING_NULA;
+
+    int id = heap->offsetsPool != NULL ? idStringPool(heap->pool, str) : -1;
+    if (id >= 0 && id < heap->numOffsetsPool && heap->offsetsPool[id] != SNAPSHOT_STRING_NULA) {
+        return heap->offsetsPool[id];
+    }
+
+    size_t len = strlen(str) + 1;
+    if (heap->tamanho + len > heap->capacidade) {
+        size_t novaCap = heap->capacidade > 0 ? heap->capacidade : 256;
+        while (novaCap < heap->tamanho + len) novaCap *= 2;
+
+        char *tmp = realloc(heap->dados, novaCap);
+        if (tmp == NULL) {
+            registar_log("Erro: Falha no realloc ao expandir o heap de strings do snapshot.");
+            return SNAPSHOT_STRING_NULA;
+        }
+        heap->dados = tmp;
+        heap->capacidade = novaCap;
+    }
+
+    uint32_t offset = (uint32_t)heap->tamanho;
+    memcpy(heap->dados + heap->tamanho, str, len);
+    heap->tamanho += len;
+    if (id >= 0 && id < heap->numOffsetsPool) {
+        heap->offsetsPool[id] = offset;
+    }
+    return offset;
+}
+
+/**
+ * @brief Devolve uma string guardada no heap sem a copiar.
+ * @param heap Início do heap de strings.
+ * @param tamanho Tamanho do heap em bytes.
+ * @param offset Offset da string.
+ * @return Apontador para a string dentro do heap ou NULL se o offset for nulo/inválido.
+ */
+const char *stringHeap(const char *heap, size_t tamanho, uint32_t offset) {
+    if (offset == SNAPSHOT_STRING_NULA || offset >= tamanho) return NULL;
+
+    const char *inicio = heap + offset;
+    if (memchr(inicio, '\0', tamanho - offset) == NULL) return NULL;
+    return inicio;
+}
+
+/**
+ * @brief Liberta a memória do heap de strings.
+ * @param heap Apontador para o heap.
+ */
+void libertarHeapStrings(HeapStrings *heap) {
+    free(heap->dados);
+    free(heap->offsetsPool);
+    heap->dados = NULL;
+    heap->tamanho = 0;
+    heap->capacidade = 0;
+    heap->pool = NULL;
+    heap->offsetsPool = NULL;
+    heap->numOffsetsPool = 0;
+}
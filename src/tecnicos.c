@@ -7,49 +7,37 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include "../include/tecnicos.h"
 #include "../include/input.h"
 #include "../include/logs.h"
+#include "../include/snapshot.h"
+#include "../include/journal.h"
 
 #include "../include/ordem.h"
 #define CRESCIMENTO_5 5
 
 /**
- * @brief Função que procura o maior ID registado nos técnicos.
+ * @brief Função que devolve o maior ID já atribuído a um técnico.
  * @param tecnicos Estrutura com o array de técnicos e contador.
- * @return Retorna o maior ID registado. Caso não existam técnicos devolve 0.
+ * @return Retorna o último ID atribuído (lido do contador proximoID), ou 0 se ainda não foi atribuído nenhum.
  */
 int obterMaiorIDTecnicos(Tecnicos tecnicos) {
-    int maxID = 0;
-    for (int i = 0; i < tecnicos.contador; i++) {
-        if (tecnicos.tecnico[i].idTecnico > maxID) {
-            maxID = tecnicos.tecnico[i].idTecnico;
-        }
-    }
-    return maxID;
+    return tecnicos.proximoID > 0 ? tecnicos.proximoID - 1 : 0;
 }
 
 /**
- * @brief Função que gera o próximo ID a ser atribuido a um novo técnico.
- * @details Percorre todos os técnicos existentes e devolve o maior ID + 1.
- * Caso não existam técnicos, devolve 10.
- * @param tecnicos Apontador para a estrutura Tecnicos.
- * @return Retorna o próximo ID disponível.
+ * @brief Gera um ID único e sequencial para um novo técnico.
+ * @details Usa o contador proximoID, que é guardado no snapshot e no journal, pelo que a atribuição é O(1)
+ * e um ID nunca é reutilizado, mesmo depois de o programa ser reiniciado.
+ * @param tecnicos Apontador para a estrutura de técnicos.
+ * @return Retorna o ID atribuído (o primeiro é PRIMEIRO_ID).
  */
 static int gerarProximoID(Tecnicos *tecnicos) {
-
-    if (tecnicos->contador == 0) {
-        return 10;
-    }
-
-    int maxID = 0;
-    for (int i = 0; i < tecnicos->contador; i++) {
-        if (tecnicos->tecnico[i].idTecnico > maxID) {
-            maxID = tecnicos->tecnico[i].idTecnico;
-        }
+    if (tecnicos->proximoID < PRIMEIRO_ID) {
+        tecnicos->proximoID = PRIMEIRO_ID;
     }
-
-    return maxID + 1;
+    return tecnicos->proximoID++;
 }
 
 
@@ -130,12 +118,22 @@ const char *passar_int_string_estado (EstadoTecnico estado_tecnico) {
  * @return Retorna o índice do técnico no array caso seja encontrado, caso contrário retorna -1.
  */
 int procurar_tecnico_id (Tecnicos tecnicos, int idProcurado) {
-    for (int i = 0; i<tecnicos.contador; i++) {
-        if (tecnicos.tecnico[i].idTecnico == idProcurado) {
-            return i;
+    return procurarIndice(&tecnicos.indice, idProcurado);
+}
+
+/**
+ * @brief Função que reconstrói o índice de IDs a partir do array de técnicos.
+ * @details Garante também que proximoID é maior do que todos os IDs carregados (ficheiros antigos não o guardam).
+ * @param tecnicos Apontador para a estrutura de técnicos.
+ */
+static void indexarTecnicos(Tecnicos *tecnicos) {
+    if (!limparIndice(&tecnicos->indice, tecnicos->contador)) return;
+    for (int i = 0; i < tecnicos->contador; i++) {
+        inserirIndice(&tecnicos->indice, tecnicos->tecnico[i].idTecnico, i);
+        if (tecnicos->tecnico[i].idTecnico >= tecnicos->proximoID) {
+            tecnicos->proximoID = tecnicos->tecnico[i].idTecnico + 1;
         }
     }
-    return -1;
 }
 
 /**
@@ -153,14 +151,19 @@ void criar_tecnico (Tecnicos *tecnicos) {
 
     int idx = tecnicos->contador;
 
-    tecnicos->tecnico[idx].nome = lerStringDinamica("Indique o nome do técnico:\n");
+    tecnicos->tecnico[idx].nome = lerStringPool(&tecnicos->strings, "Indique o nome do técnico:\n");
     tecnicos->tecnico[idx].especialidade = obterIntIntervalado(1, 5,
         "Indique a especialidade do técnico:\n1 - Técnico TI\n2 - Mecânico\n3 - Eletricista\n4 - Manutenção Geral\n5 - Outras\n");
     tecnicos->tecnico[idx].estado_tecnico = ATIVO1;
+    tecnicos->tecnico[idx].idManutencaoAssociado = 0;
+    tecnicos->tecnico[idx].ordensEmExecucao = 0;
+    tecnicos->tecnico[idx].ordensConcluidas = 0;
     tecnicos->tecnico[idx].idTecnico = gerarProximoID(tecnicos);
+    inserirIndice(&tecnicos->indice, tecnicos->tecnico[idx].idTecnico, idx);
 
     tecnicos->contador++;
     tecnicos->tecnicosAtivos++;
+    journalTecnico(tecnicos, idx);
 
     registar_log("Info: Foi criado um novo técnico.");
     pausar_ecra();
@@ -183,26 +186,30 @@ void listar_tecnicos (Tecnicos tecnicos) {
 
 /**
  * @brief Função que desativa (inativa) um técnico.
- * @param tecnicos Estrutura com o array de técnicos e contador.
+ * @param tecnicos Apontador para a estrutura de técnicos.
  * @note A função pede um ID, valida e depois altera o estado para INATIVO1 caso o utilizador confirme.
  * @warning O técnico não é removido do array; apenas é marcado como INATIVO1.
  */
-void desativar_tecnico (Tecnicos tecnicos) {
+void desativar_tecnico (Tecnicos *tecnicos) {
     int idProcurado, idEncontrado;
     int escolha;
     int maxIdTecnicos;
-    maxIdTecnicos = obterMaiorIDTecnicos(tecnicos);
+    maxIdTecnicos = obterMaiorIDTecnicos(*tecnicos);
     printf("\n===== DESATIVAR TECNICO =====\n");
     idProcurado = obterIntIntervalado(0, maxIdTecnicos, "Indique o id que deseja procurar: \n");
-    if (tecnicos.tecnico[idProcurado].estado_tecnico == INATIVO1 || tecnicos.tecnico[idProcurado].estado_tecnico == OCUPADO) {
+    idEncontrado = procurar_tecnico_id(*tecnicos, idProcurado);
+    if (idEncontrado == -1 || tecnicos->tecnico[idEncontrado].estado_tecnico == INATIVO1 || tecnicos->tecnico[idEncontrado].estado_tecnico == OCUPADO) {
         printf("ID inválido.\n");
         pausar_ecra();
         return;
     }
-    idEncontrado = procurar_tecnico_id(tecnicos, idProcurado);
     escolha = obterIntIntervalado(1, 2,"Tem a certeza que deseja apagar o técnico de id %d? (1) Sim (2) Não\n");
     if (escolha == 1) {
-        tecnicos.tecnico[idEncontrado].estado_tecnico = INATIVO1;
+        tecnicos->tecnico[idEncontrado].estado_tecnico = INATIVO1;
+        if (tecnicos->tecnicosAtivos > 0) {
+            tecnicos->tecnicosAtivos--;
+        }
+        journalTecnico(tecnicos, idEncontrado);
         printf ("O técnico foi apagado com sucesso.\n");
         registar_log("Info: Um técnico foi desativado.");
         pausar_ecra();
@@ -213,43 +220,83 @@ void desativar_tecnico (Tecnicos tecnicos) {
     }
 }
 
+/**
+ * @brief Registo de tamanho fixo de um técnico tal como é guardado no snapshot.
+ * @note O nome é guardado no heap de strings (secção 1) e aqui fica apenas o seu offset.
+ */
+typedef struct {
+    int32_t idTecnico;
+    int32_t idManutencaoAssociado;
+    int32_t especialidade;
+    int32_t estado_tecnico;
+    uint32_t nome;
+} TecnicoDisco;
+
 /**
  * @brief Função que guarda os técnicos num ficheiro binário.
+ * @details O ficheiro tem um CabecalhoSnapshot (com o contador de técnicos ativos e o próximo ID a
+ * atribuir), o array de registos TecnicoDisco e o heap com os nomes.
  * @param tecnicos Apontador para a estrutura de técnicos.
+ * @return 1 se o ficheiro foi gravado com sucesso, caso contrário 0.
  * @warning Escreve no ficheiro "tecnicos.bin". Caso o ficheiro não possa ser aberto, a função termina.
  */
-void guardarTecnicos(Tecnicos *tecnicos) {
-    FILE *fp = fopen("tecnicos.bin", "wb");
+int guardarTecnicos(Tecnicos *tecnicos) {
+    TecnicoDisco *registos = NULL;
+    HeapStrings heap = {0};
+
+    if (tecnicos->contador > 0) {
+        registos = malloc((size_t)tecnicos->contador * sizeof(TecnicoDisco));
+        if (registos == NULL) {
+            printf("Erro: sem memória para guardar técnicos.\n");
+            registar_log("Erro: Falha ao alocar memória para serializar técnicos.");
+            return 0;
+        }
+    }
 
+    deduplicarHeapStrings(&heap, &tecnicos->strings);
+    for (int i = 0; i < tecnicos->contador; i++) {
+        registos[i].idTecnico = tecnicos->tecnico[i].idTecnico;
+        registos[i].idManutencaoAssociado = tecnicos->tecnico[i].idManutencaoAssociado;
+        registos[i].especialidade = tecnicos->tecnico[i].especialidade;
+        registos[i].estado_tecnico = tecnicos->tecnico[i].estado_tecnico;
+        registos[i].nome = adicionarStringHeap(&heap, tecnicos->tecnico[i].nome);
+    }
+
+    FILE *fp = abrirSnapshotEscrita("tecnicos.bin");
     if (fp == NULL) {
         printf("Erro ao abrir ficheiro de técnicos para escrita.");
         registar_log("Erro: Não foi possivel abrir tecnicos.bin para escrita.");
-        return;
+        free(registos);
+        libertarHeapStrings(&heap);
+        return 0;
     }
 
-    fwrite (&tecnicos->contador, sizeof(int), 1, fp);
-    fwrite (&tecnicos->tecnicosAtivos, sizeof(int), 1, fp);
+    CabecalhoSnapshot cab;
+    inicializarCabecalhoSnapshot(&cab, tecnicos->contador, tecnicos->tecnicosAtivos, sizeof(TecnicoDisco));
+    cab.proximoID = tecnicos->proximoID;
+    cab.numSeccoes = 2;
+    cab.seccoes[0].tamanho = (uint64_t)tecnicos->contador * sizeof(TecnicoDisco);
+    cab.seccoes[1].tamanho = heap.tamanho;
+    const void *blocos[] = { registos, heap.dados };
 
-    for (int i = 0; tecnicos->contador; i++) {
-        fwrite (&tecnicos->tecnico[i].idTecnico, sizeof(int), 1, fp);
-        fwrite (&tecnicos->tecnico[i].idManutencaoAssociado, sizeof(int), 1, fp);
-        fwrite (&tecnicos->tecnico[i].especialidade, sizeof(Especialidade), 1, fp);
-        fwrite (&tecnicos->tecnico[i].estado_tecnico, sizeof(EstadoTecnico), 1, fp);
-        escreverStringBinario(tecnicos->tecnico[i].nome, fp);
+    int sucesso = escreverSnapshot(fp, &cab, blocos);
+    if (!fecharSnapshotEscrita(fp, "tecnicos.bin", sucesso)) {
+        printf("Erro ao gravar o ficheiro de técnicos.");
+        registar_log("Erro: Falha ao escrever tecnicos.bin.");
+        sucesso = 0;
     }
-    fclose (fp);
+
+    free(registos);
+    libertarHeapStrings(&heap);
+    return sucesso;
 }
 
 /**
- * @brief Função que carrega os técnicos a partir de um ficheiro binário.
+ * @brief Função que carrega os técnicos a partir do formato antigo (sem cabeçalho, um fread por campo).
  * @param tecnicos Apontador para a estrutura de técnicos.
- * @note Caso o ficheiro "tecnicos.bin" não exista, a função termina sem alterar nada.
- * @warning A função utiliza malloc para alocar memória para o array de técnicos.
+ * @param fp Ficheiro aberto e posicionado no início.
  */
-void carregarTecnicos(Tecnicos *tecnicos) {
-    FILE *fp = fopen("tecnicos.bin", "rb");
-    if (fp == NULL) return;
-
+static void carregarTecnicosLegado(Tecnicos *tecnicos, FILE *fp) {
     fread (&tecnicos->contador, sizeof(int), 1, fp);
     fread (&tecnicos->tecnicosAtivos, sizeof(int), 1, fp);
 
@@ -257,7 +304,8 @@ void carregarTecnicos(Tecnicos *tecnicos) {
     tecnicos->tecnico = malloc(tecnicos->capacidade * sizeof(Tecnico));
     if (tecnicos->tecnico == NULL && tecnicos->contador > 0) {
         registar_log("Erro: Falha ao alocar memória ao carregar técnicos (malloc devolveu NULL).");
-        fclose(fp);
+        tecnicos->contador = 0;
+        tecnicos->capacidade = 0;
         return;
     }
 
@@ -266,7 +314,101 @@ void carregarTecnicos(Tecnicos *tecnicos) {
         fread (&tecnicos->tecnico[i].idManutencaoAssociado, sizeof(int), 1, fp);
         fread (&tecnicos->tecnico[i].especialidade, sizeof(Especialidade), 1, fp);
         fread (&tecnicos->tecnico[i].estado_tecnico, sizeof(EstadoTecnico), 1, fp);
-        tecnicos->tecnico[i].nome = lerStringBinario(fp);
+        tecnicos->tecnico[i].nome = lerStringBinario(fp, &tecnicos->strings);
+    }
+}
+
+/**
+ * @brief Função que carrega os técnicos a partir de um snapshot (registos e heap lidos com uma leitura cada).
+ * @param tecnicos Apontador para a estrutura de técnicos.
+ * @param fp Ficheiro posicionado depois do cabeçalho.
+ * @param cab Cabeçalho já lido.
+ */
+static void carregarTecnicosSnapshot(Tecnicos *tecnicos, FILE *fp, const CabecalhoSnapshot *cab) {
+    if (cab->numSeccoes < 2 || cab->tamanhoRegisto != sizeof(TecnicoDisco) ||
+        cab->seccoes[0].tamanho != (uint64_t)cab->contador * sizeof(TecnicoDisco)) {
+        registar_log("Erro: tecnicos.bin tem um formato/versão não suportado.");
+        return;
+    }
+
+    TecnicoDisco *registos = malloc((size_t)cab->seccoes[0].tamanho + 1);
+    char *heap = malloc((size_t)cab->seccoes[1].tamanho + 1);
+    tecnicos->tecnico = malloc(((size_t)cab->contador + 1) * sizeof(Tecnico));
+
+    if (registos == NULL || heap == NULL || tecnicos->tecnico == NULL ||
+        !lerSeccaoSnapshot(fp, cab, 0, registos) || !lerSeccaoSnapshot(fp, cab, 1, heap)) {
+        registar_log("Erro: Não foi possível ler tecnicos.bin (memória insuficiente ou ficheiro corrompido).");
+        free(registos);
+        free(heap);
+        free(tecnicos->tecnico);
+        tecnicos->tecnico = NULL;
+        return;
+    }
+
+    size_t tamanhoHeap = (size_t)cab->seccoes[1].tamanho;
+    for (int i = 0; i < cab->contador; i++) {
+        tecnicos->tecnico[i].idTecnico = registos[i].idTecnico;
+        tecnicos->tecnico[i].idManutencaoAssociado = registos[i].idManutencaoAssociado;
+        tecnicos->tecnico[i].especialidade = registos[i].especialidade;
+        tecnicos->tecnico[i].estado_tecnico = registos[i].estado_tecnico;
+        tecnicos->tecnico[i].nome = internarStringPool(&tecnicos->strings, stringHeap(heap, tamanhoHeap, registos[i].nome));
+    }
+
+    tecnicos->contador = cab->contador;
+    tecnicos->tecnicosAtivos = cab->contadorAuxiliar;
+    tecnicos->capacidade = cab->contador;
+    if (cab->proximoID > tecnicos->proximoID) {
+        tecnicos->proximoID = cab->proximoID;
+    }
+
+    free(registos);
+    free(heap);
+}
+
+/**
+ * @brief Função que carrega os técnicos a partir de um ficheiro binário.
+ * @details Ficheiros com cabeçalho são lidos como snapshot e ficheiros sem cabeçalho pelo leitor
+ * do formato antigo. No fim é reconstruído o índice de IDs.
+ * @param tecnicos Apontador para a estrutura de técnicos.
+ * @note Caso o ficheiro "tecnicos.bin" não exista, a função termina sem alterar nada.
+ * @warning A função utiliza malloc para alocar memória para o array de técnicos.
+ */
+void carregarTecnicos(Tecnicos *tecnicos) {
+    FILE *fp = fopen("tecnicos.bin", "rb");
+    if (fp == NULL) return;
+
+    CabecalhoSnapshot cab;
+    if (lerCabecalhoSnapshot(fp, &cab)) {
+        carregarTecnicosSnapshot(tecnicos, fp, &cab);
+    } else {
+        carregarTecnicosLegado(tecnicos, fp);
     }
     fclose(fp);
-}
\ No newline at end of file
+    indexarTecnicos(tecnicos);
+}
+
+/**
+ * @brief Repõe um técnico registado no journal (cria-o ou substitui o existente com o mesmo ID).
+ * @param tecnicos Apontador para a estrutura de técnicos.
+ * @param tecnico Técnico lido do journal (o nome é copiado para tecnicos->strings).
+ * @param tecnicosAtivos Contador de técnicos ativos no momento do registo.
+ * @param proximoID Próximo ID a atribuir no momento do registo.
+ */
+void reporTecnico(Tecnicos *tecnicos, const Tecnico *tecnico, int tecnicosAtivos, int proximoID) {
+    int idx = procurar_tecnico_id(*tecnicos, tecnico->idTecnico);
+
+    if (idx == -1) {
+        if (!garantir_capacidade_tecnicos(tecnicos, tecnicos->contador + 1)) return;
+        idx = tecnicos->contador++;
+        inserirIndice(&tecnicos->indice, tecnico->idTecnico, idx);
+    }
+    tecnicos->tecnico[idx] = *tecnico;
+    tecnicos->tecnico[idx].nome = internarStringPool(&tecnicos->strings, tecnico->nome);
+    tecnicos->tecnicosAtivos = tecnicosAtivos;
+    if (proximoID > tecnicos->proximoID) {
+        tecnicos->proximoID = proximoID;
+    }
+    if (tecnico->idTecnico >= tecnicos->proximoID) {
+        tecnicos->proximoID = tecnico->idTecnico + 1;
+    }
+}